@@ -3,6 +3,9 @@
 
 #include <stdint.h> // uint64_t
 #include <stdio.h> // printf
+#include <stdlib.h> // exit
+#include <stdarg.h> // va_list
+#include <time.h> // clock_gettime
 
 #if defined(_WIN32)
 #include <Windows.h>
@@ -1,9 +1,29 @@
 #include "JsonStthm.h"
 
 #include <stdio.h> // FILE, fopen, fclose, fwrite, fread
-
-// Experimental long/double parser
-//#define STTHM_USE_CUSTOM_NUMERIC_PARSER
+#include <new> // placement new
+
+#if defined(STTHM_USE_AVX2)
+#include <immintrin.h>
+#elif defined(STTHM_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h> // _BitScanForward
+#endif
+
+#if defined(STTHM_USE_THREADS)
+#include <thread>
+#include <mutex>
+#endif
+
+#if defined(STTHM_USE_MMAP)
+#include <sys/mman.h> // mmap, munmap, madvise
+#include <sys/stat.h> // fstat
+#include <fcntl.h> // open
+#include <unistd.h> // close
+#endif
 
 namespace JsonStthm
 {
@@ -61,292 +81,1169 @@ namespace JsonStthm
 			return c_pXDigitLut[cChar];
 		}
 
-		void SkipSpaces(const char*& pString, const char* pEnd)
+		inline int CountTrailingZeros(uint32_t iMask)
 		{
-			while (pString < pEnd && IsSpace(*pString)) ++pString;
+			JsonStthmAssert(iMask != 0);
+#if defined(_MSC_VER)
+			unsigned long iIndex;
+			_BitScanForward(&iIndex, iMask);
+			return (int)iIndex;
+#else
+			return __builtin_ctz(iMask);
+#endif
 		}
 
-		int64_t StrToInt64(const char* pString, const char* pEnd, char** pCursor)
+		inline int CountTrailingZeros64(uint64_t iMask)
 		{
-			bool bNeg = false;
-			if (pString < pEnd && *pString == '-')
-			{
-				++pString;
-				bNeg = true;
-			}
-
-			int64_t lValue = 0;
-			while (pString < pEnd && IsDigit(*pString))
-				lValue = lValue * 10 + (*pString++ & 0xF);
+			JsonStthmAssert(iMask != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+			unsigned long iIndex;
+			_BitScanForward64(&iIndex, iMask);
+			return (int)iIndex;
+#elif defined(_MSC_VER)
+			if ((uint32_t)iMask != 0)
+				return CountTrailingZeros((uint32_t)iMask);
+			return 32 + CountTrailingZeros((uint32_t)(iMask >> 32));
+#else
+			return __builtin_ctzll(iMask);
+#endif
+		}
 
-			if (pCursor != NULL)
-				*pCursor = (char*)pString;
+#if defined(STTHM_USE_AVX2) || defined(STTHM_USE_SSE2)
+		// Classify 16 chars at a time, each function return a bit mask of matching chars
 
-			return bNeg ? -lValue : lValue;
+		inline uint32_t SpaceMask16(__m128i vChars)
+		{
+			// ' ' or '\t' <= cChar <= '\r'
+			const __m128i vControl = _mm_sub_epi8(vChars, _mm_set1_epi8('\t'));
+			const __m128i vIsControl = _mm_cmpeq_epi8(_mm_min_epu8(vControl, _mm_set1_epi8('\r' - '\t')), vControl);
+			const __m128i vIsSpace = _mm_cmpeq_epi8(vChars, _mm_set1_epi8(' '));
+			return (uint32_t)_mm_movemask_epi8(_mm_or_si128(vIsSpace, vIsControl));
 		}
-	}
 
-	//////////////////////////////
-	// JsonValue::Iterator
-	//////////////////////////////
+		inline uint32_t StringSpecialMask16(__m128i vChars)
+		{
+			// '"' or '\\' or '\0'
+			const __m128i vIsQuote = _mm_cmpeq_epi8(vChars, _mm_set1_epi8('"'));
+			const __m128i vIsBackslash = _mm_cmpeq_epi8(vChars, _mm_set1_epi8('\\'));
+			const __m128i vIsZero = _mm_cmpeq_epi8(vChars, _mm_setzero_si128());
+			return (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(vIsQuote, vIsBackslash), vIsZero));
+		}
 
-	JsonValue::Iterator::Iterator(const JsonValue* pJson)
-	{
-		if (pJson != NULL && pJson->IsContainer())
+		inline uint32_t EscapeMask16(__m128i vChars)
 		{
-			m_pChild = pJson->m_oValue.Childs.m_pFirst;
+			// '"' or '\\' or cChar < 0x20 or cChar >= 0x80 (negative when signed)
+			const __m128i vIsQuote = _mm_cmpeq_epi8(vChars, _mm_set1_epi8('"'));
+			const __m128i vIsBackslash = _mm_cmpeq_epi8(vChars, _mm_set1_epi8('\\'));
+			const __m128i vIsControl = _mm_cmplt_epi8(vChars, _mm_set1_epi8(0x20));
+			return (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(vIsQuote, vIsBackslash), vIsControl));
 		}
-		else
+
+		inline uint32_t DigitMask16(__m128i vChars)
 		{
-			m_pChild = NULL;
+			// '0' <= cChar <= '9'
+			const __m128i vDigit = _mm_sub_epi8(vChars, _mm_set1_epi8('0'));
+			return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(vDigit, _mm_set1_epi8(9)), vDigit));
 		}
-	}
+#endif //STTHM_USE_AVX2 || STTHM_USE_SSE2
 
-	JsonValue::Iterator::Iterator(const Iterator& oIt)
-	{
-		m_pChild = oIt.m_pChild;
-	}
+#if defined(STTHM_USE_AVX2)
+		// Same as above but for 32 chars
 
-	bool JsonValue::Iterator::IsValid() const
-	{
-		return m_pChild != NULL;
-	}
+		inline uint32_t SpaceMask32(__m256i vChars)
+		{
+			const __m256i vControl = _mm256_sub_epi8(vChars, _mm256_set1_epi8('\t'));
+			const __m256i vIsControl = _mm256_cmpeq_epi8(_mm256_min_epu8(vControl, _mm256_set1_epi8('\r' - '\t')), vControl);
+			const __m256i vIsSpace = _mm256_cmpeq_epi8(vChars, _mm256_set1_epi8(' '));
+			return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(vIsSpace, vIsControl));
+		}
 
-	bool JsonValue::Iterator::operator!=(const Iterator& oIte) const
-	{
-		return m_pChild != oIte.m_pChild;
-	}
+		inline uint32_t StringSpecialMask32(__m256i vChars)
+		{
+			const __m256i vIsQuote = _mm256_cmpeq_epi8(vChars, _mm256_set1_epi8('"'));
+			const __m256i vIsBackslash = _mm256_cmpeq_epi8(vChars, _mm256_set1_epi8('\\'));
+			const __m256i vIsZero = _mm256_cmpeq_epi8(vChars, _mm256_setzero_si256());
+			return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(vIsQuote, vIsBackslash), vIsZero));
+		}
 
-	void JsonValue::Iterator::operator++()
-	{
-		if (m_pChild != NULL)
-			m_pChild = m_pChild->m_pNext;
-	}
+		inline uint32_t EscapeMask32(__m256i vChars)
+		{
+			const __m256i vIsQuote = _mm256_cmpeq_epi8(vChars, _mm256_set1_epi8('"'));
+			const __m256i vIsBackslash = _mm256_cmpeq_epi8(vChars, _mm256_set1_epi8('\\'));
+			const __m256i vIsControl = _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), vChars);
+			return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(vIsQuote, vIsBackslash), vIsControl));
+		}
 
-	const JsonValue& JsonValue::Iterator::operator*() const
-	{
-		return m_pChild != NULL ? *m_pChild : INVALID;
-	}
+		inline uint32_t DigitMask32(__m256i vChars)
+		{
+			const __m256i vDigit = _mm256_sub_epi8(vChars, _mm256_set1_epi8('0'));
+			return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(vDigit, _mm256_set1_epi8(9)), vDigit));
+		}
+#endif //STTHM_USE_AVX2
 
-	const JsonValue* JsonValue::Iterator::operator->() const
-	{
-		return m_pChild;
-	}
+		void SkipSpaces(const char*& pString, const char* pEnd)
+		{
+			// Most of the time there is no space at all, don't bother loading a vector
+			if (pString >= pEnd || IsSpace(*pString) == false)
+				return;
+			++pString;
 
-	JsonValue::Iterator::operator const JsonValue&() const
-	{
-		return m_pChild != NULL ? *m_pChild : INVALID;
-	}
+#if defined(STTHM_USE_AVX2)
+			while ((pEnd - pString) >= 32)
+			{
+				uint32_t iMask = ~SpaceMask32(_mm256_loadu_si256((const __m256i*)pString));
+				if (iMask != 0)
+				{
+					pString += CountTrailingZeros(iMask);
+					return;
+				}
+				pString += 32;
+			}
+#endif //STTHM_USE_AVX2
+#if defined(STTHM_USE_SSE2)
+			while ((pEnd - pString) >= 16)
+			{
+				uint32_t iMask = ~SpaceMask16(_mm_loadu_si128((const __m128i*)pString)) & 0xFFFF;
+				if (iMask != 0)
+				{
+					pString += CountTrailingZeros(iMask);
+					return;
+				}
+				pString += 16;
+			}
+#endif //STTHM_USE_SSE2
 
-	//////////////////////////////
-	// JsonValue
-	//////////////////////////////
+			while (pString < pEnd && IsSpace(*pString)) ++pString;
+		}
 
-	JsonValue JsonValue::INVALID;
+		// Return first '"', '\\' or '\0' found, or pEnd
+		const char* FindStringSpecial(const char* pString, const char* pEnd)
+		{
+#if defined(STTHM_USE_AVX2)
+			while ((pEnd - pString) >= 32)
+			{
+				uint32_t iMask = StringSpecialMask32(_mm256_loadu_si256((const __m256i*)pString));
+				if (iMask != 0)
+					return pString + CountTrailingZeros(iMask);
+				pString += 32;
+			}
+#endif //STTHM_USE_AVX2
+#if defined(STTHM_USE_SSE2)
+			while ((pEnd - pString) >= 16)
+			{
+				uint32_t iMask = StringSpecialMask16(_mm_loadu_si128((const __m128i*)pString));
+				if (iMask != 0)
+					return pString + CountTrailingZeros(iMask);
+				pString += 16;
+			}
+#endif //STTHM_USE_SSE2
 
-	Allocator JsonValue::s_oDefaultAllocator = {
-		JsonValue::DefaultAllocatorCreateJsonValue,
-		JsonValue::DefaultAllocatorDeleteJsonValue,
-		JsonValue::DefaultAllocatorAllocString,
-		JsonValue::DefaultAllocatorFreeString,
-		NULL
-	};
+			while (pString < pEnd && *pString != '"' && *pString != '\\' && *pString != 0)
+				++pString;
+			return pString;
+		}
 
-	JsonValue::JsonValue(Allocator* pAllocator)
-		: m_pAllocator(pAllocator)
-		, m_eType(E_TYPE_NULL)
-		, m_pName(NULL)
-		, m_pNext(NULL)
-	{
-		JsonStthmAssert(m_pAllocator != NULL);
-	}
+		// Return first non digit char found, or pEnd
+		const char* SkipDigits(const char* pString, const char* pEnd)
+		{
+			// Short numbers are the most common, check a few chars before loading a vector
+			for (int i = 0; i < 4; ++i)
+			{
+				if (pString >= pEnd || IsDigit(*pString) == false)
+					return pString;
+				++pString;
+			}
 
-	JsonValue::JsonValue()
-		: m_pAllocator(&s_oDefaultAllocator)
-		, m_eType(E_TYPE_NULL)
-		, m_pName(NULL)
-		, m_pNext(NULL)
-	{
-	}
+#if defined(STTHM_USE_AVX2)
+			while ((pEnd - pString) >= 32)
+			{
+				uint32_t iMask = ~DigitMask32(_mm256_loadu_si256((const __m256i*)pString));
+				if (iMask != 0)
+					return pString + CountTrailingZeros(iMask);
+				pString += 32;
+			}
+#endif //STTHM_USE_AVX2
+#if defined(STTHM_USE_SSE2)
+			while ((pEnd - pString) >= 16)
+			{
+				uint32_t iMask = ~DigitMask16(_mm_loadu_si128((const __m128i*)pString)) & 0xFFFF;
+				if (iMask != 0)
+					return pString + CountTrailingZeros(iMask);
+				pString += 16;
+			}
+#endif //STTHM_USE_SSE2
 
-	JsonValue::JsonValue(const JsonValue& oSource)
-		: m_pAllocator(&s_oDefaultAllocator)
-		, m_eType(E_TYPE_NULL)
-		, m_pName(NULL)
-		, m_pNext(NULL)
-	{
-		*this = oSource;
-	}
+			while (pString < pEnd && IsDigit(*pString))
+				++pString;
+			return pString;
+		}
 
-	JsonValue::JsonValue(bool bValue)
-		: m_pAllocator(&s_oDefaultAllocator)
-		, m_eType(E_TYPE_NULL)
-		, m_pName(NULL)
-		, m_pNext(NULL)
-	{
-		*this = bValue;
-	}
+#if defined(STTHM_USE_AVX2) || defined(STTHM_USE_SSE2)
+		inline uint32_t BracketMask16(__m128i vChars)
+		{
+			// '{', '}', '[', ']', '"' or '\0'
+			const __m128i vLower = _mm_or_si128(vChars, _mm_set1_epi8(0x20));
+			const __m128i vIsBrace = _mm_or_si128(_mm_cmpeq_epi8(vLower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(vLower, _mm_set1_epi8('}')));
+			const __m128i vIsQuoteOrZero = _mm_or_si128(_mm_cmpeq_epi8(vChars, _mm_set1_epi8('"')), _mm_cmpeq_epi8(vChars, _mm_setzero_si128()));
+			return (uint32_t)_mm_movemask_epi8(_mm_or_si128(vIsBrace, vIsQuoteOrZero));
+		}
+#endif //STTHM_USE_AVX2 || STTHM_USE_SSE2
 
-#ifdef JsonStthmString
-	JsonValue::JsonValue(const JsonStthmString& sValue)
-		: m_pAllocator(&s_oDefaultAllocator)
-		, m_eType(E_TYPE_NULL)
-		, m_pName(NULL)
-		, m_pNext(NULL)
-	{
-		*this = sValue;
-	}
-#endif //JsonStthmString
+#if defined(STTHM_USE_AVX2)
+		inline uint32_t BracketMask32(__m256i vChars)
+		{
+			const __m256i vLower = _mm256_or_si256(vChars, _mm256_set1_epi8(0x20));
+			const __m256i vIsBrace = _mm256_or_si256(_mm256_cmpeq_epi8(vLower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(vLower, _mm256_set1_epi8('}')));
+			const __m256i vIsQuoteOrZero = _mm256_or_si256(_mm256_cmpeq_epi8(vChars, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(vChars, _mm256_setzero_si256()));
+			return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(vIsBrace, vIsQuoteOrZero));
+		}
+#endif //STTHM_USE_AVX2
 
-	JsonValue::JsonValue(const char* pValue)
-		: m_pAllocator(&s_oDefaultAllocator)
-		, m_eType(E_TYPE_NULL)
-		, m_pName(NULL)
-		, m_pNext(NULL)
-	{
-		*this = pValue;
-	}
+		inline bool NeedEscape(char cChar)
+		{
+			return (unsigned char)cChar < 0x20 || (unsigned char)cChar >= 0x80 || cChar == '"' || cChar == '\\';
+		}
 
-	JsonValue::JsonValue(int64_t iValue)
-		: m_pAllocator(&s_oDefaultAllocator)
-		, m_eType(E_TYPE_NULL)
-		, m_pName(NULL)
-		, m_pNext(NULL)
-	{
-		*this = iValue;
-	}
+		// Return first char to escape when writing a string ('"', '\\', control and non ASCII chars), or pEnd
+		const char* FindEscape(const char* pString, const char* pEnd)
+		{
+#if defined(STTHM_USE_AVX2)
+			while ((pEnd - pString) >= 32)
+			{
+				uint32_t iMask = EscapeMask32(_mm256_loadu_si256((const __m256i*)pString));
+				if (iMask != 0)
+					return pString + CountTrailingZeros(iMask);
+				pString += 32;
+			}
+#endif //STTHM_USE_AVX2
+#if defined(STTHM_USE_SSE2)
+			while ((pEnd - pString) >= 16)
+			{
+				uint32_t iMask = EscapeMask16(_mm_loadu_si128((const __m128i*)pString));
+				if (iMask != 0)
+					return pString + CountTrailingZeros(iMask);
+				pString += 16;
+			}
+#endif //STTHM_USE_SSE2
 
-	JsonValue::JsonValue(double fValue)
-		: m_pAllocator(&s_oDefaultAllocator)
-		, m_eType(E_TYPE_NULL)
-		, m_pName(NULL)
-		, m_pNext(NULL)
-	{
-		*this = fValue;
-	}
+			while (pString < pEnd && NeedEscape(*pString) == false)
+				++pString;
+			return pString;
+		}
 
-	JsonValue::~JsonValue()
-	{
-		if (m_pName != NULL)
+		char* WriteUnicodeEscape(char* pOut, uint32_t iChar)
 		{
-			m_pAllocator->FreeString(m_pName, m_pAllocator->pUserData);
-			m_pName = NULL;
+			const char* const pHexa = "0123456789abcdef";
+			pOut[0] = '\\';
+			pOut[1] = 'u';
+			pOut[2] = pHexa[(iChar >> 12) & 0x0f];
+			pOut[3] = pHexa[(iChar >> 8) & 0x0f];
+			pOut[4] = pHexa[(iChar >> 4) & 0x0f];
+			pOut[5] = pHexa[(iChar >> 0) & 0x0f];
+			return pOut + 6;
 		}
-		Reset();
-	}
-
-	void JsonValue::InitType(EType eType)
-	{
-		if (m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY || m_eType == E_TYPE_STRING)
-			Reset();
 
-		if (m_eType != eType)
+		// Return first '{', '}', '[', ']', '"' or '\0' found, or pEnd
+		const char* FindBracket(const char* pString, const char* pEnd)
 		{
-			m_eType = eType;
-			switch (eType)
+#if defined(STTHM_USE_AVX2)
+			while ((pEnd - pString) >= 32)
 			{
-			case E_TYPE_OBJECT:
-			case E_TYPE_ARRAY:
-				m_oValue.Childs.m_pFirst = NULL;
-				m_oValue.Childs.m_pLast = NULL;
-				break;
-			case E_TYPE_STRING:
-				m_oValue.String = NULL;
-				break;
-			default:
-				break;
+				uint32_t iMask = BracketMask32(_mm256_loadu_si256((const __m256i*)pString));
+				if (iMask != 0)
+					return pString + CountTrailingZeros(iMask);
+				pString += 32;
+			}
+#endif //STTHM_USE_AVX2
+#if defined(STTHM_USE_SSE2)
+			while ((pEnd - pString) >= 16)
+			{
+				uint32_t iMask = BracketMask16(_mm_loadu_si128((const __m128i*)pString));
+				if (iMask != 0)
+					return pString + CountTrailingZeros(iMask);
+				pString += 16;
+			}
+#endif //STTHM_USE_SSE2
+
+			while (pString < pEnd)
+			{
+				const char cChar = *pString;
+				if (cChar == '{' || cChar == '}' || cChar == '[' || cChar == ']' || cChar == '"' || cChar == 0)
+					break;
+				++pString;
 			}
+			return pString;
 		}
-	}
 
-	void JsonValue::Reset()
-	{
-		switch (m_eType)
-		{
-		case E_TYPE_OBJECT:
-		case E_TYPE_ARRAY:
+		// Move pString after the closing quote of current string, pString should be after the opening quote
+		bool SkipString(const char*& pString, const char* pEnd)
 		{
-			JsonValue* pChild = m_oValue.Childs.m_pFirst;
-			while (pChild != NULL)
+			while (true)
 			{
-				JsonValue* pTemp = pChild->m_pNext;
-				m_pAllocator->DeleteJsonValue(pChild, m_pAllocator->pUserData);
-				pChild = pTemp;
+				pString = FindStringSpecial(pString, pEnd);
+				if (pString >= pEnd || *pString == 0)
+					return false;
+				if (*pString++ == '"')
+					return true;
+				++pString; // Escaped char
 			}
-			m_oValue.Childs.m_pFirst = NULL;
-			m_oValue.Childs.m_pLast = NULL;
-			break;
 		}
-		case E_TYPE_STRING:
+
+		// Move pString after the closing brace of current container, pString should be after the opening brace
+		// Only strings and braces are checked, each closing brace should match its opening one
+		bool SkipContainer(const char*& pString, const char* pEnd, char cClose)
 		{
-			m_pAllocator->FreeString(m_oValue.String, m_pAllocator->pUserData);
-			m_oValue.String = NULL;
-			break;
-		}
-		default:
-			break;
+			// Expected closing braces of nested containers
+			Buffer<char, 256> oCloses;
+			while (true)
+			{
+				pString = FindBracket(pString, pEnd);
+				if (pString >= pEnd || *pString == 0)
+					return false;
+
+				const char cChar = *pString++;
+				if (cChar == '"')
+				{
+					if (SkipString(pString, pEnd) == false)
+						return false;
+				}
+				else if (cChar == '{' || cChar == '[')
+				{
+					oCloses.Push(cClose);
+					cClose = (cChar == '{') ? '}' : ']';
+				}
+				else if (cChar != cClose)
+				{
+					--pString;
+					return false;
+				}
+				else if (oCloses.Size() == 0)
+				{
+					return true;
+				}
+				else
+				{
+					cClose = oCloses.Data()[oCloses.Size() - 1];
+					oCloses.Resize(oCloses.Size() - 1);
+				}
+			}
 		}
-		m_eType = E_TYPE_NULL;
-	}
 
-	JsonValue::EType JsonValue::GetType() const
-	{
-		return m_eType;
-	}
+		//////////////////////////////
+		// Number parsing
 
-	void JsonValue::SetStringValue(const char* pString, const char* pEnd)
-	{
-		JsonStthmAssert(IsString());
-		m_pAllocator->FreeString(m_oValue.String, m_pAllocator->pUserData);
-		m_oValue.String = NULL;
-		if (NULL != pString)
+		static const double c_pExactPow10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+			1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+			1e21, 1e22
+		};
+
+		// Powers of ten normalized on 128 bits rounded down { high, low }
+		static const int c_iPow10Mantissa128Min = -342;
+		static const int c_iPow10Mantissa128Max = 308;
+		static const uint64_t c_pPow10Mantissa128[][2] = {
+			{ 0xEEF453D6923BD65A, 0x113FAA2906A13B3F }, // 1e-342
+			{ 0x9558B4661B6565F8, 0x4AC7CA59A424C507 }, // 1e-341
+			{ 0xBAAEE17FA23EBF76, 0x5D79BCF00D2DF649 }, // 1e-340
+			{ 0xE95A99DF8ACE6F53, 0xF4D82C2C107973DC }, // 1e-339
+			{ 0x91D8A02BB6C10594, 0x79071B9B8A4BE869 }, // 1e-338
+			{ 0xB64EC836A47146F9, 0x9748E2826CDEE284 }, // 1e-337
+			{ 0xE3E27A444D8D98B7, 0xFD1B1B2308169B25 }, // 1e-336
+			{ 0x8E6D8C6AB0787F72, 0xFE30F0F5E50E20F7 }, // 1e-335
+			{ 0xB208EF855C969F4F, 0xBDBD2D335E51A935 }, // 1e-334
+			{ 0xDE8B2B66B3BC4723, 0xAD2C788035E61382 }, // 1e-333
+			{ 0x8B16FB203055AC76, 0x4C3BCB5021AFCC31 }, // 1e-332
+			{ 0xADDCB9E83C6B1793, 0xDF4ABE242A1BBF3D }, // 1e-331
+			{ 0xD953E8624B85DD78, 0xD71D6DAD34A2AF0D }, // 1e-330
+			{ 0x87D4713D6F33AA6B, 0x8672648C40E5AD68 }, // 1e-329
+			{ 0xA9C98D8CCB009506, 0x680EFDAF511F18C2 }, // 1e-328
+			{ 0xD43BF0EFFDC0BA48, 0x0212BD1B2566DEF2 }, // 1e-327
+			{ 0x84A57695FE98746D, 0x014BB630F7604B57 }, // 1e-326
+			{ 0xA5CED43B7E3E9188, 0x419EA3BD35385E2D }, // 1e-325
+			{ 0xCF42894A5DCE35EA, 0x52064CAC828675B9 }, // 1e-324
+			{ 0x818995CE7AA0E1B2, 0x7343EFEBD1940993 }, // 1e-323
+			{ 0xA1EBFB4219491A1F, 0x1014EBE6C5F90BF8 }, // 1e-322
+			{ 0xCA66FA129F9B60A6, 0xD41A26E077774EF6 }, // 1e-321
+			{ 0xFD00B897478238D0, 0x8920B098955522B4 }, // 1e-320
+			{ 0x9E20735E8CB16382, 0x55B46E5F5D5535B0 }, // 1e-319
+			{ 0xC5A890362FDDBC62, 0xEB2189F734AA831D }, // 1e-318
+			{ 0xF712B443BBD52B7B, 0xA5E9EC7501D523E4 }, // 1e-317
+			{ 0x9A6BB0AA55653B2D, 0x47B233C92125366E }, // 1e-316
+			{ 0xC1069CD4EABE89F8, 0x999EC0BB696E840A }, // 1e-315
+			{ 0xF148440A256E2C76, 0xC00670EA43CA250D }, // 1e-314
+			{ 0x96CD2A865764DBCA, 0x380406926A5E5728 }, // 1e-313
+			{ 0xBC807527ED3E12BC, 0xC605083704F5ECF2 }, // 1e-312
+			{ 0xEBA09271E88D976B, 0xF7864A44C633682E }, // 1e-311
+			{ 0x93445B8731587EA3, 0x7AB3EE6AFBE0211D }, // 1e-310
+			{ 0xB8157268FDAE9E4C, 0x5960EA05BAD82964 }, // 1e-309
+			{ 0xE61ACF033D1A45DF, 0x6FB92487298E33BD }, // 1e-308
+			{ 0x8FD0C16206306BAB, 0xA5D3B6D479F8E056 }, // 1e-307
+			{ 0xB3C4F1BA87BC8696, 0x8F48A4899877186C }, // 1e-306
+			{ 0xE0B62E2929ABA83C, 0x331ACDABFE94DE87 }, // 1e-305
+			{ 0x8C71DCD9BA0B4925, 0x9FF0C08B7F1D0B14 }, // 1e-304
+			{ 0xAF8E5410288E1B6F, 0x07ECF0AE5EE44DD9 }, // 1e-303
+			{ 0xDB71E91432B1A24A, 0xC9E82CD9F69D6150 }, // 1e-302
+			{ 0x892731AC9FAF056E, 0xBE311C083A225CD2 }, // 1e-301
+			{ 0xAB70FE17C79AC6CA, 0x6DBD630A48AAF406 }, // 1e-300
+			{ 0xD64D3D9DB981787D, 0x092CBBCCDAD5B108 }, // 1e-299
+			{ 0x85F0468293F0EB4E, 0x25BBF56008C58EA5 }, // 1e-298
+			{ 0xA76C582338ED2621, 0xAF2AF2B80AF6F24E }, // 1e-297
+			{ 0xD1476E2C07286FAA, 0x1AF5AF660DB4AEE1 }, // 1e-296
+			{ 0x82CCA4DB847945CA, 0x50D98D9FC890ED4D }, // 1e-295
+			{ 0xA37FCE126597973C, 0xE50FF107BAB528A0 }, // 1e-294
+			{ 0xCC5FC196FEFD7D0C, 0x1E53ED49A96272C8 }, // 1e-293
+			{ 0xFF77B1FCBEBCDC4F, 0x25E8E89C13BB0F7A }, // 1e-292
+			{ 0x9FAACF3DF73609B1, 0x77B191618C54E9AC }, // 1e-291
+			{ 0xC795830D75038C1D, 0xD59DF5B9EF6A2417 }, // 1e-290
+			{ 0xF97AE3D0D2446F25, 0x4B0573286B44AD1D }, // 1e-289
+			{ 0x9BECCE62836AC577, 0x4EE367F9430AEC32 }, // 1e-288
+			{ 0xC2E801FB244576D5, 0x229C41F793CDA73F }, // 1e-287
+			{ 0xF3A20279ED56D48A, 0x6B43527578C1110F }, // 1e-286
+			{ 0x9845418C345644D6, 0x830A13896B78AAA9 }, // 1e-285
+			{ 0xBE5691EF416BD60C, 0x23CC986BC656D553 }, // 1e-284
+			{ 0xEDEC366B11C6CB8F, 0x2CBFBE86B7EC8AA8 }, // 1e-283
+			{ 0x94B3A202EB1C3F39, 0x7BF7D71432F3D6A9 }, // 1e-282
+			{ 0xB9E08A83A5E34F07, 0xDAF5CCD93FB0CC53 }, // 1e-281
+			{ 0xE858AD248F5C22C9, 0xD1B3400F8F9CFF68 }, // 1e-280
+			{ 0x91376C36D99995BE, 0x23100809B9C21FA1 }, // 1e-279
+			{ 0xB58547448FFFFB2D, 0xABD40A0C2832A78A }, // 1e-278
+			{ 0xE2E69915B3FFF9F9, 0x16C90C8F323F516C }, // 1e-277
+			{ 0x8DD01FAD907FFC3B, 0xAE3DA7D97F6792E3 }, // 1e-276
+			{ 0xB1442798F49FFB4A, 0x99CD11CFDF41779C }, // 1e-275
+			{ 0xDD95317F31C7FA1D, 0x40405643D711D583 }, // 1e-274
+			{ 0x8A7D3EEF7F1CFC52, 0x482835EA666B2572 }, // 1e-273
+			{ 0xAD1C8EAB5EE43B66, 0xDA3243650005EECF }, // 1e-272
+			{ 0xD863B256369D4A40, 0x90BED43E40076A82 }, // 1e-271
+			{ 0x873E4F75E2224E68, 0x5A7744A6E804A291 }, // 1e-270
+			{ 0xA90DE3535AAAE202, 0x711515D0A205CB36 }, // 1e-269
+			{ 0xD3515C2831559A83, 0x0D5A5B44CA873E03 }, // 1e-268
+			{ 0x8412D9991ED58091, 0xE858790AFE9486C2 }, // 1e-267
+			{ 0xA5178FFF668AE0B6, 0x626E974DBE39A872 }, // 1e-266
+			{ 0xCE5D73FF402D98E3, 0xFB0A3D212DC8128F }, // 1e-265
+			{ 0x80FA687F881C7F8E, 0x7CE66634BC9D0B99 }, // 1e-264
+			{ 0xA139029F6A239F72, 0x1C1FFFC1EBC44E80 }, // 1e-263
+			{ 0xC987434744AC874E, 0xA327FFB266B56220 }, // 1e-262
+			{ 0xFBE9141915D7A922, 0x4BF1FF9F0062BAA8 }, // 1e-261
+			{ 0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4A9 }, // 1e-260
+			{ 0xC4CE17B399107C22, 0xCB550FB4384D21D3 }, // 1e-259
+			{ 0xF6019DA07F549B2B, 0x7E2A53A146606A48 }, // 1e-258
+			{ 0x99C102844F94E0FB, 0x2EDA7444CBFC426D }, // 1e-257
+			{ 0xC0314325637A1939, 0xFA911155FEFB5308 }, // 1e-256
+			{ 0xF03D93EEBC589F88, 0x793555AB7EBA27CA }, // 1e-255
+			{ 0x96267C7535B763B5, 0x4BC1558B2F3458DE }, // 1e-254
+			{ 0xBBB01B9283253CA2, 0x9EB1AAEDFB016F16 }, // 1e-253
+			{ 0xEA9C227723EE8BCB, 0x465E15A979C1CADC }, // 1e-252
+			{ 0x92A1958A7675175F, 0x0BFACD89EC191EC9 }, // 1e-251
+			{ 0xB749FAED14125D36, 0xCEF980EC671F667B }, // 1e-250
+			{ 0xE51C79A85916F484, 0x82B7E12780E7401A }, // 1e-249
+			{ 0x8F31CC0937AE58D2, 0xD1B2ECB8B0908810 }, // 1e-248
+			{ 0xB2FE3F0B8599EF07, 0x861FA7E6DCB4AA15 }, // 1e-247
+			{ 0xDFBDCECE67006AC9, 0x67A791E093E1D49A }, // 1e-246
+			{ 0x8BD6A141006042BD, 0xE0C8BB2C5C6D24E0 }, // 1e-245
+			{ 0xAECC49914078536D, 0x58FAE9F773886E18 }, // 1e-244
+			{ 0xDA7F5BF590966848, 0xAF39A475506A899E }, // 1e-243
+			{ 0x888F99797A5E012D, 0x6D8406C952429603 }, // 1e-242
+			{ 0xAAB37FD7D8F58178, 0xC8E5087BA6D33B83 }, // 1e-241
+			{ 0xD5605FCDCF32E1D6, 0xFB1E4A9A90880A64 }, // 1e-240
+			{ 0x855C3BE0A17FCD26, 0x5CF2EEA09A55067F }, // 1e-239
+			{ 0xA6B34AD8C9DFC06F, 0xF42FAA48C0EA481E }, // 1e-238
+			{ 0xD0601D8EFC57B08B, 0xF13B94DAF124DA26 }, // 1e-237
+			{ 0x823C12795DB6CE57, 0x76C53D08D6B70858 }, // 1e-236
+			{ 0xA2CB1717B52481ED, 0x54768C4B0C64CA6E }, // 1e-235
+			{ 0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD09 }, // 1e-234
+			{ 0xFE5D54150B090B02, 0xD3F93B35435D7C4C }, // 1e-233
+			{ 0x9EFA548D26E5A6E1, 0xC47BC5014A1A6DAF }, // 1e-232
+			{ 0xC6B8E9B0709F109A, 0x359AB6419CA1091B }, // 1e-231
+			{ 0xF867241C8CC6D4C0, 0xC30163D203C94B62 }, // 1e-230
+			{ 0x9B407691D7FC44F8, 0x79E0DE63425DCF1D }, // 1e-229
+			{ 0xC21094364DFB5636, 0x985915FC12F542E4 }, // 1e-228
+			{ 0xF294B943E17A2BC4, 0x3E6F5B7B17B2939D }, // 1e-227
+			{ 0x979CF3CA6CEC5B5A, 0xA705992CEECF9C42 }, // 1e-226
+			{ 0xBD8430BD08277231, 0x50C6FF782A838353 }, // 1e-225
+			{ 0xECE53CEC4A314EBD, 0xA4F8BF5635246428 }, // 1e-224
+			{ 0x940F4613AE5ED136, 0x871B7795E136BE99 }, // 1e-223
+			{ 0xB913179899F68584, 0x28E2557B59846E3F }, // 1e-222
+			{ 0xE757DD7EC07426E5, 0x331AEADA2FE589CF }, // 1e-221
+			{ 0x9096EA6F3848984F, 0x3FF0D2C85DEF7621 }, // 1e-220
+			{ 0xB4BCA50B065ABE63, 0x0FED077A756B53A9 }, // 1e-219
+			{ 0xE1EBCE4DC7F16DFB, 0xD3E8495912C62894 }, // 1e-218
+			{ 0x8D3360F09CF6E4BD, 0x64712DD7ABBBD95C }, // 1e-217
+			{ 0xB080392CC4349DEC, 0xBD8D794D96AACFB3 }, // 1e-216
+			{ 0xDCA04777F541C567, 0xECF0D7A0FC5583A0 }, // 1e-215
+			{ 0x89E42CAAF9491B60, 0xF41686C49DB57244 }, // 1e-214
+			{ 0xAC5D37D5B79B6239, 0x311C2875C522CED5 }, // 1e-213
+			{ 0xD77485CB25823AC7, 0x7D633293366B828B }, // 1e-212
+			{ 0x86A8D39EF77164BC, 0xAE5DFF9C02033197 }, // 1e-211
+			{ 0xA8530886B54DBDEB, 0xD9F57F830283FDFC }, // 1e-210
+			{ 0xD267CAA862A12D66, 0xD072DF63C324FD7B }, // 1e-209
+			{ 0x8380DEA93DA4BC60, 0x4247CB9E59F71E6D }, // 1e-208
+			{ 0xA46116538D0DEB78, 0x52D9BE85F074E608 }, // 1e-207
+			{ 0xCD795BE870516656, 0x67902E276C921F8B }, // 1e-206
+			{ 0x806BD9714632DFF6, 0x00BA1CD8A3DB53B6 }, // 1e-205
+			{ 0xA086CFCD97BF97F3, 0x80E8A40ECCD228A4 }, // 1e-204
+			{ 0xC8A883C0FDAF7DF0, 0x6122CD128006B2CD }, // 1e-203
+			{ 0xFAD2A4B13D1B5D6C, 0x796B805720085F81 }, // 1e-202
+			{ 0x9CC3A6EEC6311A63, 0xCBE3303674053BB0 }, // 1e-201
+			{ 0xC3F490AA77BD60FC, 0xBEDBFC4411068A9C }, // 1e-200
+			{ 0xF4F1B4D515ACB93B, 0xEE92FB5515482D44 }, // 1e-199
+			{ 0x991711052D8BF3C5, 0x751BDD152D4D1C4A }, // 1e-198
+			{ 0xBF5CD54678EEF0B6, 0xD262D45A78A0635D }, // 1e-197
+			{ 0xEF340A98172AACE4, 0x86FB897116C87C34 }, // 1e-196
+			{ 0x9580869F0E7AAC0E, 0xD45D35E6AE3D4DA0 }, // 1e-195
+			{ 0xBAE0A846D2195712, 0x8974836059CCA109 }, // 1e-194
+			{ 0xE998D258869FACD7, 0x2BD1A438703FC94B }, // 1e-193
+			{ 0x91FF83775423CC06, 0x7B6306A34627DDCF }, // 1e-192
+			{ 0xB67F6455292CBF08, 0x1A3BC84C17B1D542 }, // 1e-191
+			{ 0xE41F3D6A7377EECA, 0x20CABA5F1D9E4A93 }, // 1e-190
+			{ 0x8E938662882AF53E, 0x547EB47B7282EE9C }, // 1e-189
+			{ 0xB23867FB2A35B28D, 0xE99E619A4F23AA43 }, // 1e-188
+			{ 0xDEC681F9F4C31F31, 0x6405FA00E2EC94D4 }, // 1e-187
+			{ 0x8B3C113C38F9F37E, 0xDE83BC408DD3DD04 }, // 1e-186
+			{ 0xAE0B158B4738705E, 0x9624AB50B148D445 }, // 1e-185
+			{ 0xD98DDAEE19068C76, 0x3BADD624DD9B0957 }, // 1e-184
+			{ 0x87F8A8D4CFA417C9, 0xE54CA5D70A80E5D6 }, // 1e-183
+			{ 0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4C }, // 1e-182
+			{ 0xD47487CC8470652B, 0x7647C3200069671F }, // 1e-181
+			{ 0x84C8D4DFD2C63F3B, 0x29ECD9F40041E073 }, // 1e-180
+			{ 0xA5FB0A17C777CF09, 0xF468107100525890 }, // 1e-179
+			{ 0xCF79CC9DB955C2CC, 0x7182148D4066EEB4 }, // 1e-178
+			{ 0x81AC1FE293D599BF, 0xC6F14CD848405530 }, // 1e-177
+			{ 0xA21727DB38CB002F, 0xB8ADA00E5A506A7C }, // 1e-176
+			{ 0xCA9CF1D206FDC03B, 0xA6D90811F0E4851C }, // 1e-175
+			{ 0xFD442E4688BD304A, 0x908F4A166D1DA663 }, // 1e-174
+			{ 0x9E4A9CEC15763E2E, 0x9A598E4E043287FE }, // 1e-173
+			{ 0xC5DD44271AD3CDBA, 0x40EFF1E1853F29FD }, // 1e-172
+			{ 0xF7549530E188C128, 0xD12BEE59E68EF47C }, // 1e-171
+			{ 0x9A94DD3E8CF578B9, 0x82BB74F8301958CE }, // 1e-170
+			{ 0xC13A148E3032D6E7, 0xE36A52363C1FAF01 }, // 1e-169
+			{ 0xF18899B1BC3F8CA1, 0xDC44E6C3CB279AC1 }, // 1e-168
+			{ 0x96F5600F15A7B7E5, 0x29AB103A5EF8C0B9 }, // 1e-167
+			{ 0xBCB2B812DB11A5DE, 0x7415D448F6B6F0E7 }, // 1e-166
+			{ 0xEBDF661791D60F56, 0x111B495B3464AD21 }, // 1e-165
+			{ 0x936B9FCEBB25C995, 0xCAB10DD900BEEC34 }, // 1e-164
+			{ 0xB84687C269EF3BFB, 0x3D5D514F40EEA742 }, // 1e-163
+			{ 0xE65829B3046B0AFA, 0x0CB4A5A3112A5112 }, // 1e-162
+			{ 0x8FF71A0FE2C2E6DC, 0x47F0E785EABA72AB }, // 1e-161
+			{ 0xB3F4E093DB73A093, 0x59ED216765690F56 }, // 1e-160
+			{ 0xE0F218B8D25088B8, 0x306869C13EC3532C }, // 1e-159
+			{ 0x8C974F7383725573, 0x1E414218C73A13FB }, // 1e-158
+			{ 0xAFBD2350644EEACF, 0xE5D1929EF90898FA }, // 1e-157
+			{ 0xDBAC6C247D62A583, 0xDF45F746B74ABF39 }, // 1e-156
+			{ 0x894BC396CE5DA772, 0x6B8BBA8C328EB783 }, // 1e-155
+			{ 0xAB9EB47C81F5114F, 0x066EA92F3F326564 }, // 1e-154
+			{ 0xD686619BA27255A2, 0xC80A537B0EFEFEBD }, // 1e-153
+			{ 0x8613FD0145877585, 0xBD06742CE95F5F36 }, // 1e-152
+			{ 0xA798FC4196E952E7, 0x2C48113823B73704 }, // 1e-151
+			{ 0xD17F3B51FCA3A7A0, 0xF75A15862CA504C5 }, // 1e-150
+			{ 0x82EF85133DE648C4, 0x9A984D73DBE722FB }, // 1e-149
+			{ 0xA3AB66580D5FDAF5, 0xC13E60D0D2E0EBBA }, // 1e-148
+			{ 0xCC963FEE10B7D1B3, 0x318DF905079926A8 }, // 1e-147
+			{ 0xFFBBCFE994E5C61F, 0xFDF17746497F7052 }, // 1e-146
+			{ 0x9FD561F1FD0F9BD3, 0xFEB6EA8BEDEFA633 }, // 1e-145
+			{ 0xC7CABA6E7C5382C8, 0xFE64A52EE96B8FC0 }, // 1e-144
+			{ 0xF9BD690A1B68637B, 0x3DFDCE7AA3C673B0 }, // 1e-143
+			{ 0x9C1661A651213E2D, 0x06BEA10CA65C084E }, // 1e-142
+			{ 0xC31BFA0FE5698DB8, 0x486E494FCFF30A62 }, // 1e-141
+			{ 0xF3E2F893DEC3F126, 0x5A89DBA3C3EFCCFA }, // 1e-140
+			{ 0x986DDB5C6B3A76B7, 0xF89629465A75E01C }, // 1e-139
+			{ 0xBE89523386091465, 0xF6BBB397F1135823 }, // 1e-138
+			{ 0xEE2BA6C0678B597F, 0x746AA07DED582E2C }, // 1e-137
+			{ 0x94DB483840B717EF, 0xA8C2A44EB4571CDC }, // 1e-136
+			{ 0xBA121A4650E4DDEB, 0x92F34D62616CE413 }, // 1e-135
+			{ 0xE896A0D7E51E1566, 0x77B020BAF9C81D17 }, // 1e-134
+			{ 0x915E2486EF32CD60, 0x0ACE1474DC1D122E }, // 1e-133
+			{ 0xB5B5ADA8AAFF80B8, 0x0D819992132456BA }, // 1e-132
+			{ 0xE3231912D5BF60E6, 0x10E1FFF697ED6C69 }, // 1e-131
+			{ 0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C1 }, // 1e-130
+			{ 0xB1736B96B6FD83B3, 0xBD308FF8A6B17CB2 }, // 1e-129
+			{ 0xDDD0467C64BCE4A0, 0xAC7CB3F6D05DDBDE }, // 1e-128
+			{ 0x8AA22C0DBEF60EE4, 0x6BCDF07A423AA96B }, // 1e-127
+			{ 0xAD4AB7112EB3929D, 0x86C16C98D2C953C6 }, // 1e-126
+			{ 0xD89D64D57A607744, 0xE871C7BF077BA8B7 }, // 1e-125
+			{ 0x87625F056C7C4A8B, 0x11471CD764AD4972 }, // 1e-124
+			{ 0xA93AF6C6C79B5D2D, 0xD598E40D3DD89BCF }, // 1e-123
+			{ 0xD389B47879823479, 0x4AFF1D108D4EC2C3 }, // 1e-122
+			{ 0x843610CB4BF160CB, 0xCEDF722A585139BA }, // 1e-121
+			{ 0xA54394FE1EEDB8FE, 0xC2974EB4EE658828 }, // 1e-120
+			{ 0xCE947A3DA6A9273E, 0x733D226229FEEA32 }, // 1e-119
+			{ 0x811CCC668829B887, 0x0806357D5A3F525F }, // 1e-118
+			{ 0xA163FF802A3426A8, 0xCA07C2DCB0CF26F7 }, // 1e-117
+			{ 0xC9BCFF6034C13052, 0xFC89B393DD02F0B5 }, // 1e-116
+			{ 0xFC2C3F3841F17C67, 0xBBAC2078D443ACE2 }, // 1e-115
+			{ 0x9D9BA7832936EDC0, 0xD54B944B84AA4C0D }, // 1e-114
+			{ 0xC5029163F384A931, 0x0A9E795E65D4DF11 }, // 1e-113
+			{ 0xF64335BCF065D37D, 0x4D4617B5FF4A16D5 }, // 1e-112
+			{ 0x99EA0196163FA42E, 0x504BCED1BF8E4E45 }, // 1e-111
+			{ 0xC06481FB9BCF8D39, 0xE45EC2862F71E1D6 }, // 1e-110
+			{ 0xF07DA27A82C37088, 0x5D767327BB4E5A4C }, // 1e-109
+			{ 0x964E858C91BA2655, 0x3A6A07F8D510F86F }, // 1e-108
+			{ 0xBBE226EFB628AFEA, 0x890489F70A55368B }, // 1e-107
+			{ 0xEADAB0ABA3B2DBE5, 0x2B45AC74CCEA842E }, // 1e-106
+			{ 0x92C8AE6B464FC96F, 0x3B0B8BC90012929D }, // 1e-105
+			{ 0xB77ADA0617E3BBCB, 0x09CE6EBB40173744 }, // 1e-104
+			{ 0xE55990879DDCAABD, 0xCC420A6A101D0515 }, // 1e-103
+			{ 0x8F57FA54C2A9EAB6, 0x9FA946824A12232D }, // 1e-102
+			{ 0xB32DF8E9F3546564, 0x47939822DC96ABF9 }, // 1e-101
+			{ 0xDFF9772470297EBD, 0x59787E2B93BC56F7 }, // 1e-100
+			{ 0x8BFBEA76C619EF36, 0x57EB4EDB3C55B65A }, // 1e-99
+			{ 0xAEFAE51477A06B03, 0xEDE622920B6B23F1 }, // 1e-98
+			{ 0xDAB99E59958885C4, 0xE95FAB368E45ECED }, // 1e-97
+			{ 0x88B402F7FD75539B, 0x11DBCB0218EBB414 }, // 1e-96
+			{ 0xAAE103B5FCD2A881, 0xD652BDC29F26A119 }, // 1e-95
+			{ 0xD59944A37C0752A2, 0x4BE76D3346F0495F }, // 1e-94
+			{ 0x857FCAE62D8493A5, 0x6F70A4400C562DDB }, // 1e-93
+			{ 0xA6DFBD9FB8E5B88E, 0xCB4CCD500F6BB952 }, // 1e-92
+			{ 0xD097AD07A71F26B2, 0x7E2000A41346A7A7 }, // 1e-91
+			{ 0x825ECC24C873782F, 0x8ED400668C0C28C8 }, // 1e-90
+			{ 0xA2F67F2DFA90563B, 0x728900802F0F32FA }, // 1e-89
+			{ 0xCBB41EF979346BCA, 0x4F2B40A03AD2FFB9 }, // 1e-88
+			{ 0xFEA126B7D78186BC, 0xE2F610C84987BFA8 }, // 1e-87
+			{ 0x9F24B832E6B0F436, 0x0DD9CA7D2DF4D7C9 }, // 1e-86
+			{ 0xC6EDE63FA05D3143, 0x91503D1C79720DBB }, // 1e-85
+			{ 0xF8A95FCF88747D94, 0x75A44C6397CE912A }, // 1e-84
+			{ 0x9B69DBE1B548CE7C, 0xC986AFBE3EE11ABA }, // 1e-83
+			{ 0xC24452DA229B021B, 0xFBE85BADCE996168 }, // 1e-82
+			{ 0xF2D56790AB41C2A2, 0xFAE27299423FB9C3 }, // 1e-81
+			{ 0x97C560BA6B0919A5, 0xDCCD879FC967D41A }, // 1e-80
+			{ 0xBDB6B8E905CB600F, 0x5400E987BBC1C920 }, // 1e-79
+			{ 0xED246723473E3813, 0x290123E9AAB23B68 }, // 1e-78
+			{ 0x9436C0760C86E30B, 0xF9A0B6720AAF6521 }, // 1e-77
+			{ 0xB94470938FA89BCE, 0xF808E40E8D5B3E69 }, // 1e-76
+			{ 0xE7958CB87392C2C2, 0xB60B1D1230B20E04 }, // 1e-75
+			{ 0x90BD77F3483BB9B9, 0xB1C6F22B5E6F48C2 }, // 1e-74
+			{ 0xB4ECD5F01A4AA828, 0x1E38AEB6360B1AF3 }, // 1e-73
+			{ 0xE2280B6C20DD5232, 0x25C6DA63C38DE1B0 }, // 1e-72
+			{ 0x8D590723948A535F, 0x579C487E5A38AD0E }, // 1e-71
+			{ 0xB0AF48EC79ACE837, 0x2D835A9DF0C6D851 }, // 1e-70
+			{ 0xDCDB1B2798182244, 0xF8E431456CF88E65 }, // 1e-69
+			{ 0x8A08F0F8BF0F156B, 0x1B8E9ECB641B58FF }, // 1e-68
+			{ 0xAC8B2D36EED2DAC5, 0xE272467E3D222F3F }, // 1e-67
+			{ 0xD7ADF884AA879177, 0x5B0ED81DCC6ABB0F }, // 1e-66
+			{ 0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9 }, // 1e-65
+			{ 0xA87FEA27A539E9A5, 0x3F2398D747B36224 }, // 1e-64
+			{ 0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD }, // 1e-63
+			{ 0x83A3EEEEF9153E89, 0x1953CF68300424AC }, // 1e-62
+			{ 0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7 }, // 1e-61
+			{ 0xCDB02555653131B6, 0x3792F412CB06794D }, // 1e-60
+			{ 0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0 }, // 1e-59
+			{ 0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4 }, // 1e-58
+			{ 0xC8DE047564D20A8B, 0xF245825A5A445275 }, // 1e-57
+			{ 0xFB158592BE068D2E, 0xEED6E2F0F0D56712 }, // 1e-56
+			{ 0x9CED737BB6C4183D, 0x55464DD69685606B }, // 1e-55
+			{ 0xC428D05AA4751E4C, 0xAA97E14C3C26B886 }, // 1e-54
+			{ 0xF53304714D9265DF, 0xD53DD99F4B3066A8 }, // 1e-53
+			{ 0x993FE2C6D07B7FAB, 0xE546A8038EFE4029 }, // 1e-52
+			{ 0xBF8FDB78849A5F96, 0xDE98520472BDD033 }, // 1e-51
+			{ 0xEF73D256A5C0F77C, 0x963E66858F6D4440 }, // 1e-50
+			{ 0x95A8637627989AAD, 0xDDE7001379A44AA8 }, // 1e-49
+			{ 0xBB127C53B17EC159, 0x5560C018580D5D52 }, // 1e-48
+			{ 0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6 }, // 1e-47
+			{ 0x9226712162AB070D, 0xCAB3961304CA70E8 }, // 1e-46
+			{ 0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22 }, // 1e-45
+			{ 0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A }, // 1e-44
+			{ 0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242 }, // 1e-43
+			{ 0xB267ED1940F1C61C, 0x55F038B237591ED3 }, // 1e-42
+			{ 0xDF01E85F912E37A3, 0x6B6C46DEC52F6688 }, // 1e-41
+			{ 0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015 }, // 1e-40
+			{ 0xAE397D8AA96C1B77, 0xABEC975E0A0D081A }, // 1e-39
+			{ 0xD9C7DCED53C72255, 0x96E7BD358C904A21 }, // 1e-38
+			{ 0x881CEA14545C7575, 0x7E50D64177DA2E54 }, // 1e-37
+			{ 0xAA242499697392D2, 0xDDE50BD1D5D0B9E9 }, // 1e-36
+			{ 0xD4AD2DBFC3D07787, 0x955E4EC64B44E864 }, // 1e-35
+			{ 0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E }, // 1e-34
+			{ 0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E }, // 1e-33
+			{ 0xCFB11EAD453994BA, 0x67DE18EDA5814AF2 }, // 1e-32
+			{ 0x81CEB32C4B43FCF4, 0x80EACF948770CED7 }, // 1e-31
+			{ 0xA2425FF75E14FC31, 0xA1258379A94D028D }, // 1e-30
+			{ 0xCAD2F7F5359A3B3E, 0x096EE45813A04330 }, // 1e-29
+			{ 0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC }, // 1e-28
+			{ 0x9E74D1B791E07E48, 0x775EA264CF55347D }, // 1e-27
+			{ 0xC612062576589DDA, 0x95364AFE032A819D }, // 1e-26
+			{ 0xF79687AED3EEC551, 0x3A83DDBD83F52204 }, // 1e-25
+			{ 0x9ABE14CD44753B52, 0xC4926A9672793542 }, // 1e-24
+			{ 0xC16D9A0095928A27, 0x75B7053C0F178293 }, // 1e-23
+			{ 0xF1C90080BAF72CB1, 0x5324C68B12DD6338 }, // 1e-22
+			{ 0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E03 }, // 1e-21
+			{ 0xBCE5086492111AEA, 0x88F4BB1CA6BCF584 }, // 1e-20
+			{ 0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E5 }, // 1e-19
+			{ 0x9392EE8E921D5D07, 0x3AFF322E62439FCF }, // 1e-18
+			{ 0xB877AA3236A4B449, 0x09BEFEB9FAD487C2 }, // 1e-17
+			{ 0xE69594BEC44DE15B, 0x4C2EBE687989A9B3 }, // 1e-16
+			{ 0x901D7CF73AB0ACD9, 0x0F9D37014BF60A10 }, // 1e-15
+			{ 0xB424DC35095CD80F, 0x538484C19EF38C94 }, // 1e-14
+			{ 0xE12E13424BB40E13, 0x2865A5F206B06FB9 }, // 1e-13
+			{ 0x8CBCCC096F5088CB, 0xF93F87B7442E45D3 }, // 1e-12
+			{ 0xAFEBFF0BCB24AAFE, 0xF78F69A51539D748 }, // 1e-11
+			{ 0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1B }, // 1e-10
+			{ 0x89705F4136B4A597, 0x31680A88F8953030 }, // 1e-9
+			{ 0xABCC77118461CEFC, 0xFDC20D2B36BA7C3D }, // 1e-8
+			{ 0xD6BF94D5E57A42BC, 0x3D32907604691B4C }, // 1e-7
+			{ 0x8637BD05AF6C69B5, 0xA63F9A49C2C1B10F }, // 1e-6
+			{ 0xA7C5AC471B478423, 0x0FCF80DC33721D53 }, // 1e-5
+			{ 0xD1B71758E219652B, 0xD3C36113404EA4A8 }, // 1e-4
+			{ 0x83126E978D4FDF3B, 0x645A1CAC083126E9 }, // 1e-3
+			{ 0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A3 }, // 1e-2
+			{ 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCC }, // 1e-1
+			{ 0x8000000000000000, 0x0000000000000000 }, // 1e0
+			{ 0xA000000000000000, 0x0000000000000000 }, // 1e1
+			{ 0xC800000000000000, 0x0000000000000000 }, // 1e2
+			{ 0xFA00000000000000, 0x0000000000000000 }, // 1e3
+			{ 0x9C40000000000000, 0x0000000000000000 }, // 1e4
+			{ 0xC350000000000000, 0x0000000000000000 }, // 1e5
+			{ 0xF424000000000000, 0x0000000000000000 }, // 1e6
+			{ 0x9896800000000000, 0x0000000000000000 }, // 1e7
+			{ 0xBEBC200000000000, 0x0000000000000000 }, // 1e8
+			{ 0xEE6B280000000000, 0x0000000000000000 }, // 1e9
+			{ 0x9502F90000000000, 0x0000000000000000 }, // 1e10
+			{ 0xBA43B74000000000, 0x0000000000000000 }, // 1e11
+			{ 0xE8D4A51000000000, 0x0000000000000000 }, // 1e12
+			{ 0x9184E72A00000000, 0x0000000000000000 }, // 1e13
+			{ 0xB5E620F480000000, 0x0000000000000000 }, // 1e14
+			{ 0xE35FA931A0000000, 0x0000000000000000 }, // 1e15
+			{ 0x8E1BC9BF04000000, 0x0000000000000000 }, // 1e16
+			{ 0xB1A2BC2EC5000000, 0x0000000000000000 }, // 1e17
+			{ 0xDE0B6B3A76400000, 0x0000000000000000 }, // 1e18
+			{ 0x8AC7230489E80000, 0x0000000000000000 }, // 1e19
+			{ 0xAD78EBC5AC620000, 0x0000000000000000 }, // 1e20
+			{ 0xD8D726B7177A8000, 0x0000000000000000 }, // 1e21
+			{ 0x878678326EAC9000, 0x0000000000000000 }, // 1e22
+			{ 0xA968163F0A57B400, 0x0000000000000000 }, // 1e23
+			{ 0xD3C21BCECCEDA100, 0x0000000000000000 }, // 1e24
+			{ 0x84595161401484A0, 0x0000000000000000 }, // 1e25
+			{ 0xA56FA5B99019A5C8, 0x0000000000000000 }, // 1e26
+			{ 0xCECB8F27F4200F3A, 0x0000000000000000 }, // 1e27
+			{ 0x813F3978F8940984, 0x4000000000000000 }, // 1e28
+			{ 0xA18F07D736B90BE5, 0x5000000000000000 }, // 1e29
+			{ 0xC9F2C9CD04674EDE, 0xA400000000000000 }, // 1e30
+			{ 0xFC6F7C4045812296, 0x4D00000000000000 }, // 1e31
+			{ 0x9DC5ADA82B70B59D, 0xF020000000000000 }, // 1e32
+			{ 0xC5371912364CE305, 0x6C28000000000000 }, // 1e33
+			{ 0xF684DF56C3E01BC6, 0xC732000000000000 }, // 1e34
+			{ 0x9A130B963A6C115C, 0x3C7F400000000000 }, // 1e35
+			{ 0xC097CE7BC90715B3, 0x4B9F100000000000 }, // 1e36
+			{ 0xF0BDC21ABB48DB20, 0x1E86D40000000000 }, // 1e37
+			{ 0x96769950B50D88F4, 0x1314448000000000 }, // 1e38
+			{ 0xBC143FA4E250EB31, 0x17D955A000000000 }, // 1e39
+			{ 0xEB194F8E1AE525FD, 0x5DCFAB0800000000 }, // 1e40
+			{ 0x92EFD1B8D0CF37BE, 0x5AA1CAE500000000 }, // 1e41
+			{ 0xB7ABC627050305AD, 0xF14A3D9E40000000 }, // 1e42
+			{ 0xE596B7B0C643C719, 0x6D9CCD05D0000000 }, // 1e43
+			{ 0x8F7E32CE7BEA5C6F, 0xE4820023A2000000 }, // 1e44
+			{ 0xB35DBF821AE4F38B, 0xDDA2802C8A800000 }, // 1e45
+			{ 0xE0352F62A19E306E, 0xD50B2037AD200000 }, // 1e46
+			{ 0x8C213D9DA502DE45, 0x4526F422CC340000 }, // 1e47
+			{ 0xAF298D050E4395D6, 0x9670B12B7F410000 }, // 1e48
+			{ 0xDAF3F04651D47B4C, 0x3C0CDD765F114000 }, // 1e49
+			{ 0x88D8762BF324CD0F, 0xA5880A69FB6AC800 }, // 1e50
+			{ 0xAB0E93B6EFEE0053, 0x8EEA0D047A457A00 }, // 1e51
+			{ 0xD5D238A4ABE98068, 0x72A4904598D6D880 }, // 1e52
+			{ 0x85A36366EB71F041, 0x47A6DA2B7F864750 }, // 1e53
+			{ 0xA70C3C40A64E6C51, 0x999090B65F67D924 }, // 1e54
+			{ 0xD0CF4B50CFE20765, 0xFFF4B4E3F741CF6D }, // 1e55
+			{ 0x82818F1281ED449F, 0xBFF8F10E7A8921A4 }, // 1e56
+			{ 0xA321F2D7226895C7, 0xAFF72D52192B6A0D }, // 1e57
+			{ 0xCBEA6F8CEB02BB39, 0x9BF4F8A69F764490 }, // 1e58
+			{ 0xFEE50B7025C36A08, 0x02F236D04753D5B4 }, // 1e59
+			{ 0x9F4F2726179A2245, 0x01D762422C946590 }, // 1e60
+			{ 0xC722F0EF9D80AAD6, 0x424D3AD2B7B97EF5 }, // 1e61
+			{ 0xF8EBAD2B84E0D58B, 0xD2E0898765A7DEB2 }, // 1e62
+			{ 0x9B934C3B330C8577, 0x63CC55F49F88EB2F }, // 1e63
+			{ 0xC2781F49FFCFA6D5, 0x3CBF6B71C76B25FB }, // 1e64
+			{ 0xF316271C7FC3908A, 0x8BEF464E3945EF7A }, // 1e65
+			{ 0x97EDD871CFDA3A56, 0x97758BF0E3CBB5AC }, // 1e66
+			{ 0xBDE94E8E43D0C8EC, 0x3D52EEED1CBEA317 }, // 1e67
+			{ 0xED63A231D4C4FB27, 0x4CA7AAA863EE4BDD }, // 1e68
+			{ 0x945E455F24FB1CF8, 0x8FE8CAA93E74EF6A }, // 1e69
+			{ 0xB975D6B6EE39E436, 0xB3E2FD538E122B44 }, // 1e70
+			{ 0xE7D34C64A9C85D44, 0x60DBBCA87196B616 }, // 1e71
+			{ 0x90E40FBEEA1D3A4A, 0xBC8955E946FE31CD }, // 1e72
+			{ 0xB51D13AEA4A488DD, 0x6BABAB6398BDBE41 }, // 1e73
+			{ 0xE264589A4DCDAB14, 0xC696963C7EED2DD1 }, // 1e74
+			{ 0x8D7EB76070A08AEC, 0xFC1E1DE5CF543CA2 }, // 1e75
+			{ 0xB0DE65388CC8ADA8, 0x3B25A55F43294BCB }, // 1e76
+			{ 0xDD15FE86AFFAD912, 0x49EF0EB713F39EBE }, // 1e77
+			{ 0x8A2DBF142DFCC7AB, 0x6E3569326C784337 }, // 1e78
+			{ 0xACB92ED9397BF996, 0x49C2C37F07965404 }, // 1e79
+			{ 0xD7E77A8F87DAF7FB, 0xDC33745EC97BE906 }, // 1e80
+			{ 0x86F0AC99B4E8DAFD, 0x69A028BB3DED71A3 }, // 1e81
+			{ 0xA8ACD7C0222311BC, 0xC40832EA0D68CE0C }, // 1e82
+			{ 0xD2D80DB02AABD62B, 0xF50A3FA490C30190 }, // 1e83
+			{ 0x83C7088E1AAB65DB, 0x792667C6DA79E0FA }, // 1e84
+			{ 0xA4B8CAB1A1563F52, 0x577001B891185938 }, // 1e85
+			{ 0xCDE6FD5E09ABCF26, 0xED4C0226B55E6F86 }, // 1e86
+			{ 0x80B05E5AC60B6178, 0x544F8158315B05B4 }, // 1e87
+			{ 0xA0DC75F1778E39D6, 0x696361AE3DB1C721 }, // 1e88
+			{ 0xC913936DD571C84C, 0x03BC3A19CD1E38E9 }, // 1e89
+			{ 0xFB5878494ACE3A5F, 0x04AB48A04065C723 }, // 1e90
+			{ 0x9D174B2DCEC0E47B, 0x62EB0D64283F9C76 }, // 1e91
+			{ 0xC45D1DF942711D9A, 0x3BA5D0BD324F8394 }, // 1e92
+			{ 0xF5746577930D6500, 0xCA8F44EC7EE36479 }, // 1e93
+			{ 0x9968BF6ABBE85F20, 0x7E998B13CF4E1ECB }, // 1e94
+			{ 0xBFC2EF456AE276E8, 0x9E3FEDD8C321A67E }, // 1e95
+			{ 0xEFB3AB16C59B14A2, 0xC5CFE94EF3EA101E }, // 1e96
+			{ 0x95D04AEE3B80ECE5, 0xBBA1F1D158724A12 }, // 1e97
+			{ 0xBB445DA9CA61281F, 0x2A8A6E45AE8EDC97 }, // 1e98
+			{ 0xEA1575143CF97226, 0xF52D09D71A3293BD }, // 1e99
+			{ 0x924D692CA61BE758, 0x593C2626705F9C56 }, // 1e100
+			{ 0xB6E0C377CFA2E12E, 0x6F8B2FB00C77836C }, // 1e101
+			{ 0xE498F455C38B997A, 0x0B6DFB9C0F956447 }, // 1e102
+			{ 0x8EDF98B59A373FEC, 0x4724BD4189BD5EAC }, // 1e103
+			{ 0xB2977EE300C50FE7, 0x58EDEC91EC2CB657 }, // 1e104
+			{ 0xDF3D5E9BC0F653E1, 0x2F2967B66737E3ED }, // 1e105
+			{ 0x8B865B215899F46C, 0xBD79E0D20082EE74 }, // 1e106
+			{ 0xAE67F1E9AEC07187, 0xECD8590680A3AA11 }, // 1e107
+			{ 0xDA01EE641A708DE9, 0xE80E6F4820CC9495 }, // 1e108
+			{ 0x884134FE908658B2, 0x3109058D147FDCDD }, // 1e109
+			{ 0xAA51823E34A7EEDE, 0xBD4B46F0599FD415 }, // 1e110
+			{ 0xD4E5E2CDC1D1EA96, 0x6C9E18AC7007C91A }, // 1e111
+			{ 0x850FADC09923329E, 0x03E2CF6BC604DDB0 }, // 1e112
+			{ 0xA6539930BF6BFF45, 0x84DB8346B786151C }, // 1e113
+			{ 0xCFE87F7CEF46FF16, 0xE612641865679A63 }, // 1e114
+			{ 0x81F14FAE158C5F6E, 0x4FCB7E8F3F60C07E }, // 1e115
+			{ 0xA26DA3999AEF7749, 0xE3BE5E330F38F09D }, // 1e116
+			{ 0xCB090C8001AB551C, 0x5CADF5BFD3072CC5 }, // 1e117
+			{ 0xFDCB4FA002162A63, 0x73D9732FC7C8F7F6 }, // 1e118
+			{ 0x9E9F11C4014DDA7E, 0x2867E7FDDCDD9AFA }, // 1e119
+			{ 0xC646D63501A1511D, 0xB281E1FD541501B8 }, // 1e120
+			{ 0xF7D88BC24209A565, 0x1F225A7CA91A4226 }, // 1e121
+			{ 0x9AE757596946075F, 0x3375788DE9B06958 }, // 1e122
+			{ 0xC1A12D2FC3978937, 0x0052D6B1641C83AE }, // 1e123
+			{ 0xF209787BB47D6B84, 0xC0678C5DBD23A49A }, // 1e124
+			{ 0x9745EB4D50CE6332, 0xF840B7BA963646E0 }, // 1e125
+			{ 0xBD176620A501FBFF, 0xB650E5A93BC3D898 }, // 1e126
+			{ 0xEC5D3FA8CE427AFF, 0xA3E51F138AB4CEBE }, // 1e127
+			{ 0x93BA47C980E98CDF, 0xC66F336C36B10137 }, // 1e128
+			{ 0xB8A8D9BBE123F017, 0xB80B0047445D4184 }, // 1e129
+			{ 0xE6D3102AD96CEC1D, 0xA60DC059157491E5 }, // 1e130
+			{ 0x9043EA1AC7E41392, 0x87C89837AD68DB2F }, // 1e131
+			{ 0xB454E4A179DD1877, 0x29BABE4598C311FB }, // 1e132
+			{ 0xE16A1DC9D8545E94, 0xF4296DD6FEF3D67A }, // 1e133
+			{ 0x8CE2529E2734BB1D, 0x1899E4A65F58660C }, // 1e134
+			{ 0xB01AE745B101E9E4, 0x5EC05DCFF72E7F8F }, // 1e135
+			{ 0xDC21A1171D42645D, 0x76707543F4FA1F73 }, // 1e136
+			{ 0x899504AE72497EBA, 0x6A06494A791C53A8 }, // 1e137
+			{ 0xABFA45DA0EDBDE69, 0x0487DB9D17636892 }, // 1e138
+			{ 0xD6F8D7509292D603, 0x45A9D2845D3C42B6 }, // 1e139
+			{ 0x865B86925B9BC5C2, 0x0B8A2392BA45A9B2 }, // 1e140
+			{ 0xA7F26836F282B732, 0x8E6CAC7768D7141E }, // 1e141
+			{ 0xD1EF0244AF2364FF, 0x3207D795430CD926 }, // 1e142
+			{ 0x8335616AED761F1F, 0x7F44E6BD49E807B8 }, // 1e143
+			{ 0xA402B9C5A8D3A6E7, 0x5F16206C9C6209A6 }, // 1e144
+			{ 0xCD036837130890A1, 0x36DBA887C37A8C0F }, // 1e145
+			{ 0x802221226BE55A64, 0xC2494954DA2C9789 }, // 1e146
+			{ 0xA02AA96B06DEB0FD, 0xF2DB9BAA10B7BD6C }, // 1e147
+			{ 0xC83553C5C8965D3D, 0x6F92829494E5ACC7 }, // 1e148
+			{ 0xFA42A8B73ABBF48C, 0xCB772339BA1F17F9 }, // 1e149
+			{ 0x9C69A97284B578D7, 0xFF2A760414536EFB }, // 1e150
+			{ 0xC38413CF25E2D70D, 0xFEF5138519684ABA }, // 1e151
+			{ 0xF46518C2EF5B8CD1, 0x7EB258665FC25D69 }, // 1e152
+			{ 0x98BF2F79D5993802, 0xEF2F773FFBD97A61 }, // 1e153
+			{ 0xBEEEFB584AFF8603, 0xAAFB550FFACFD8FA }, // 1e154
+			{ 0xEEAABA2E5DBF6784, 0x95BA2A53F983CF38 }, // 1e155
+			{ 0x952AB45CFA97A0B2, 0xDD945A747BF26183 }, // 1e156
+			{ 0xBA756174393D88DF, 0x94F971119AEEF9E4 }, // 1e157
+			{ 0xE912B9D1478CEB17, 0x7A37CD5601AAB85D }, // 1e158
+			{ 0x91ABB422CCB812EE, 0xAC62E055C10AB33A }, // 1e159
+			{ 0xB616A12B7FE617AA, 0x577B986B314D6009 }, // 1e160
+			{ 0xE39C49765FDF9D94, 0xED5A7E85FDA0B80B }, // 1e161
+			{ 0x8E41ADE9FBEBC27D, 0x14588F13BE847307 }, // 1e162
+			{ 0xB1D219647AE6B31C, 0x596EB2D8AE258FC8 }, // 1e163
+			{ 0xDE469FBD99A05FE3, 0x6FCA5F8ED9AEF3BB }, // 1e164
+			{ 0x8AEC23D680043BEE, 0x25DE7BB9480D5854 }, // 1e165
+			{ 0xADA72CCC20054AE9, 0xAF561AA79A10AE6A }, // 1e166
+			{ 0xD910F7FF28069DA4, 0x1B2BA1518094DA04 }, // 1e167
+			{ 0x87AA9AFF79042286, 0x90FB44D2F05D0842 }, // 1e168
+			{ 0xA99541BF57452B28, 0x353A1607AC744A53 }, // 1e169
+			{ 0xD3FA922F2D1675F2, 0x42889B8997915CE8 }, // 1e170
+			{ 0x847C9B5D7C2E09B7, 0x69956135FEBADA11 }, // 1e171
+			{ 0xA59BC234DB398C25, 0x43FAB9837E699095 }, // 1e172
+			{ 0xCF02B2C21207EF2E, 0x94F967E45E03F4BB }, // 1e173
+			{ 0x8161AFB94B44F57D, 0x1D1BE0EEBAC278F5 }, // 1e174
+			{ 0xA1BA1BA79E1632DC, 0x6462D92A69731732 }, // 1e175
+			{ 0xCA28A291859BBF93, 0x7D7B8F7503CFDCFE }, // 1e176
+			{ 0xFCB2CB35E702AF78, 0x5CDA735244C3D43E }, // 1e177
+			{ 0x9DEFBF01B061ADAB, 0x3A0888136AFA64A7 }, // 1e178
+			{ 0xC56BAEC21C7A1916, 0x088AAA1845B8FDD0 }, // 1e179
+			{ 0xF6C69A72A3989F5B, 0x8AAD549E57273D45 }, // 1e180
+			{ 0x9A3C2087A63F6399, 0x36AC54E2F678864B }, // 1e181
+			{ 0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DD }, // 1e182
+			{ 0xF0FDF2D3F3C30B9F, 0x656D44A2A11C51D5 }, // 1e183
+			{ 0x969EB7C47859E743, 0x9F644AE5A4B1B325 }, // 1e184
+			{ 0xBC4665B596706114, 0x873D5D9F0DDE1FEE }, // 1e185
+			{ 0xEB57FF22FC0C7959, 0xA90CB506D155A7EA }, // 1e186
+			{ 0x9316FF75DD87CBD8, 0x09A7F12442D588F2 }, // 1e187
+			{ 0xB7DCBF5354E9BECE, 0x0C11ED6D538AEB2F }, // 1e188
+			{ 0xE5D3EF282A242E81, 0x8F1668C8A86DA5FA }, // 1e189
+			{ 0x8FA475791A569D10, 0xF96E017D694487BC }, // 1e190
+			{ 0xB38D92D760EC4455, 0x37C981DCC395A9AC }, // 1e191
+			{ 0xE070F78D3927556A, 0x85BBE253F47B1417 }, // 1e192
+			{ 0x8C469AB843B89562, 0x93956D7478CCEC8E }, // 1e193
+			{ 0xAF58416654A6BABB, 0x387AC8D1970027B2 }, // 1e194
+			{ 0xDB2E51BFE9D0696A, 0x06997B05FCC0319E }, // 1e195
+			{ 0x88FCF317F22241E2, 0x441FECE3BDF81F03 }, // 1e196
+			{ 0xAB3C2FDDEEAAD25A, 0xD527E81CAD7626C3 }, // 1e197
+			{ 0xD60B3BD56A5586F1, 0x8A71E223D8D3B074 }, // 1e198
+			{ 0x85C7056562757456, 0xF6872D5667844E49 }, // 1e199
+			{ 0xA738C6BEBB12D16C, 0xB428F8AC016561DB }, // 1e200
+			{ 0xD106F86E69D785C7, 0xE13336D701BEBA52 }, // 1e201
+			{ 0x82A45B450226B39C, 0xECC0024661173473 }, // 1e202
+			{ 0xA34D721642B06084, 0x27F002D7F95D0190 }, // 1e203
+			{ 0xCC20CE9BD35C78A5, 0x31EC038DF7B441F4 }, // 1e204
+			{ 0xFF290242C83396CE, 0x7E67047175A15271 }, // 1e205
+			{ 0x9F79A169BD203E41, 0x0F0062C6E984D386 }, // 1e206
+			{ 0xC75809C42C684DD1, 0x52C07B78A3E60868 }, // 1e207
+			{ 0xF92E0C3537826145, 0xA7709A56CCDF8A82 }, // 1e208
+			{ 0x9BBCC7A142B17CCB, 0x88A66076400BB691 }, // 1e209
+			{ 0xC2ABF989935DDBFE, 0x6ACFF893D00EA435 }, // 1e210
+			{ 0xF356F7EBF83552FE, 0x0583F6B8C4124D43 }, // 1e211
+			{ 0x98165AF37B2153DE, 0xC3727A337A8B704A }, // 1e212
+			{ 0xBE1BF1B059E9A8D6, 0x744F18C0592E4C5C }, // 1e213
+			{ 0xEDA2EE1C7064130C, 0x1162DEF06F79DF73 }, // 1e214
+			{ 0x9485D4D1C63E8BE7, 0x8ADDCB5645AC2BA8 }, // 1e215
+			{ 0xB9A74A0637CE2EE1, 0x6D953E2BD7173692 }, // 1e216
+			{ 0xE8111C87C5C1BA99, 0xC8FA8DB6CCDD0437 }, // 1e217
+			{ 0x910AB1D4DB9914A0, 0x1D9C9892400A22A2 }, // 1e218
+			{ 0xB54D5E4A127F59C8, 0x2503BEB6D00CAB4B }, // 1e219
+			{ 0xE2A0B5DC971F303A, 0x2E44AE64840FD61D }, // 1e220
+			{ 0x8DA471A9DE737E24, 0x5CEAECFED289E5D2 }, // 1e221
+			{ 0xB10D8E1456105DAD, 0x7425A83E872C5F47 }, // 1e222
+			{ 0xDD50F1996B947518, 0xD12F124E28F77719 }, // 1e223
+			{ 0x8A5296FFE33CC92F, 0x82BD6B70D99AAA6F }, // 1e224
+			{ 0xACE73CBFDC0BFB7B, 0x636CC64D1001550B }, // 1e225
+			{ 0xD8210BEFD30EFA5A, 0x3C47F7E05401AA4E }, // 1e226
+			{ 0x8714A775E3E95C78, 0x65ACFAEC34810A71 }, // 1e227
+			{ 0xA8D9D1535CE3B396, 0x7F1839A741A14D0D }, // 1e228
+			{ 0xD31045A8341CA07C, 0x1EDE48111209A050 }, // 1e229
+			{ 0x83EA2B892091E44D, 0x934AED0AAB460432 }, // 1e230
+			{ 0xA4E4B66B68B65D60, 0xF81DA84D5617853F }, // 1e231
+			{ 0xCE1DE40642E3F4B9, 0x36251260AB9D668E }, // 1e232
+			{ 0x80D2AE83E9CE78F3, 0xC1D72B7C6B426019 }, // 1e233
+			{ 0xA1075A24E4421730, 0xB24CF65B8612F81F }, // 1e234
+			{ 0xC94930AE1D529CFC, 0xDEE033F26797B627 }, // 1e235
+			{ 0xFB9B7CD9A4A7443C, 0x169840EF017DA3B1 }, // 1e236
+			{ 0x9D412E0806E88AA5, 0x8E1F289560EE864E }, // 1e237
+			{ 0xC491798A08A2AD4E, 0xF1A6F2BAB92A27E2 }, // 1e238
+			{ 0xF5B5D7EC8ACB58A2, 0xAE10AF696774B1DB }, // 1e239
+			{ 0x9991A6F3D6BF1765, 0xACCA6DA1E0A8EF29 }, // 1e240
+			{ 0xBFF610B0CC6EDD3F, 0x17FD090A58D32AF3 }, // 1e241
+			{ 0xEFF394DCFF8A948E, 0xDDFC4B4CEF07F5B0 }, // 1e242
+			{ 0x95F83D0A1FB69CD9, 0x4ABDAF101564F98E }, // 1e243
+			{ 0xBB764C4CA7A4440F, 0x9D6D1AD41ABE37F1 }, // 1e244
+			{ 0xEA53DF5FD18D5513, 0x84C86189216DC5ED }, // 1e245
+			{ 0x92746B9BE2F8552C, 0x32FD3CF5B4E49BB4 }, // 1e246
+			{ 0xB7118682DBB66A77, 0x3FBC8C33221DC2A1 }, // 1e247
+			{ 0xE4D5E82392A40515, 0x0FABAF3FEAA5334A }, // 1e248
+			{ 0x8F05B1163BA6832D, 0x29CB4D87F2A7400E }, // 1e249
+			{ 0xB2C71D5BCA9023F8, 0x743E20E9EF511012 }, // 1e250
+			{ 0xDF78E4B2BD342CF6, 0x914DA9246B255416 }, // 1e251
+			{ 0x8BAB8EEFB6409C1A, 0x1AD089B6C2F7548E }, // 1e252
+			{ 0xAE9672ABA3D0C320, 0xA184AC2473B529B1 }, // 1e253
+			{ 0xDA3C0F568CC4F3E8, 0xC9E5D72D90A2741E }, // 1e254
+			{ 0x8865899617FB1871, 0x7E2FA67C7A658892 }, // 1e255
+			{ 0xAA7EEBFB9DF9DE8D, 0xDDBB901B98FEEAB7 }, // 1e256
+			{ 0xD51EA6FA85785631, 0x552A74227F3EA565 }, // 1e257
+			{ 0x8533285C936B35DE, 0xD53A88958F87275F }, // 1e258
+			{ 0xA67FF273B8460356, 0x8A892ABAF368F137 }, // 1e259
+			{ 0xD01FEF10A657842C, 0x2D2B7569B0432D85 }, // 1e260
+			{ 0x8213F56A67F6B29B, 0x9C3B29620E29FC73 }, // 1e261
+			{ 0xA298F2C501F45F42, 0x8349F3BA91B47B8F }, // 1e262
+			{ 0xCB3F2F7642717713, 0x241C70A936219A73 }, // 1e263
+			{ 0xFE0EFB53D30DD4D7, 0xED238CD383AA0110 }, // 1e264
+			{ 0x9EC95D1463E8A506, 0xF4363804324A40AA }, // 1e265
+			{ 0xC67BB4597CE2CE48, 0xB143C6053EDCD0D5 }, // 1e266
+			{ 0xF81AA16FDC1B81DA, 0xDD94B7868E94050A }, // 1e267
+			{ 0x9B10A4E5E9913128, 0xCA7CF2B4191C8326 }, // 1e268
+			{ 0xC1D4CE1F63F57D72, 0xFD1C2F611F63A3F0 }, // 1e269
+			{ 0xF24A01A73CF2DCCF, 0xBC633B39673C8CEC }, // 1e270
+			{ 0x976E41088617CA01, 0xD5BE0503E085D813 }, // 1e271
+			{ 0xBD49D14AA79DBC82, 0x4B2D8644D8A74E18 }, // 1e272
+			{ 0xEC9C459D51852BA2, 0xDDF8E7D60ED1219E }, // 1e273
+			{ 0x93E1AB8252F33B45, 0xCABB90E5C942B503 }, // 1e274
+			{ 0xB8DA1662E7B00A17, 0x3D6A751F3B936243 }, // 1e275
+			{ 0xE7109BFBA19C0C9D, 0x0CC512670A783AD4 }, // 1e276
+			{ 0x906A617D450187E2, 0x27FB2B80668B24C5 }, // 1e277
+			{ 0xB484F9DC9641E9DA, 0xB1F9F660802DEDF6 }, // 1e278
+			{ 0xE1A63853BBD26451, 0x5E7873F8A0396973 }, // 1e279
+			{ 0x8D07E33455637EB2, 0xDB0B487B6423E1E8 }, // 1e280
+			{ 0xB049DC016ABC5E5F, 0x91CE1A9A3D2CDA62 }, // 1e281
+			{ 0xDC5C5301C56B75F7, 0x7641A140CC7810FB }, // 1e282
+			{ 0x89B9B3E11B6329BA, 0xA9E904C87FCB0A9D }, // 1e283
+			{ 0xAC2820D9623BF429, 0x546345FA9FBDCD44 }, // 1e284
+			{ 0xD732290FBACAF133, 0xA97C177947AD4095 }, // 1e285
+			{ 0x867F59A9D4BED6C0, 0x49ED8EABCCCC485D }, // 1e286
+			{ 0xA81F301449EE8C70, 0x5C68F256BFFF5A74 }, // 1e287
+			{ 0xD226FC195C6A2F8C, 0x73832EEC6FFF3111 }, // 1e288
+			{ 0x83585D8FD9C25DB7, 0xC831FD53C5FF7EAB }, // 1e289
+			{ 0xA42E74F3D032F525, 0xBA3E7CA8B77F5E55 }, // 1e290
+			{ 0xCD3A1230C43FB26F, 0x28CE1BD2E55F35EB }, // 1e291
+			{ 0x80444B5E7AA7CF85, 0x7980D163CF5B81B3 }, // 1e292
+			{ 0xA0555E361951C366, 0xD7E105BCC332621F }, // 1e293
+			{ 0xC86AB5C39FA63440, 0x8DD9472BF3FEFAA7 }, // 1e294
+			{ 0xFA856334878FC150, 0xB14F98F6F0FEB951 }, // 1e295
+			{ 0x9C935E00D4B9D8D2, 0x6ED1BF9A569F33D3 }, // 1e296
+			{ 0xC3B8358109E84F07, 0x0A862F80EC4700C8 }, // 1e297
+			{ 0xF4A642E14C6262C8, 0xCD27BB612758C0FA }, // 1e298
+			{ 0x98E7E9CCCFBD7DBD, 0x8038D51CB897789C }, // 1e299
+			{ 0xBF21E44003ACDD2C, 0xE0470A63E6BD56C3 }, // 1e300
+			{ 0xEEEA5D5004981478, 0x1858CCFCE06CAC74 }, // 1e301
+			{ 0x95527A5202DF0CCB, 0x0F37801E0C43EBC8 }, // 1e302
+			{ 0xBAA718E68396CFFD, 0xD30560258F54E6BA }, // 1e303
+			{ 0xE950DF20247C83FD, 0x47C6B82EF32A2069 }, // 1e304
+			{ 0x91D28B7416CDD27E, 0x4CDC331D57FA5441 }, // 1e305
+			{ 0xB6472E511C81471D, 0xE0133FE4ADF8E952 }, // 1e306
+			{ 0xE3D8F9E563A198E5, 0x58180FDDD97723A6 }, // 1e307
+			{ 0x8E679C2F5E44FF8F, 0x570F09EAA7EA7648 }, // 1e308
+		};
+
+		inline int CountLeadingZeros64(uint64_t iValue)
 		{
-			JsonStthmAssert(pEnd == NULL || pEnd >= pString);
-			size_t iLen = (pEnd != NULL) ? (pEnd - pString) : strlen(pString);
-			char* pNewString = m_pAllocator->AllocString(iLen + 1, m_pAllocator->pUserData);
-			memcpy(pNewString, pString, iLen);
-			pNewString[iLen] = 0;
-			m_oValue.String = pNewString;
+			JsonStthmAssert(iValue != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+			unsigned long iIndex;
+			_BitScanReverse64(&iIndex, iValue);
+			return 63 - (int)iIndex;
+#elif defined(_MSC_VER)
+			unsigned long iIndex;
+			if ((iValue >> 32) != 0)
+			{
+				_BitScanReverse(&iIndex, (uint32_t)(iValue >> 32));
+				return 31 - (int)iIndex;
+			}
+			_BitScanReverse(&iIndex, (uint32_t)iValue);
+			return 63 - (int)iIndex;
+#else
+			return __builtin_clzll(iValue);
+#endif
 		}
-	}
 
-	int JsonValue::ReadString(const char* pJson, const char* pJsonEnd)
-	{
-		if (pJson != NULL)
+		// Return low 64 bits of product, high 64 bits in pHigh
+		inline uint64_t Multiply128(uint64_t iA, uint64_t iB, uint64_t* pHigh)
 		{
-			Reset();
-			if (pJsonEnd == NULL)
+#if defined(__SIZEOF_INT128__)
+			__extension__ typedef unsigned __int128 uint128_t;
+			const uint128_t iProduct = (uint128_t)iA * iB;
+			*pHigh = (uint64_t)(iProduct >> 64);
+			return (uint64_t)iProduct;
+#elif defined(_MSC_VER) && defined(_M_X64)
+			return _umul128(iA, iB, pHigh);
+#else
+			const uint64_t iLowLow = (iA & 0xFFFFFFFF) * (iB & 0xFFFFFFFF);
+			const uint64_t iLowHigh = (iA & 0xFFFFFFFF) * (iB >> 32);
+			const uint64_t iHighLow = (iA >> 32) * (iB & 0xFFFFFFFF);
+			const uint64_t iHighHigh = (iA >> 32) * (iB >> 32);
+			const uint64_t iMiddle = (iLowLow >> 32) + (iLowHigh & 0xFFFFFFFF) + (iHighLow & 0xFFFFFFFF);
+			*pHigh = iHighHigh + (iLowHigh >> 32) + (iHighLow >> 32) + (iMiddle >> 32);
+			return (iMiddle << 32) | (iLowLow & 0xFFFFFFFF);
+#endif
+		}
+
+		// Eisel-Lemire, exactly rounded iMantissa * 10^iExp10
+		// Return false when result can't be decided (halfway cases, subnormals, out of range), caller should fallback
+		bool EiselLemire(uint64_t iMantissa, int iExp10, bool bNeg, double* pOut)
+		{
+			JsonStthmAssert(iMantissa != 0);
+			if (iExp10 < c_iPow10Mantissa128Min || iExp10 > c_iPow10Mantissa128Max)
+				return false;
+
+			// Normalization
+			const int iLeadingZeros = CountLeadingZeros64(iMantissa);
+			iMantissa <<= iLeadingZeros;
+			// floor(log2(10) * iExp10) + 64 + bias
+			uint64_t iExp2 = (uint64_t)(((217706 * iExp10) >> 16) + 64 + 1023 - iLeadingZeros);
+
+			// Multiplication
+			const uint64_t* pPow10 = c_pPow10Mantissa128[iExp10 - c_iPow10Mantissa128Min];
+			uint64_t iHigh;
+			uint64_t iLow = Multiply128(iMantissa, pPow10[0], &iHigh);
+
+			// Wider approximation when low bits of high part are all ones
+			if ((iHigh & 0x1FF) == 0x1FF && iLow + iMantissa < iMantissa)
 			{
-				pJsonEnd = pJson + strlen(pJson);
+				uint64_t iHigh2;
+				const uint64_t iLow2 = Multiply128(iMantissa, pPow10[1], &iHigh2);
+				uint64_t iMergedHigh = iHigh;
+				const uint64_t iMergedLow = iLow + iHigh2;
+				if (iMergedLow < iLow)
+					iMergedHigh++;
+				if ((iMergedHigh & 0x1FF) == 0x1FF && iMergedLow + 1 == 0 && iLow2 + iMantissa < iMantissa)
+					return false;
+				iHigh = iMergedHigh;
+				iLow = iMergedLow;
 			}
-			const char* pEnd = pJson;
-			if (Parse(pEnd, pJsonEnd) == false)
+
+			// Shift to 54 bits
+			const uint64_t iMsb = iHigh >> 63;
+			uint64_t iResultMantissa = iHigh >> (iMsb + 9);
+			iExp2 -= 1 ^ iMsb;
+
+			// Halfway ambiguity
+			if (iLow == 0 && (iHigh & 0x1FF) == 0 && (iResultMantissa & 3) == 1)
+				return false;
+
+			// From 54 to 53 bits
+			iResultMantissa += iResultMantissa & 1;
+			iResultMantissa >>= 1;
+			if ((iResultMantissa >> 53) > 0)
 			{
-				int iLine = 1;
-				int iReturn = 1;
-				while (pJson != pEnd)
-				{
-					if (*pJson == '\n')
-						++iLine;
-					else if (*pJson == '\r')
-						++iReturn;
-					++pJson;
-				}
-				if (iReturn > iLine)
-					iLine = iReturn;
-				return iLine;
+				iResultMantissa >>= 1;
+				iExp2 += 1;
 			}
-			return 0;
+
+			// Subnormal, infinity or NaN
+			if (iExp2 - 1 >= 0x7FF - 1)
+				return false;
+
+			uint64_t iBits = (iExp2 << 52) | (iResultMantissa & 0x000FFFFFFFFFFFFFULL);
+			if (bNeg)
+				iBits |= 0x8000000000000000ULL;
+			memcpy(pOut, &iBits, sizeof(double));
+			return true;
 		}
-		return -1;
-	}
 
-	int JsonValue::ReadFile(const char* pFilename)
-	{
-		FILE* pFile = fopen(pFilename, "r");
-		if (NULL != pFile)
+		// Slow path, strtod can't be limited to pEnd so work on a terminated copy
+		double StrToDouble(const char* pBegin, const char* pEnd)
 		{
-			Reset();
+			CharBuffer oNumber;
+			oNumber.PushRange(pBegin, pEnd - pBegin);
+			oNumber.Push(0);
+			return strtod(oNumber.Data(), NULL);
+		}
+
+		// Return 0 on success, -1 when file can't be opened, -2 on allocation failure
+		// Map file in memory when asked and possible, or read it in a buffer
+		// Content is writable in both cases (mapping is copy on write) but mapped content is not null terminated
+		int ReadFileContent(const char* pFilename, char** pOutContent, size_t* pOutSize, bool bMap, bool* pOutMapped)
+		{
+			*pOutMapped = false;
+
+#if defined(STTHM_USE_MMAP)
+			int iFile = bMap ? open(pFilename, O_RDONLY) : -1;
+			struct stat oStat;
+			if (iFile >= 0 && fstat(iFile, &oStat) == 0 && S_ISREG(oStat.st_mode) && oStat.st_size > 0)
+			{
+				void* pMapping = mmap(NULL, (size_t)oStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, iFile, 0);
+				if (pMapping != MAP_FAILED)
+				{
+					close(iFile);
+					// Pages are read ahead while parsing
+					madvise(pMapping, (size_t)oStat.st_size, MADV_SEQUENTIAL);
+
+					*pOutContent = (char*)pMapping;
+					*pOutSize = (size_t)oStat.st_size;
+					*pOutMapped = true;
+					return 0;
+				}
+			}
+			if (iFile >= 0)
+				close(iFile);
+			// Empty or special file, fallback to fread
+#else
+			(void)bMap;
+#endif //STTHM_USE_MMAP
+
+			FILE* pFile = fopen(pFilename, "rb");
+			if (NULL == pFile)
+				return -1;
 
 			fseek(pFile, 0, SEEK_END);
 			long iSize = ftell(pFile);
@@ -359,1422 +1256,6201 @@ namespace JsonStthm
 				return -2;
 			}
 
-			fread(pString, 1, iSize, pFile);
+			// Can read less than iSize if file is truncated meanwhile
+			size_t iRead = fread(pString, 1, iSize, pFile);
 			fclose(pFile);
-			pString[iSize] = 0;
+			pString[iRead] = 0;
 
-			int iLine = ReadString(pString, pString + iSize);
+			*pOutContent = pString;
+			*pOutSize = iRead;
+			return 0;
+		}
 
-			JsonStthmFree(pString);
-			return iLine;
+		void FreeFileContent(char* pContent, size_t iSize, bool bMapped)
+		{
+#if defined(STTHM_USE_MMAP)
+			if (bMapped)
+			{
+				munmap(pContent, iSize);
+				return;
+			}
+#else
+			(void)iSize;
+			(void)bMapped;
+#endif //STTHM_USE_MMAP
+			JsonStthmFree(pContent);
 		}
-		return -1;
-	}
 
-	void JsonValue::Write(Internal::CharBuffer& sOutJson, size_t iIndent, bool bCompact) const
-	{
-		if (m_eType == E_TYPE_OBJECT)
+		int GetErrorLine(const char* pJson, const char* pJsonEnd, const char* pError)
 		{
-			sOutJson += '{';
-			JsonValue* pChild = m_oValue.Childs.m_pFirst;
-			bool bFirst = true;
-			while (pChild != NULL)
+			// Error can be reported after the end of the input, which is not always null terminated
+			if (pError > pJsonEnd)
+				pError = pJsonEnd;
+
+			int iLine = 1;
+			int iReturn = 1;
+			while (pJson != pError)
 			{
-				if (bFirst == false)
-				{
-					sOutJson += ',';
-				}
-				else
-				{
-					bFirst = false;
-				}
+				if (*pJson == '\n')
+					++iLine;
+				else if (*pJson == '\r')
+					++iReturn;
+				++pJson;
+			}
+			if (iReturn > iLine)
+				iLine = iReturn;
+			return iLine;
+		}
 
-				if (bCompact == false)
-				{
-					sOutJson += '\n';
-					sOutJson.PushRepeat('\t', iIndent + 1);
-				}
+		// Hardware threads, 1 without STTHM_USE_THREADS
+		size_t GetThreadCount()
+		{
+#if defined(STTHM_USE_THREADS)
+			unsigned int iCount = std::thread::hardware_concurrency();
+			if (iCount > 0)
+				return iCount;
+#endif //STTHM_USE_THREADS
+			return 1;
+		}
 
-				sOutJson += '\"';
-				WriteStringEscaped(sOutJson, pChild->m_pName);
-				sOutJson += '\"';
-				sOutJson += ':';
-				if (bCompact == false)
-					sOutJson += ' ';
+		typedef void (*WorkerCallback)(size_t iWorker, size_t iWorkerCount, void* pUserData);
 
-				pChild->Write(sOutJson, iIndent + 1, bCompact);
-				pChild = pChild->m_pNext;
+		// Run iWorkerCount workers on their own thread and wait for them, calling thread run the first one
+		// Workers are run one after the other without STTHM_USE_THREADS
+		void RunWorkers(size_t iWorkerCount, WorkerCallback pWorker, void* pUserData)
+		{
+#if defined(STTHM_USE_THREADS)
+			if (iWorkerCount > 1)
+			{
+				std::thread* pThreads = new std::thread[iWorkerCount - 1];
+				for (size_t iWorker = 1; iWorker < iWorkerCount; ++iWorker)
+					pThreads[iWorker - 1] = std::thread(pWorker, iWorker, iWorkerCount, pUserData);
+				pWorker(0, iWorkerCount, pUserData);
+				for (size_t iWorker = 1; iWorker < iWorkerCount; ++iWorker)
+					pThreads[iWorker - 1].join();
+				delete[] pThreads;
+				return;
 			}
+#endif //STTHM_USE_THREADS
+			for (size_t iWorker = 0; iWorker < iWorkerCount; ++iWorker)
+				pWorker(iWorker, iWorkerCount, pUserData);
+		}
 
-			if (bCompact == false)
+		//////////////////////////////
+		// Number formatting
+
+		static const char c_pDigitPairs[201] =
+			"00010203040506070809"
+			"10111213141516171819"
+			"20212223242526272829"
+			"30313233343536373839"
+			"40414243444546474849"
+			"50515253545556575859"
+			"60616263646566676869"
+			"70717273747576777879"
+			"80818283848586878889"
+			"90919293949596979899";
+
+		static const uint64_t c_pPow10[20] = {
+			1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL,
+			100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+			10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+			1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+		};
+
+		inline int CountDigits(uint64_t iValue)
+		{
+			int iDigits = 1;
+			while (iDigits < 20 && iValue >= c_pPow10[iDigits])
+				++iDigits;
+			return iDigits;
+		}
+
+		// Write decimal digits of iValue, two at time, return end of written digits
+		char* WriteUnsigned(char* pOut, uint64_t iValue)
+		{
+			char* pEnd = pOut + CountDigits(iValue);
+			char* pDigit = pEnd;
+			while (iValue >= 100)
+			{
+				const char* pPair = &c_pDigitPairs[(iValue % 100) * 2];
+				iValue /= 100;
+				*--pDigit = pPair[1];
+				*--pDigit = pPair[0];
+			}
+			if (iValue >= 10)
+			{
+				*--pDigit = c_pDigitPairs[iValue * 2 + 1];
+				*--pDigit = c_pDigitPairs[iValue * 2];
+			}
+			else
 			{
-				sOutJson += '\n';
-				sOutJson.PushRepeat('\t', iIndent);
+				*--pDigit = (char)('0' + iValue);
 			}
+			return pEnd;
+		}
 
-			sOutJson += '}';
+		char* WriteInteger(char* pOut, int64_t iValue)
+		{
+			uint64_t iAbsValue = (uint64_t)iValue;
+			if (iValue < 0)
+			{
+				*pOut++ = '-';
+				iAbsValue = 0 - iAbsValue;
+			}
+			return WriteUnsigned(pOut, iAbsValue);
 		}
-		else if (m_eType == E_TYPE_ARRAY)
+
+		// Grisu2 shortest double formatting (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers")
+		// Output always read back to same double, and is the shortest in nearly all cases
+		struct DiyFp
 		{
-			sOutJson += '[';
-			JsonValue* pChild = m_oValue.Childs.m_pFirst;
-			bool bFirst = true;
-			while (pChild != NULL)
+			uint64_t	m_iF;
+			int			m_iE;
+
+			DiyFp() {}
+			DiyFp(uint64_t iF, int iE) : m_iF(iF), m_iE(iE) {}
+
+			DiyFp operator-(const DiyFp& oRight) const
+			{
+				JsonStthmAssert(m_iE == oRight.m_iE && m_iF >= oRight.m_iF);
+				return DiyFp(m_iF - oRight.m_iF, m_iE);
+			}
+
+			// Rounded upper 64 bits of 128 bits product
+			DiyFp operator*(const DiyFp& oRight) const
+			{
+				const uint64_t c_iMask32 = 0xFFFFFFFF;
+				const uint64_t iA = m_iF >> 32;
+				const uint64_t iB = m_iF & c_iMask32;
+				const uint64_t iC = oRight.m_iF >> 32;
+				const uint64_t iD = oRight.m_iF & c_iMask32;
+				const uint64_t iAC = iA * iC;
+				const uint64_t iBC = iB * iC;
+				const uint64_t iAD = iA * iD;
+				const uint64_t iBD = iB * iD;
+				uint64_t iTemp = (iBD >> 32) + (iAD & c_iMask32) + (iBC & c_iMask32);
+				iTemp += 1U << 31;
+				return DiyFp(iAC + (iAD >> 32) + (iBC >> 32) + (iTemp >> 32), m_iE + oRight.m_iE + 64);
+			}
+
+			DiyFp Normalize() const
 			{
-				if (bFirst == false)
+				DiyFp oResult = *this;
+				while ((oResult.m_iF & (1ULL << 63)) == 0)
 				{
-					sOutJson += ',';
+					oResult.m_iF <<= 1;
+					oResult.m_iE--;
 				}
-				else
+				return oResult;
+			}
+		};
+
+		static const uint64_t c_iDoubleHiddenBit = 0x0010000000000000ULL;
+		static const uint64_t c_iDoubleSignificandMask = 0x000FFFFFFFFFFFFFULL;
+		static const int c_iDoubleExponentBias = 0x3FF + 52;
+
+		// Cached powers 10^k for k = -348 to 340 by step of 8, normalized
+		static const uint64_t c_pCachedPowersF[] = {
+			0xFA8FD5A0081C0288, 0xBAAEE17FA23EBF76, 0x8B16FB203055AC76,
+			0xCF42894A5DCE35EA, 0x9A6BB0AA55653B2D, 0xE61ACF033D1A45DF,
+			0xAB70FE17C79AC6CA, 0xFF77B1FCBEBCDC4F, 0xBE5691EF416BD60C,
+			0x8DD01FAD907FFC3C, 0xD3515C2831559A83, 0x9D71AC8FADA6C9B5,
+			0xEA9C227723EE8BCB, 0xAECC49914078536D, 0x823C12795DB6CE57,
+			0xC21094364DFB5637, 0x9096EA6F3848984F, 0xD77485CB25823AC7,
+			0xA086CFCD97BF97F4, 0xEF340A98172AACE5, 0xB23867FB2A35B28E,
+			0x84C8D4DFD2C63F3B, 0xC5DD44271AD3CDBA, 0x936B9FCEBB25C996,
+			0xDBAC6C247D62A584, 0xA3AB66580D5FDAF6, 0xF3E2F893DEC3F126,
+			0xB5B5ADA8AAFF80B8, 0x87625F056C7C4A8B, 0xC9BCFF6034C13053,
+			0x964E858C91BA2655, 0xDFF9772470297EBD, 0xA6DFBD9FB8E5B88F,
+			0xF8A95FCF88747D94, 0xB94470938FA89BCF, 0x8A08F0F8BF0F156B,
+			0xCDB02555653131B6, 0x993FE2C6D07B7FAC, 0xE45C10C42A2B3B06,
+			0xAA242499697392D3, 0xFD87B5F28300CA0E, 0xBCE5086492111AEB,
+			0x8CBCCC096F5088CC, 0xD1B71758E219652C, 0x9C40000000000000,
+			0xE8D4A51000000000, 0xAD78EBC5AC620000, 0x813F3978F8940984,
+			0xC097CE7BC90715B3, 0x8F7E32CE7BEA5C70, 0xD5D238A4ABE98068,
+			0x9F4F2726179A2245, 0xED63A231D4C4FB27, 0xB0DE65388CC8ADA8,
+			0x83C7088E1AAB65DB, 0xC45D1DF942711D9A, 0x924D692CA61BE758,
+			0xDA01EE641A708DEA, 0xA26DA3999AEF774A, 0xF209787BB47D6B85,
+			0xB454E4A179DD1877, 0x865B86925B9BC5C2, 0xC83553C5C8965D3D,
+			0x952AB45CFA97A0B3, 0xDE469FBD99A05FE3, 0xA59BC234DB398C25,
+			0xF6C69A72A3989F5C, 0xB7DCBF5354E9BECE, 0x88FCF317F22241E2,
+			0xCC20CE9BD35C78A5, 0x98165AF37B2153DF, 0xE2A0B5DC971F303A,
+			0xA8D9D1535CE3B396, 0xFB9B7CD9A4A7443C, 0xBB764C4CA7A44410,
+			0x8BAB8EEFB6409C1A, 0xD01FEF10A657842C, 0x9B10A4E5E9913129,
+			0xE7109BFBA19C0C9D, 0xAC2820D9623BF429, 0x80444B5E7AA7CF85,
+			0xBF21E44003ACDD2D, 0x8E679C2F5E44FF8F, 0xD433179D9C8CB841,
+			0x9E19DB92B4E31BA9, 0xEB96BF6EBADF77D9, 0xAF87023B9BF0EE6B,
+		};
+		static const int16_t c_pCachedPowersE[] = {
+			-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927, -901, -874, -847,
+			-821, -794, -768, -741, -715, -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+			-422, -396, -369, -343, -316, -289, -263, -236, -210, -183, -157, -130, -103, -77, -50,
+			-24, 3, 30, 56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+			375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667, 694, 720, 747,
+			774, 800, 827, 853, 880, 907, 933, 960, 986, 1013, 1039, 1066,
+		};
+
+		// Cached power c_mk for which exponent of w * c_mk is in [-60, -32], K receive -k
+		DiyFp GetCachedPower(int iE, int* pK)
+		{
+			const double fK = (-61 - iE) * 0.30102999566398114 + 347; // Positive, so ceil can be done by truncation
+			int iK = (int)fK;
+			if (fK - iK > 0.0)
+				iK++;
+			const unsigned int iIndex = (unsigned int)((iK >> 3) + 1);
+			*pK = -(-348 + (int)(iIndex << 3));
+			return DiyFp(c_pCachedPowersF[iIndex], c_pCachedPowersE[iIndex]);
+		}
+
+		void GrisuRound(char* pBuffer, int iLength, uint64_t iDelta, uint64_t iRest, uint64_t iTenKappa, uint64_t iDistance)
+		{
+			while (iRest < iDistance && iDelta - iRest >= iTenKappa &&
+				(iRest + iTenKappa < iDistance || iDistance - iRest > iRest + iTenKappa - iDistance))
+			{
+				pBuffer[iLength - 1]--;
+				iRest += iTenKappa;
+			}
+		}
+
+		void GrisuDigitGen(const DiyFp& oW, const DiyFp& oMp, uint64_t iDelta, char* pBuffer, int* pLength, int* pK)
+		{
+			const DiyFp oOne(1ULL << -oMp.m_iE, oMp.m_iE);
+			const DiyFp oDistance = oMp - oW;
+			uint32_t iP1 = (uint32_t)(oMp.m_iF >> -oOne.m_iE);
+			uint64_t iP2 = oMp.m_iF & (oOne.m_iF - 1);
+			int iKappa = CountDigits(iP1);
+			*pLength = 0;
+
+			while (iKappa > 0)
+			{
+				const uint32_t iPow10 = (uint32_t)c_pPow10[iKappa - 1];
+				const uint32_t iDigit = iP1 / iPow10;
+				iP1 %= iPow10;
+				if (iDigit != 0 || *pLength != 0)
+					pBuffer[(*pLength)++] = (char)('0' + iDigit);
+				iKappa--;
+				const uint64_t iRest = ((uint64_t)iP1 << -oOne.m_iE) + iP2;
+				if (iRest <= iDelta)
 				{
-					bFirst = false;
+					*pK += iKappa;
+					GrisuRound(pBuffer, *pLength, iDelta, iRest, c_pPow10[iKappa] << -oOne.m_iE, oDistance.m_iF);
+					return;
 				}
+			}
 
-				if (bCompact == false)
+			for (;;)
+			{
+				iP2 *= 10;
+				iDelta *= 10;
+				const char iDigit = (char)(iP2 >> -oOne.m_iE);
+				if (iDigit != 0 || *pLength != 0)
+					pBuffer[(*pLength)++] = (char)('0' + iDigit);
+				iP2 &= oOne.m_iF - 1;
+				iKappa--;
+				if (iP2 < iDelta)
 				{
-					sOutJson += '\n';
-					sOutJson.PushRepeat('\t', iIndent + 1);
+					*pK += iKappa;
+					const int iIndex = -iKappa;
+					GrisuRound(pBuffer, *pLength, iDelta, iP2, oOne.m_iF, oDistance.m_iF * (iIndex < 20 ? c_pPow10[iIndex] : 0));
+					return;
 				}
-
-				pChild->Write(sOutJson, iIndent + 1, bCompact);
-				pChild = pChild->m_pNext;
 			}
-			if (bCompact == false)
+		}
+
+		// Shortest digits of positive finite fValue, value is digits * 10^K
+		void Grisu2(double fValue, char* pBuffer, int* pLength, int* pK)
+		{
+			uint64_t iBits;
+			memcpy(&iBits, &fValue, sizeof(iBits));
+			const int iBiasedExponent = (int)((iBits >> 52) & 0x7FF);
+			const uint64_t iSignificand = iBits & c_iDoubleSignificandMask;
+
+			DiyFp oV;
+			if (iBiasedExponent != 0)
+				oV = DiyFp(iSignificand + c_iDoubleHiddenBit, iBiasedExponent - c_iDoubleExponentBias);
+			else
+				oV = DiyFp(iSignificand, 1 - c_iDoubleExponentBias);
+
+			// Boundaries m+ and m-, with same exponent
+			DiyFp oPlus = DiyFp((oV.m_iF << 1) + 1, oV.m_iE - 1);
+			while ((oPlus.m_iF & (c_iDoubleHiddenBit << 1)) == 0)
 			{
-				sOutJson += '\n';
-				sOutJson.PushRepeat('\t', iIndent);
+				oPlus.m_iF <<= 1;
+				oPlus.m_iE--;
 			}
-			sOutJson += ']';
+			oPlus.m_iF <<= 64 - 52 - 2;
+			oPlus.m_iE -= 64 - 52 - 2;
+			DiyFp oMinus = (oV.m_iF == c_iDoubleHiddenBit) ? DiyFp((oV.m_iF << 2) - 1, oV.m_iE - 2) : DiyFp((oV.m_iF << 1) - 1, oV.m_iE - 1);
+			oMinus.m_iF <<= oMinus.m_iE - oPlus.m_iE;
+			oMinus.m_iE = oPlus.m_iE;
+
+			const DiyFp oCachedPower = GetCachedPower(oPlus.m_iE, pK);
+			const DiyFp oW = oV.Normalize() * oCachedPower;
+			DiyFp oWPlus = oPlus * oCachedPower;
+			DiyFp oWMinus = oMinus * oCachedPower;
+			oWMinus.m_iF++;
+			oWPlus.m_iF--;
+			GrisuDigitGen(oW, oWPlus, oWPlus.m_iF - oWMinus.m_iF, pBuffer, pLength, pK);
 		}
-		else if (m_eType == E_TYPE_STRING)
+
+		// Place decimal point of Grisu2 digits, keep a fractional part so value is read back as a float
+		char* FormatDigits(char* pBuffer, int iLength, int iK)
 		{
-			sOutJson += '\"';
-			WriteStringEscaped(sOutJson, m_oValue.String);
-			sOutJson += '\"';
+			const int iPointPos = iLength + iK; // 10^(iPointPos - 1) <= v < 10^iPointPos
+
+			if (iK >= 0 && iPointPos <= 21)
+			{
+				// 1234e7 -> 12340000000.0
+				for (int i = iLength; i < iPointPos; ++i)
+					pBuffer[i] = '0';
+				pBuffer[iPointPos] = '.';
+				pBuffer[iPointPos + 1] = '0';
+				return &pBuffer[iPointPos + 2];
+			}
+			else if (iPointPos > 0 && iPointPos <= 21)
+			{
+				// 1234e-2 -> 12.34
+				memmove(&pBuffer[iPointPos + 1], &pBuffer[iPointPos], iLength - iPointPos);
+				pBuffer[iPointPos] = '.';
+				return &pBuffer[iLength + 1];
+			}
+			else if (iPointPos > -6 && iPointPos <= 0)
+			{
+				// 1234e-6 -> 0.001234
+				const int iOffset = 2 - iPointPos;
+				memmove(&pBuffer[iOffset], &pBuffer[0], iLength);
+				pBuffer[0] = '0';
+				pBuffer[1] = '.';
+				for (int i = 2; i < iOffset; ++i)
+					pBuffer[i] = '0';
+				return &pBuffer[iLength + iOffset];
+			}
+
+			char* pExponent;
+			if (iLength == 1)
+			{
+				// 1e30
+				pExponent = &pBuffer[1];
+			}
+			else
+			{
+				// 1234e30 -> 1.234e33
+				memmove(&pBuffer[2], &pBuffer[1], iLength - 1);
+				pBuffer[1] = '.';
+				pExponent = &pBuffer[iLength + 1];
+			}
+			*pExponent++ = 'e';
+			return WriteInteger(pExponent, iPointPos - 1);
 		}
-		else if (m_eType == E_TYPE_BOOLEAN)
+
+		// pOut need c_iMaxFloatLength chars, fValue must be finite
+		// Digits are rounded to iMaxDigits significant digits when not 0
+		static const size_t c_iMaxFloatLength = 32;
+		// Longest output of WriteFloat, "-0.0000012345678901234567"
+		static const size_t c_iMaxShortestFloatLength = 25;
+		char* WriteFloat(char* pOut, double fValue, int iMaxDigits = 0)
 		{
-			if (m_oValue.Boolean)
+			if (fValue == 0.0)
 			{
-				sOutJson.PushRange("true", 4);
+				uint64_t iBits;
+				memcpy(&iBits, &fValue, sizeof(iBits));
+				if (iBits >> 63)
+					*pOut++ = '-';
+				memcpy(pOut, "0.0", 3);
+				return pOut + 3;
 			}
-			else
+
+			if (fValue < 0.0)
 			{
-				sOutJson.PushRange("false", 5);
+				*pOut++ = '-';
+				fValue = -fValue;
+			}
+
+			int iLength, iK;
+			Grisu2(fValue, pOut, &iLength, &iK);
+
+			if (iMaxDigits > 0 && iLength > iMaxDigits)
+			{
+				const bool bRoundUp = pOut[iMaxDigits] >= '5';
+				iK += iLength - iMaxDigits;
+				iLength = iMaxDigits;
+				if (bRoundUp)
+				{
+					int iDigit = iLength - 1;
+					while (iDigit >= 0 && pOut[iDigit] == '9')
+						pOut[iDigit--] = '0';
+					if (iDigit >= 0)
+					{
+						++pOut[iDigit];
+					}
+					else
+					{
+						// 999 -> 1e3
+						pOut[0] = '1';
+						iK += iLength;
+						iLength = 1;
+					}
+				}
+
+				while (iLength > 1 && pOut[iLength - 1] == '0')
+				{
+					--iLength;
+					++iK;
+				}
 			}
+			return FormatDigits(pOut, iLength, iK);
 		}
-		else if (m_eType == E_TYPE_INTEGER)
+
+		void WriteIntegerValue(CharBuffer& sOutJson, int64_t iValue)
 		{
-			char sBuffer[256];
-			snprintf(sBuffer, 256, "%jd", m_oValue.Integer);
-			size_t iLen = strlen(sBuffer);
-			sOutJson.PushRange(sBuffer, iLen);
+			// Write digits directly in buffer
+			const size_t iSize = sOutJson.Size();
+			sOutJson.Resize(iSize + 20);
+			char* pEnd = WriteInteger(sOutJson.Data() + iSize, iValue);
+			sOutJson.Resize(pEnd - sOutJson.Data());
 		}
-		else if (m_eType == E_TYPE_FLOAT)
+
+		void WriteFloatValue(CharBuffer& sOutJson, double fValue, int iMaxDigits = 0)
 		{
-			if (Internal::IsNaN(m_oValue.Float))
+			if (IsNaN(fValue))
 			{
 				sOutJson.PushRange("NaN", 3);
 			}
-			else if (Internal::IsInfinite(m_oValue.Float))
+			else if (IsInfinite(fValue))
 			{
-				if (m_oValue.Float < 0.f)
+				if (fValue < 0.f)
 					sOutJson.PushRange("-Infinity", 9);
 				else
 					sOutJson.PushRange("Infinity", 8);
 			}
 			else
 			{
-				char sBuffer[256];
-				snprintf(sBuffer, 256, "%.17g", m_oValue.Float);
-				size_t iLen = strlen(sBuffer);
-				sOutJson.PushRange(sBuffer, iLen);
+				const size_t iSize = sOutJson.Size();
+				sOutJson.Resize(iSize + c_iMaxFloatLength);
+				char* pEnd = WriteFloat(sOutJson.Data() + iSize, fValue, iMaxDigits);
+				sOutJson.Resize(pEnd - sOutJson.Data());
 			}
 		}
-		else
+
+		// New line and indentation of pretty printed output
+		struct WriteContext
 		{
-			sOutJson.PushRange("null", 4);
-		}
-	}
+			enum
+			{
+				c_iIndentTableDepth = 32
+			};
+
+			const WriteOptions*	m_pOptions;
+#if defined(STTHM_USE_THREADS)
+			// Lazy childs are allocated in their document, locked when written on several threads
+			std::mutex*			m_pLazyMutex;
+#endif //STTHM_USE_THREADS
+			// New line followed by c_iIndentTableDepth levels of indentation
+			Buffer<char, 256>	m_oIndentTable;
+			size_t				m_iNewLineLength;
+			size_t				m_iIndentWidth;
+			int					m_iMaxDigits;	// Of floats, 0 for shortest
+
+			WriteContext(const WriteOptions& oOptions)
+			{
+				m_pOptions = &oOptions;
+#if defined(STTHM_USE_THREADS)
+				m_pLazyMutex = NULL;
+#endif //STTHM_USE_THREADS
+				m_iNewLineLength = (oOptions.eNewLine == WriteOptions::E_NEWLINE_CRLF) ? 2 : 1;
+				m_iIndentWidth = oOptions.iIndentWidth > 0 ? (size_t)oOptions.iIndentWidth : 0;
+				m_iMaxDigits = 0;
+				if (oOptions.eFloatFormat == WriteOptions::E_FLOAT_SIGNIFICANT)
+					m_iMaxDigits = oOptions.iFloatPrecision < 1 ? 1 : (oOptions.iFloatPrecision > 17 ? 17 : oOptions.iFloatPrecision);
+
+				if (oOptions.bCompact == false)
+				{
+					m_oIndentTable.PushRange("\r\n" + 2 - m_iNewLineLength, m_iNewLineLength);
+					m_oIndentTable.PushRepeat(oOptions.cIndentChar, c_iIndentTableDepth * m_iIndentWidth);
+				}
+			}
 
-#ifdef JsonStthmString
-	void JsonValue::WriteString(JsonStthmString& sOutJson, bool bCompact) const
-	{
-		Internal::CharBuffer oBuffer;
-		Write(oBuffer, 0, bCompact);
-		sOutJson.resize(oBuffer.Size());
-		oBuffer.WriteTo((char*)sOutJson.data());
-	}
-#endif //JsonStthmString
+			void NewLine(CharBuffer& sOutJson, size_t iDepth) const
+			{
+				if (iDepth <= c_iIndentTableDepth)
+				{
+					sOutJson.PushRange(m_oIndentTable.Data(), m_iNewLineLength + iDepth * m_iIndentWidth);
+				}
+				else
+				{
+					sOutJson.PushRange(m_oIndentTable.Data(), m_oIndentTable.Size());
+					sOutJson.PushRepeat(m_pOptions->cIndentChar, (iDepth - c_iIndentTableDepth) * m_iIndentWidth);
+				}
+			}
 
-	char* JsonValue::WriteString(bool bCompact) const
-	{
-		Internal::CharBuffer oBuffer;
-		Write(oBuffer, 0, bCompact);
-		char* pString = (char*)JsonStthmMalloc(oBuffer.Size() + 1);
-		if (pString != NULL)
-		{
-			oBuffer.WriteTo(pString);
-			pString[oBuffer.Size()] = '\0';
-		}
-		return pString;
-	}
+			size_t NewLineSize(size_t iDepth) const
+			{
+				return m_iNewLineLength + iDepth * m_iIndentWidth;
+			}
+		};
 
-	bool JsonValue::WriteFile(const char* pFilename, bool bCompact) const
-	{
-		FILE* pFile = fopen(pFilename, "w");
-		if (NULL != pFile)
+		int CompareMemberNames(const void* pA, const void* pB)
 		{
-			Internal::CharBuffer sJson;
-			Write(sJson, 0, bCompact);
-			bool bRet = fwrite(sJson.Data(), sizeof(char), sJson.Size(), pFile) == (sizeof(char) * sJson.Size());
-			fclose(pFile);
-			return bRet;
+			return strcmp((*(const JsonValue* const*)pA)->GetName(), (*(const JsonValue* const*)pB)->GetName());
 		}
-		return false;
-	}
 
-	int JsonValue::GetMemberCount() const
-	{
-		int iCount = 0;
-		if (m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY)
+		// Output of JsonValue::WriteParallel, in order
+		struct WriteParts
 		{
-			JsonValue* pChild = m_oValue.Childs.m_pFirst;
-			while (pChild != NULL)
+			Buffer<CharBuffer*, 64>	m_oParts;
+
+			~WriteParts()
 			{
-				++iCount;
-				pChild = pChild->m_pNext;
+				for (size_t iPart = 0; iPart < m_oParts.Size(); ++iPart)
+					delete m_oParts.Data()[iPart];
 			}
-		}
-
-		return iCount;
-	}
+
+			CharBuffer& Add()
+			{
+				m_oParts.Push(new CharBuffer());
+				return *m_oParts.Data()[m_oParts.Size() - 1];
+			}
+
+			size_t GetSize() const
+			{
+				size_t iSize = 0;
+				for (size_t iPart = 0; iPart < m_oParts.Size(); ++iPart)
+					iSize += m_oParts.Data()[iPart]->Size();
+				return iSize;
+			}
+		};
+
+		struct ParallelWrite
+		{
+			const JsonValue*		m_pParent;
+			const WriteContext*		m_pContext;
+			const JsonValue* const*	m_pChilds;
+			size_t					m_iChildCount;
+			CharBuffer* const*		m_pChunks;
+			size_t					m_iChunkCount;
+		};
+
+		// FNV-1a
+		inline uint32_t HashString(const char* pString)
+		{
+			uint32_t iHash = 2166136261u;
+			while (*pString != 0)
+			{
+				iHash ^= (unsigned char)*pString++;
+				iHash *= 16777619u;
+			}
+			return iHash;
+		}
+
+		// Indexes are allocated with string functions of allocator, aligned after the offset to the allocation
+		void* AllocMemory(Allocator* pAllocator, size_t iSize, size_t iAlign)
+		{
+			JsonStthmAssert(iAlign > 0 && iAlign <= 128);
+			char* pAlloc = pAllocator->AllocString(iSize + iAlign, pAllocator->pUserData);
+			if (pAlloc == NULL)
+				return NULL;
+			char* pMemory = (char*)(((uintptr_t)pAlloc + iAlign) & ~(uintptr_t)(iAlign - 1));
+			pMemory[-1] = (char)(pMemory - pAlloc);
+			return pMemory;
+		}
+
+		void FreeMemory(Allocator* pAllocator, void* pMemory)
+		{
+			char* pAlloc = (char*)pMemory - (unsigned char)((char*)pMemory)[-1];
+			pAllocator->FreeString(pAlloc, pAllocator->pUserData);
+		}
+
+		//////////////////////////////
+		// Structural index (stage one of JsonDoc::E_PARSE_MODE_STRUCTURAL_INDEX)
+		//////////////////////////////
+
+		struct BlockMasks
+		{
+			uint64_t	iBackslash;
+			uint64_t	iQuote;
+			uint64_t	iSpace;
+			uint64_t	iOperator; // { } [ ] : ,
+		};
+
+#if defined(STTHM_USE_AVX2) || defined(STTHM_USE_SSE2)
+		inline uint32_t OperatorMask16(__m128i vChars)
+		{
+			// '[' | 0x20 == '{' and ']' | 0x20 == '}'
+			const __m128i vLower = _mm_or_si128(vChars, _mm_set1_epi8(0x20));
+			const __m128i vIsBrace = _mm_or_si128(_mm_cmpeq_epi8(vLower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(vLower, _mm_set1_epi8('}')));
+			const __m128i vIsSeparator = _mm_or_si128(_mm_cmpeq_epi8(vChars, _mm_set1_epi8(':')), _mm_cmpeq_epi8(vChars, _mm_set1_epi8(',')));
+			return (uint32_t)_mm_movemask_epi8(_mm_or_si128(vIsBrace, vIsSeparator));
+		}
+#endif //STTHM_USE_AVX2 || STTHM_USE_SSE2
+
+#if defined(STTHM_USE_AVX2)
+		inline uint32_t OperatorMask32(__m256i vChars)
+		{
+			const __m256i vLower = _mm256_or_si256(vChars, _mm256_set1_epi8(0x20));
+			const __m256i vIsBrace = _mm256_or_si256(_mm256_cmpeq_epi8(vLower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(vLower, _mm256_set1_epi8('}')));
+			const __m256i vIsSeparator = _mm256_or_si256(_mm256_cmpeq_epi8(vChars, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(vChars, _mm256_set1_epi8(',')));
+			return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(vIsBrace, vIsSeparator));
+		}
+#endif //STTHM_USE_AVX2
+
+		// Classify 64 chars
+		inline void ClassifyBlock(const char* pBlock, BlockMasks& oMasks)
+		{
+#if defined(STTHM_USE_AVX2)
+			const __m256i vLow = _mm256_loadu_si256((const __m256i*)pBlock);
+			const __m256i vHigh = _mm256_loadu_si256((const __m256i*)(pBlock + 32));
+			oMasks.iBackslash = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vLow, _mm256_set1_epi8('\\')))
+				| ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vHigh, _mm256_set1_epi8('\\'))) << 32);
+			oMasks.iQuote = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vLow, _mm256_set1_epi8('"')))
+				| ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vHigh, _mm256_set1_epi8('"'))) << 32);
+			oMasks.iSpace = (uint64_t)SpaceMask32(vLow) | ((uint64_t)SpaceMask32(vHigh) << 32);
+			oMasks.iOperator = (uint64_t)OperatorMask32(vLow) | ((uint64_t)OperatorMask32(vHigh) << 32);
+#elif defined(STTHM_USE_SSE2)
+			oMasks.iBackslash = 0;
+			oMasks.iQuote = 0;
+			oMasks.iSpace = 0;
+			oMasks.iOperator = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				const __m128i vChars = _mm_loadu_si128((const __m128i*)(pBlock + i * 16));
+				oMasks.iBackslash |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(vChars, _mm_set1_epi8('\\'))) << (i * 16);
+				oMasks.iQuote |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(vChars, _mm_set1_epi8('"'))) << (i * 16);
+				oMasks.iSpace |= (uint64_t)SpaceMask16(vChars) << (i * 16);
+				oMasks.iOperator |= (uint64_t)OperatorMask16(vChars) << (i * 16);
+			}
+#else
+			oMasks.iBackslash = 0;
+			oMasks.iQuote = 0;
+			oMasks.iSpace = 0;
+			oMasks.iOperator = 0;
+			for (int i = 0; i < 64; ++i)
+			{
+				const char cChar = pBlock[i];
+				const uint64_t iBit = (uint64_t)1 << i;
+				if (cChar == '\\')
+					oMasks.iBackslash |= iBit;
+				else if (cChar == '"')
+					oMasks.iQuote |= iBit;
+				else if (IsSpace(cChar))
+					oMasks.iSpace |= iBit;
+				else if (cChar == '{' || cChar == '}' || cChar == '[' || cChar == ']' || cChar == ':' || cChar == ',')
+					oMasks.iOperator |= iBit;
+			}
+#endif
+		}
+
+		inline uint64_t PrefixXor(uint64_t iMask)
+		{
+			iMask ^= iMask << 1;
+			iMask ^= iMask << 2;
+			iMask ^= iMask << 4;
+			iMask ^= iMask << 8;
+			iMask ^= iMask << 16;
+			iMask ^= iMask << 32;
+			return iMask;
+		}
+
+		// Fill oIndex with offsets of structural chars ({ } [ ] : , and opening quotes) and of the first char of each scalar value
+		// Unterminated strings are reported by stage two only when reached, like the recursive parser
+		void BuildStructuralIndex(const char* pJson, const char* pEnd, Buffer<uint32_t>& oIndex)
+		{
+			const size_t iLength = pEnd - pJson;
+
+			uint64_t iPreviousEscaped = 0;		// First char of block is escaped
+			uint64_t iPreviousInString = 0;		// All ones when block start inside a string
+			uint64_t iPreviousScalar = 0;		// Last char of previous block is part of a scalar
+
+			char pTail[64];
+			for (size_t iOffset = 0; iOffset < iLength; iOffset += 64)
+			{
+				const char* pBlock = pJson + iOffset;
+				if (iLength - iOffset < 64)
+				{
+					// Pad last block with spaces
+					memset(pTail, ' ', 64);
+					memcpy(pTail, pBlock, iLength - iOffset);
+					pBlock = pTail;
+				}
+
+				BlockMasks oMasks;
+				ClassifyBlock(pBlock, oMasks);
+
+				// Find escaped chars, backslashes are rare enough to walk them one by one
+				uint64_t iEscaped = iPreviousEscaped;
+				iPreviousEscaped = 0;
+				uint64_t iBackslash = oMasks.iBackslash & ~iEscaped;
+				while (iBackslash != 0)
+				{
+					int iBit = CountTrailingZeros64(iBackslash);
+					if (iBit == 63)
+						iPreviousEscaped = 1;
+					else
+						iEscaped |= (uint64_t)1 << (iBit + 1);
+					// Next char is escaped, so can't start a new escape sequence
+					iBackslash &= ~(((uint64_t)2 << iBit) | ((uint64_t)1 << iBit));
+				}
+
+				const uint64_t iQuote = oMasks.iQuote & ~iEscaped;
+				// Bits are set from opening quote to closing quote (excluded)
+				const uint64_t iInString = PrefixXor(iQuote) ^ iPreviousInString;
+				iPreviousInString = (uint64_t)((int64_t)iInString >> 63);
+
+				const uint64_t iScalar = ~(oMasks.iSpace | oMasks.iOperator | iQuote | iInString);
+				const uint64_t iScalarStart = iScalar & ~((iScalar << 1) | iPreviousScalar);
+				iPreviousScalar = iScalar >> 63;
+
+				uint64_t iStructurals = (oMasks.iOperator & ~iInString) | (iQuote & iInString) | iScalarStart;
+
+				size_t iCount = oIndex.Size();
+				oIndex.Resize(iCount + 64);
+				uint32_t* pOut = oIndex.Data() + iCount;
+				while (iStructurals != 0)
+				{
+					*pOut++ = (uint32_t)(iOffset + CountTrailingZeros64(iStructurals));
+					iStructurals &= iStructurals - 1;
+				}
+				oIndex.Resize(pOut - oIndex.Data());
+			}
+		}
+
+		inline uint64_t ReadBigEndian(const uint8_t* pData, int iBytes)
+		{
+			uint64_t iValue = 0;
+			for (int iByte = 0; iByte < iBytes; ++iByte)
+				iValue = (iValue << 8) | pData[iByte];
+			return iValue;
+		}
+
+		inline void WriteMsgPackTag(CharBuffer& oOut, uint8_t iTag, uint64_t iValue, int iBytes)
+		{
+			size_t iSize = oOut.Size();
+			oOut.Resize(iSize + 1 + iBytes);
+			uint8_t* pOut = (uint8_t*)oOut.Data() + iSize;
+			pOut[0] = iTag;
+			for (int iByte = iBytes; iByte > 0; --iByte)
+			{
+				pOut[iByte] = (uint8_t)iValue;
+				iValue >>= 8;
+			}
+		}
+
+		// Smallest header for a string, array or map, iTag8 is 0 when there is no 8 bits format
+		inline void WriteMsgPackHeader(CharBuffer& oOut, uint8_t iFixTag, size_t iFixCount, uint8_t iTag8, uint8_t iTag16, uint8_t iTag32, size_t iCount)
+		{
+			if (iCount < iFixCount)
+				oOut += (char)(iFixTag | iCount);
+			else if (iTag8 != 0 && iCount <= 0xFF)
+				WriteMsgPackTag(oOut, iTag8, iCount, 1);
+			else if (iCount <= 0xFFFF)
+				WriteMsgPackTag(oOut, iTag16, iCount, 2);
+			else
+				WriteMsgPackTag(oOut, iTag32, iCount, 4);
+		}
+
+		inline void WriteMsgPackString(CharBuffer& oOut, const char* pString)
+		{
+			size_t iLength = (pString != NULL) ? strlen(pString) : 0;
+			WriteMsgPackHeader(oOut, 0xA0, 32, 0xD9, 0xDA, 0xDB, iLength);
+			oOut.PushRange(pString, iLength);
+		}
+
+		// Length of a string header, false if pData is not a string
+		inline bool ReadMsgPackStringLength(const uint8_t*& pData, const uint8_t* pEnd, size_t& iLength)
+		{
+			if (pData >= pEnd)
+				return false;
+
+			const uint8_t iTag = *pData;
+			int iBytes;
+			if ((iTag & 0xE0) == 0xA0)
+				iBytes = 0;
+			else if (iTag >= 0xD9 && iTag <= 0xDB)
+				iBytes = 1 << (iTag - 0xD9);
+			else
+				return false;
+
+			if ((size_t)(pEnd - pData) < (size_t)(1 + iBytes))
+				return false;
+
+			iLength = (iBytes == 0) ? (iTag & 0x1F) : (size_t)ReadBigEndian(pData + 1, iBytes);
+			if ((size_t)(pEnd - pData - 1 - iBytes) < iLength)
+				return false;
+
+			pData += 1 + iBytes;
+			return true;
+		}
+	}
+
+	//////////////////////////////
+	// JsonValue::Iterator
+	//////////////////////////////
+
+	JsonValue::Iterator::Iterator(const JsonValue* pJson)
+	{
+		if (pJson != NULL && pJson->IsContainer())
+		{
+			pJson->LoadLazyChilds();
+			m_pChild = pJson->m_oValue.Childs.m_pFirst;
+		}
+		else
+		{
+			m_pChild = NULL;
+		}
+	}
+
+	JsonValue::Iterator::Iterator(const Iterator& oIt)
+	{
+		m_pChild = oIt.m_pChild;
+	}
+
+	bool JsonValue::Iterator::IsValid() const
+	{
+		return m_pChild != NULL;
+	}
+
+	bool JsonValue::Iterator::operator!=(const Iterator& oIte) const
+	{
+		return m_pChild != oIte.m_pChild;
+	}
+
+	void JsonValue::Iterator::operator++()
+	{
+		if (m_pChild != NULL)
+			m_pChild = m_pChild->m_pNext;
+	}
+
+	const JsonValue& JsonValue::Iterator::operator*() const
+	{
+		return m_pChild != NULL ? *m_pChild : INVALID;
+	}
+
+	const JsonValue* JsonValue::Iterator::operator->() const
+	{
+		return m_pChild;
+	}
+
+	JsonValue::Iterator::operator const JsonValue&() const
+	{
+		return m_pChild != NULL ? *m_pChild : INVALID;
+	}
+
+	//////////////////////////////
+	// JsonValue
+	//////////////////////////////
+
+	JsonValue JsonValue::INVALID;
+
+	Allocator JsonValue::s_oDefaultAllocator = {
+		JsonValue::DefaultAllocatorCreateJsonValue,
+		JsonValue::DefaultAllocatorDeleteJsonValue,
+		JsonValue::DefaultAllocatorAllocString,
+		JsonValue::DefaultAllocatorFreeString,
+		NULL
+	};
+
+	JsonValue::JsonValue(Allocator* pAllocator)
+		: m_pAllocator(pAllocator)
+		, m_eType(E_TYPE_NULL)
+		, m_iFlags(0)
+		, m_pName(NULL)
+		, m_pNext(NULL)
+	{
+		JsonStthmAssert(m_pAllocator != NULL);
+	}
+
+	JsonValue::JsonValue()
+		: m_pAllocator(&s_oDefaultAllocator)
+		, m_eType(E_TYPE_NULL)
+		, m_iFlags(0)
+		, m_pName(NULL)
+		, m_pNext(NULL)
+	{
+	}
+
+	JsonValue::JsonValue(const JsonValue& oSource)
+		: m_pAllocator(&s_oDefaultAllocator)
+		, m_eType(E_TYPE_NULL)
+		, m_iFlags(0)
+		, m_pName(NULL)
+		, m_pNext(NULL)
+	{
+		*this = oSource;
+	}
+
+#if defined(STTHM_USE_MOVE)
+	JsonValue::JsonValue(JsonValue&& oSource)
+		: m_pAllocator(oSource.m_pAllocator)
+		, m_eType(E_TYPE_NULL)
+		, m_iFlags(0)
+		, m_pName(NULL)
+		, m_pNext(NULL)
+	{
+		MoveFrom(oSource);
+	}
+#endif //STTHM_USE_MOVE
+
+	JsonValue::JsonValue(bool bValue)
+		: m_pAllocator(&s_oDefaultAllocator)
+		, m_eType(E_TYPE_NULL)
+		, m_iFlags(0)
+		, m_pName(NULL)
+		, m_pNext(NULL)
+	{
+		*this = bValue;
+	}
+
+#ifdef JsonStthmString
+	JsonValue::JsonValue(const JsonStthmString& sValue)
+		: m_pAllocator(&s_oDefaultAllocator)
+		, m_eType(E_TYPE_NULL)
+		, m_iFlags(0)
+		, m_pName(NULL)
+		, m_pNext(NULL)
+	{
+		*this = sValue;
+	}
+#endif //JsonStthmString
+
+	JsonValue::JsonValue(const char* pValue)
+		: m_pAllocator(&s_oDefaultAllocator)
+		, m_eType(E_TYPE_NULL)
+		, m_iFlags(0)
+		, m_pName(NULL)
+		, m_pNext(NULL)
+	{
+		*this = pValue;
+	}
+
+	JsonValue::JsonValue(int64_t iValue)
+		: m_pAllocator(&s_oDefaultAllocator)
+		, m_eType(E_TYPE_NULL)
+		, m_iFlags(0)
+		, m_pName(NULL)
+		, m_pNext(NULL)
+	{
+		*this = iValue;
+	}
+
+	JsonValue::JsonValue(double fValue)
+		: m_pAllocator(&s_oDefaultAllocator)
+		, m_eType(E_TYPE_NULL)
+		, m_iFlags(0)
+		, m_pName(NULL)
+		, m_pNext(NULL)
+	{
+		*this = fValue;
+	}
+
+	JsonValue::~JsonValue()
+	{
+		if (m_pName != NULL)
+		{
+			m_pAllocator->FreeString(m_pName, m_pAllocator->pUserData);
+			m_pName = NULL;
+		}
+		Reset();
+	}
+
+	void JsonValue::InitType(EType eType)
+	{
+		if (m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY || m_eType == E_TYPE_STRING)
+			Reset();
+
+		if (m_eType != eType)
+		{
+			m_eType = eType;
+			switch (eType)
+			{
+			case E_TYPE_OBJECT:
+			case E_TYPE_ARRAY:
+				m_oValue.Childs.m_pFirst = NULL;
+				m_oValue.Childs.m_pLast = NULL;
+				break;
+			case E_TYPE_STRING:
+				m_oValue.String = NULL;
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	void JsonValue::Reset()
+	{
+		if (m_iFlags & E_FLAG_LAZY)
+		{
+			// Childs were never created
+			m_iFlags &= ~E_FLAG_LAZY;
+			m_eType = E_TYPE_NULL;
+			return;
+		}
+
+		switch (m_eType)
+		{
+		case E_TYPE_OBJECT:
+		case E_TYPE_ARRAY:
+		{
+			JsonValue* pChild = m_oValue.Childs.m_pFirst;
+			while (pChild != NULL)
+			{
+				JsonValue* pTemp = pChild->m_pNext;
+				m_pAllocator->DeleteJsonValue(pChild, m_pAllocator->pUserData);
+				pChild = pTemp;
+			}
+			if (m_iFlags & E_FLAG_INDEXED)
+			{
+				Internal::FreeMemory(m_pAllocator, m_oValue.Childs.m_pIndex);
+				m_iFlags &= ~E_FLAG_INDEXED;
+			}
+			m_oValue.Childs.m_pFirst = NULL;
+			m_oValue.Childs.m_pLast = NULL;
+			break;
+		}
+		case E_TYPE_STRING:
+		{
+			m_pAllocator->FreeString(m_oValue.String, m_pAllocator->pUserData);
+			m_oValue.String = NULL;
+			break;
+		}
+		default:
+			break;
+		}
+		m_eType = E_TYPE_NULL;
+	}
+
+	JsonValue::EType JsonValue::GetType() const
+	{
+		return m_eType;
+	}
+
+	void JsonValue::SetStringValue(const char* pString, const char* pEnd)
+	{
+		JsonStthmAssert(IsString());
+		m_pAllocator->FreeString(m_oValue.String, m_pAllocator->pUserData);
+		m_oValue.String = NULL;
+		if (NULL != pString)
+		{
+			JsonStthmAssert(pEnd == NULL || pEnd >= pString);
+			size_t iLen = (pEnd != NULL) ? (pEnd - pString) : strlen(pString);
+			char* pNewString = m_pAllocator->AllocString(iLen + 1, m_pAllocator->pUserData);
+			memcpy(pNewString, pString, iLen);
+			pNewString[iLen] = 0;
+			m_oValue.String = pNewString;
+		}
+	}
+
+	int JsonValue::ReadString(const char* pJson, const char* pJsonEnd)
+	{
+		if (pJson != NULL)
+		{
+			Reset();
+			if (pJsonEnd == NULL)
+			{
+				pJsonEnd = pJson + strlen(pJson);
+			}
+			const char* pEnd = pJson;
+			if (Parse(pEnd, pJsonEnd) == false)
+			{
+				return Internal::GetErrorLine(pJson, pJsonEnd, pEnd);
+			}
+			return 0;
+		}
+		return -1;
+	}
+
+	int JsonValue::ReadFile(const char* pFilename)
+	{
+		char* pString;
+		size_t iSize;
+		bool bMapped;
+		int iError = Internal::ReadFileContent(pFilename, &pString, &iSize, true, &bMapped);
+		if (iError != 0)
+			return iError;
+
+		Reset();
+		int iLine = ReadString(pString, pString + iSize);
+
+		Internal::FreeFileContent(pString, iSize, bMapped);
+		return iLine;
+	}
+
+	void JsonValue::Write(Internal::CharBuffer& sOutJson, size_t iIndent, bool bCompact) const
+	{
+		const WriteOptions oOptions(bCompact);
+		const Internal::WriteContext oContext(oOptions);
+		WriteValue(sOutJson, oContext, iIndent);
+	}
+
+	void JsonValue::Write(Internal::CharBuffer& sOutJson, const WriteOptions& oOptions) const
+	{
+		Internal::WriteContext oContext(oOptions);
+		Internal::WriteParts oParts;
+		if (WriteParallel(oContext, oParts))
+		{
+			if (sOutJson.Size() + oParts.GetSize() > sOutJson.Capacity())
+				sOutJson.Reserve(sOutJson.Size() + oParts.GetSize());
+			for (size_t iPart = 0; iPart < oParts.m_oParts.Size(); ++iPart)
+				sOutJson.PushRange(oParts.m_oParts.Data()[iPart]->Data(), oParts.m_oParts.Data()[iPart]->Size());
+			return;
+		}
+		WriteSerial(sOutJson, oContext);
+	}
+
+	void JsonValue::WriteSerial(Internal::CharBuffer& sOutJson, const Internal::WriteContext& oContext) const
+	{
+		// Size hint only, buffer still grows when output is bigger
+		const size_t iReserveSize = oContext.m_pOptions->iReserveSize;
+		if (iReserveSize > 0 && sOutJson.Size() + iReserveSize > sOutJson.Capacity())
+			sOutJson.Reserve(sOutJson.Size() + iReserveSize);
+		WriteValue(sOutJson, oContext, 0);
+	}
+
+	bool JsonValue::WriteParallel(Internal::WriteContext& oContext, Internal::WriteParts& oParts) const
+	{
+		// Several chunks per thread to balance childs of different sizes, but not too small ones
+		const size_t c_iMinChunkChilds = 512;
+		const WriteOptions& oOptions = *oContext.m_pOptions;
+		const size_t iThreadCount = (oOptions.iThreadCount > 0) ? (size_t)oOptions.iThreadCount : Internal::GetThreadCount();
+		if (iThreadCount <= 1 || IsContainer() == false || (size_t)GetMemberCount() < 2 * c_iMinChunkChilds)
+			return false;
+
+		Internal::Buffer<const JsonValue*, 64> oChilds;
+		oChilds.Reserve((size_t)GetMemberCount());
+		for (const JsonValue* pChild = m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+			oChilds.Push(pChild);
+		if (m_eType == E_TYPE_OBJECT && oOptions.bSortKeys)
+			qsort(oChilds.Data(), oChilds.Size(), sizeof(const JsonValue*), Internal::CompareMemberNames);
+
+		size_t iChunkCount = iThreadCount * 4;
+		if (iChunkCount > oChilds.Size() / c_iMinChunkChilds)
+			iChunkCount = oChilds.Size() / c_iMinChunkChilds;
+
+		oParts.Add() += (m_eType == E_TYPE_OBJECT) ? '{' : '[';
+		for (size_t iChunk = 0; iChunk < iChunkCount; ++iChunk)
+			oParts.Add();
+		Internal::CharBuffer& oEnd = oParts.Add();
+		if (oOptions.bCompact == false)
+			oContext.NewLine(oEnd, 0);
+		oEnd += (m_eType == E_TYPE_OBJECT) ? '}' : ']';
+
+		Internal::ParallelWrite oWrite;
+		oWrite.m_pParent = this;
+		oWrite.m_pContext = &oContext;
+		oWrite.m_pChilds = oChilds.Data();
+		oWrite.m_iChildCount = oChilds.Size();
+		oWrite.m_pChunks = oParts.m_oParts.Data() + 1;
+		oWrite.m_iChunkCount = iChunkCount;
+
+#if defined(STTHM_USE_THREADS)
+		std::mutex oLazyMutex;
+		oContext.m_pLazyMutex = &oLazyMutex;
+#endif //STTHM_USE_THREADS
+		Internal::RunWorkers(iThreadCount < iChunkCount ? iThreadCount : iChunkCount, &JsonValue::WriteParallelChunks, &oWrite);
+#if defined(STTHM_USE_THREADS)
+		oContext.m_pLazyMutex = NULL;
+#endif //STTHM_USE_THREADS
+		return true;
+	}
+
+	void JsonValue::WriteParallelChunks(size_t iWorker, size_t iWorkerCount, void* pUserData)
+	{
+		// Chunks are shared round robin, like JsonLinesDoc::ParseChunks
+		const Internal::ParallelWrite* pWrite = (const Internal::ParallelWrite*)pUserData;
+		for (size_t iChunk = iWorker; iChunk < pWrite->m_iChunkCount; iChunk += iWorkerCount)
+		{
+			const size_t iBegin = pWrite->m_iChildCount * iChunk / pWrite->m_iChunkCount;
+			const size_t iEnd = pWrite->m_iChildCount * (iChunk + 1) / pWrite->m_iChunkCount;
+			Internal::CharBuffer& oOut = *pWrite->m_pChunks[iChunk];
+			for (size_t iChild = iBegin; iChild < iEnd; ++iChild)
+				pWrite->m_pParent->WriteChild(oOut, *pWrite->m_pContext, pWrite->m_pChilds[iChild], 0, iChild == 0);
+		}
+	}
+
+	void JsonValue::WriteChild(Internal::CharBuffer& sOutJson, const Internal::WriteContext& oContext, const JsonValue* pChild, size_t iDepth, bool bFirst) const
+	{
+		const bool bCompact = oContext.m_pOptions->bCompact;
+		if (bFirst == false)
+			sOutJson += ',';
+
+		if (bCompact == false)
+			oContext.NewLine(sOutJson, iDepth + 1);
+
+		if (m_eType == E_TYPE_OBJECT)
+		{
+			sOutJson += '\"';
+			WriteStringEscaped(sOutJson, pChild->m_pName);
+			sOutJson += '\"';
+			sOutJson += ':';
+			if (bCompact == false)
+				sOutJson += ' ';
+		}
+
+		pChild->WriteValue(sOutJson, oContext, iDepth + 1);
+	}
+
+	void JsonValue::WriteValue(Internal::CharBuffer& sOutJson, const Internal::WriteContext& oContext, size_t iDepth) const
+	{
+#if defined(STTHM_USE_THREADS)
+		if ((m_iFlags & E_FLAG_LAZY) && oContext.m_pLazyMutex != NULL)
+		{
+			std::lock_guard<std::mutex> oLock(*oContext.m_pLazyMutex);
+			LoadLazyChilds();
+		}
+#endif //STTHM_USE_THREADS
+		LoadLazyChilds();
+
+		const bool bCompact = oContext.m_pOptions->bCompact;
+		if (m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY)
+		{
+			const bool bObject = m_eType == E_TYPE_OBJECT;
+			sOutJson += bObject ? '{' : '[';
+
+			// Sorted members are written from a table of childs
+			Internal::Buffer<const JsonValue*, 64> oSorted(0);
+			if (bObject && oContext.m_pOptions->bSortKeys)
+			{
+				for (const JsonValue* pChild = m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+					oSorted.Push(pChild);
+				qsort(oSorted.Data(), oSorted.Size(), sizeof(const JsonValue*), Internal::CompareMemberNames);
+			}
+
+			const JsonValue* pChild = m_oValue.Childs.m_pFirst;
+			size_t iSorted = 0;
+			if (oSorted.Size() > 0)
+				pChild = oSorted.Data()[iSorted++];
+
+			bool bFirst = true;
+			while (pChild != NULL)
+			{
+				WriteChild(sOutJson, oContext, pChild, iDepth, bFirst);
+				bFirst = false;
+
+				if (oSorted.Size() > 0)
+					pChild = (iSorted < oSorted.Size()) ? oSorted.Data()[iSorted++] : NULL;
+				else
+					pChild = pChild->m_pNext;
+			}
+
+			if (bCompact == false)
+				oContext.NewLine(sOutJson, iDepth);
+
+			sOutJson += bObject ? '}' : ']';
+		}
+		else if (m_eType == E_TYPE_STRING)
+		{
+			sOutJson += '\"';
+			WriteStringEscaped(sOutJson, m_oValue.String);
+			sOutJson += '\"';
+		}
+		else if (m_eType == E_TYPE_BOOLEAN)
+		{
+			if (m_oValue.Boolean)
+			{
+				sOutJson.PushRange("true", 4);
+			}
+			else
+			{
+				sOutJson.PushRange("false", 5);
+			}
+		}
+		else if (m_eType == E_TYPE_INTEGER)
+		{
+			Internal::WriteIntegerValue(sOutJson, m_oValue.Integer);
+		}
+		else if (m_eType == E_TYPE_FLOAT)
+		{
+			Internal::WriteFloatValue(sOutJson, m_oValue.Float, oContext.m_iMaxDigits);
+		}
+		else
+		{
+			sOutJson.PushRange("null", 4);
+		}
+	}
+
+	size_t JsonValue::EstimateWriteSize(const WriteOptions& oOptions) const
+	{
+		const Internal::WriteContext oContext(oOptions);
+		size_t iLongestString = 0;
+		return EstimateSize(oContext, 0, iLongestString);
+	}
+
+	size_t JsonValue::EstimateSize(const Internal::WriteContext& oContext, size_t iDepth, size_t& iLongestString) const
+	{
+		LoadLazyChilds();
+
+		switch (m_eType)
+		{
+		case E_TYPE_OBJECT:
+		case E_TYPE_ARRAY:
+			{
+				const bool bCompact = oContext.m_pOptions->bCompact;
+				size_t iSize = 2;
+				size_t iCount = 0;
+				for (const JsonValue* pChild = m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+				{
+					if (m_eType == E_TYPE_OBJECT)
+					{
+						// Quotes and colon, space after colon
+						const size_t iNameLength = strlen(pChild->m_pName);
+						if (iNameLength > iLongestString)
+							iLongestString = iNameLength;
+						iSize += iNameLength + 3 + (bCompact ? 0 : 1);
+					}
+					iSize += pChild->EstimateSize(oContext, iDepth + 1, iLongestString);
+					++iCount;
+				}
+
+				if (iCount > 0)
+					iSize += iCount - 1;
+				if (bCompact == false)
+					iSize += iCount * oContext.NewLineSize(iDepth + 1) + oContext.NewLineSize(iDepth);
+				return iSize;
+			}
+		case E_TYPE_STRING:
+			{
+				const size_t iLength = strlen(m_oValue.String);
+				if (iLength > iLongestString)
+					iLongestString = iLength;
+				return iLength + 2;
+			}
+		case E_TYPE_BOOLEAN:
+			return m_oValue.Boolean ? 4 : 5;
+		case E_TYPE_INTEGER:
+			{
+				uint64_t iAbsValue = (uint64_t)m_oValue.Integer;
+				size_t iLength = 1;
+				if (m_oValue.Integer < 0)
+				{
+					iAbsValue = 0 - iAbsValue;
+					++iLength;
+				}
+				for (; iAbsValue >= 10; iAbsValue /= 10)
+					++iLength;
+				return iLength;
+			}
+		case E_TYPE_FLOAT:
+			if (Internal::IsNaN(m_oValue.Float) || Internal::IsInfinite(m_oValue.Float))
+				return 9;
+			// Sign, point, exponent and leading zeros of shortest format
+			if (oContext.m_iMaxDigits > 0)
+				return oContext.m_iMaxDigits + 8;
+			return Internal::c_iMaxShortestFloatLength;
+		default:
+			return 4;
+		}
+	}
+
+#ifdef JsonStthmString
+	void JsonValue::WriteString(JsonStthmString& sOutJson, bool bCompact) const
+	{
+		WriteString(sOutJson, WriteOptions(bCompact));
+	}
+
+	void JsonValue::WriteString(JsonStthmString& sOutJson, const WriteOptions& oOptions) const
+	{
+		Internal::WriteContext oContext(oOptions);
+		Internal::WriteParts oParts;
+		if (WriteParallel(oContext, oParts))
+		{
+			// Parts are copied once in the string
+			sOutJson.resize(oParts.GetSize());
+			char* pOut = (char*)sOutJson.data();
+			for (size_t iPart = 0; iPart < oParts.m_oParts.Size(); ++iPart)
+			{
+				oParts.m_oParts.Data()[iPart]->WriteTo(pOut);
+				pOut += oParts.m_oParts.Data()[iPart]->Size();
+			}
+			return;
+		}
+
+		Internal::CharBuffer oBuffer;
+		WriteSerial(oBuffer, oContext);
+		sOutJson.resize(oBuffer.Size());
+		oBuffer.WriteTo((char*)sOutJson.data());
+	}
+#endif //JsonStthmString
+
+	char* JsonValue::WriteString(bool bCompact) const
+	{
+		Internal::CharBuffer oBuffer;
+		Write(oBuffer, WriteOptions(bCompact));
+		char* pString = (char*)JsonStthmMalloc(oBuffer.Size() + 1);
+		if (pString != NULL)
+		{
+			oBuffer.WriteTo(pString);
+			pString[oBuffer.Size()] = '\0';
+		}
+		return pString;
+	}
+
+	bool JsonValue::WriteFile(const char* pFilename, bool bCompact) const
+	{
+		return WriteFile(pFilename, WriteOptions(bCompact));
+	}
+
+	bool JsonValue::WriteFile(const char* pFilename, const WriteOptions& oOptions) const
+	{
+		FILE* pFile = fopen(pFilename, "w");
+		if (NULL != pFile)
+		{
+			Internal::WriteContext oContext(oOptions);
+			Internal::WriteParts oParts;
+			bool bRet = true;
+			if (WriteParallel(oContext, oParts))
+			{
+				// Parts are written one after the other instead of being joined
+				for (size_t iPart = 0; iPart < oParts.m_oParts.Size() && bRet; ++iPart)
+				{
+					const Internal::CharBuffer& oPart = *oParts.m_oParts.Data()[iPart];
+					bRet = fwrite(oPart.Data(), sizeof(char), oPart.Size(), pFile) == (sizeof(char) * oPart.Size());
+				}
+			}
+			else
+			{
+				Internal::CharBuffer sJson;
+				WriteSerial(sJson, oContext);
+				bRet = fwrite(sJson.Data(), sizeof(char), sJson.Size(), pFile) == (sizeof(char) * sJson.Size());
+			}
+			fclose(pFile);
+			return bRet;
+		}
+		return false;
+	}
+
+	int JsonValue::ReadMsgPack(const void* pData, size_t iSize)
+	{
+		if (pData == NULL)
+			return -1;
+
+		Reset();
+		const uint8_t* pCursor = (const uint8_t*)pData;
+		if (ParseMsgPack(pCursor, pCursor + iSize) == false || pCursor != (const uint8_t*)pData + iSize)
+			return (int)(pCursor - (const uint8_t*)pData) + 1;
+		return 0;
+	}
+
+	bool JsonValue::ParseMsgPack(const uint8_t*& pData, const uint8_t* pEnd)
+	{
+		if (pData >= pEnd)
+			return false;
+
+		const uint8_t iTag = *pData;
+
+		// Positive and negative fixint
+		if (iTag <= 0x7F || iTag >= 0xE0)
+		{
+			InitType(E_TYPE_INTEGER);
+			m_oValue.Integer = (iTag <= 0x7F) ? (int64_t)iTag : (int64_t)(int8_t)iTag;
+			++pData;
+			return true;
+		}
+
+		if ((iTag & 0xE0) == 0xA0 || (iTag >= 0xD9 && iTag <= 0xDB))
+		{
+			size_t iLength;
+			if (Internal::ReadMsgPackStringLength(pData, pEnd, iLength) == false)
+				return false;
+			InitType(E_TYPE_STRING);
+			SetStringValue((const char*)pData, (const char*)pData + iLength);
+			pData += iLength;
+			return true;
+		}
+
+		// Containers, count is followed by at least one byte by element
+		size_t iCount = 0;
+		bool bObject = false;
+		int iBytes = -1;
+		if ((iTag & 0xF0) == 0x90 || (iTag & 0xF0) == 0x80)
+		{
+			iCount = iTag & 0x0F;
+			bObject = (iTag & 0xF0) == 0x80;
+			iBytes = 0;
+		}
+		else if (iTag >= 0xDC && iTag <= 0xDF)
+		{
+			bObject = iTag >= 0xDE;
+			iBytes = (iTag & 1) ? 4 : 2;
+		}
+
+		if (iBytes >= 0)
+		{
+			if ((size_t)(pEnd - pData) < (size_t)(1 + iBytes))
+				return false;
+			if (iBytes > 0)
+				iCount = (size_t)Internal::ReadBigEndian(pData + 1, iBytes);
+			if ((size_t)(pEnd - pData - 1 - iBytes) < iCount)
+				return false;
+			pData += 1 + iBytes;
+
+			InitType(bObject ? E_TYPE_OBJECT : E_TYPE_ARRAY);
+			for (size_t iChild = 0; iChild < iCount; ++iChild)
+			{
+				size_t iNameLength = 0;
+				const uint8_t* pName = NULL;
+				if (bObject)
+				{
+					if (Internal::ReadMsgPackStringLength(pData, pEnd, iNameLength) == false)
+						return false;
+					pName = pData;
+					pData += iNameLength;
+				}
+
+				JsonValue* pNewValue = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+				if (pNewValue->ParseMsgPack(pData, pEnd) == false)
+				{
+					m_pAllocator->DeleteJsonValue(pNewValue, m_pAllocator->pUserData);
+					return false;
+				}
+
+				if (bObject)
+				{
+					char* pNewName = m_pAllocator->AllocString(iNameLength + 1, m_pAllocator->pUserData);
+					memcpy(pNewName, pName, iNameLength);
+					pNewName[iNameLength] = 0;
+					pNewValue->m_pName = pNewName;
+				}
+
+				if (m_oValue.Childs.m_pFirst == NULL)
+					m_oValue.Childs.m_pFirst = pNewValue;
+				else
+					m_oValue.Childs.m_pLast->m_pNext = pNewValue;
+				m_oValue.Childs.m_pLast = pNewValue;
+			}
+			IndexChilds((uint32_t)iCount);
+			return true;
+		}
+
+		switch (iTag)
+		{
+		case 0xC0:
+			InitType(E_TYPE_NULL);
+			++pData;
+			return true;
+		case 0xC2:
+		case 0xC3:
+			InitType(E_TYPE_BOOLEAN);
+			m_oValue.Boolean = iTag == 0xC3;
+			++pData;
+			return true;
+		case 0xCA: // float 32
+		case 0xCB: // float 64
+			{
+				iBytes = (iTag == 0xCA) ? 4 : 8;
+				if (pEnd - pData < 1 + iBytes)
+					return false;
+				uint64_t iBits = Internal::ReadBigEndian(pData + 1, iBytes);
+				InitType(E_TYPE_FLOAT);
+				if (iTag == 0xCA)
+				{
+					uint32_t iBits32 = (uint32_t)iBits;
+					float fValue;
+					memcpy(&fValue, &iBits32, sizeof(fValue));
+					m_oValue.Float = fValue;
+				}
+				else
+				{
+					memcpy(&m_oValue.Float, &iBits, sizeof(m_oValue.Float));
+				}
+				pData += 1 + iBytes;
+				return true;
+			}
+		case 0xCC: // uint 8 to 64
+		case 0xCD:
+		case 0xCE:
+		case 0xCF:
+		case 0xD0: // int 8 to 64
+		case 0xD1:
+		case 0xD2:
+		case 0xD3:
+			{
+				iBytes = 1 << (iTag & 3);
+				if (pEnd - pData < 1 + iBytes)
+					return false;
+				uint64_t iValue = Internal::ReadBigEndian(pData + 1, iBytes);
+				if (iTag >= 0xD0)
+				{
+					// Sign extension
+					const int iShift = 64 - iBytes * 8;
+					InitType(E_TYPE_INTEGER);
+					m_oValue.Integer = (int64_t)(iValue << iShift) >> iShift;
+				}
+				else if (iValue > (uint64_t)0x7FFFFFFFFFFFFFFFull)
+				{
+					// Same as text parser for too large integers
+					InitType(E_TYPE_FLOAT);
+					m_oValue.Float = (double)iValue;
+				}
+				else
+				{
+					InitType(E_TYPE_INTEGER);
+					m_oValue.Integer = (int64_t)iValue;
+				}
+				pData += 1 + iBytes;
+				return true;
+			}
+		}
+
+		// Binary, extensions and never used 0xC1
+		return false;
+	}
+
+	void JsonValue::WriteMsgPack(Internal::CharBuffer& oOut) const
+	{
+		LoadLazyChilds();
+
+		switch (m_eType)
+		{
+		case E_TYPE_OBJECT:
+		case E_TYPE_ARRAY:
+			{
+				const size_t iCount = (size_t)GetMemberCount();
+				if (m_eType == E_TYPE_OBJECT)
+					Internal::WriteMsgPackHeader(oOut, 0x80, 16, 0, 0xDE, 0xDF, iCount);
+				else
+					Internal::WriteMsgPackHeader(oOut, 0x90, 16, 0, 0xDC, 0xDD, iCount);
+
+				for (const JsonValue* pChild = m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+				{
+					if (m_eType == E_TYPE_OBJECT)
+						Internal::WriteMsgPackString(oOut, pChild->m_pName);
+					pChild->WriteMsgPack(oOut);
+				}
+				break;
+			}
+		case E_TYPE_STRING:
+			Internal::WriteMsgPackString(oOut, m_oValue.String);
+			break;
+		case E_TYPE_BOOLEAN:
+			oOut += (char)(m_oValue.Boolean ? 0xC3 : 0xC2);
+			break;
+		case E_TYPE_INTEGER:
+			{
+				const int64_t iValue = m_oValue.Integer;
+				if (iValue >= -32 && iValue <= 0x7F)
+					oOut += (char)(uint8_t)iValue;
+				else if (iValue >= 0)
+				{
+					if (iValue <= 0xFF)
+						Internal::WriteMsgPackTag(oOut, 0xCC, iValue, 1);
+					else if (iValue <= 0xFFFF)
+						Internal::WriteMsgPackTag(oOut, 0xCD, iValue, 2);
+					else if (iValue <= 0xFFFFFFFFll)
+						Internal::WriteMsgPackTag(oOut, 0xCE, iValue, 4);
+					else
+						Internal::WriteMsgPackTag(oOut, 0xCF, iValue, 8);
+				}
+				else
+				{
+					if (iValue >= -128)
+						Internal::WriteMsgPackTag(oOut, 0xD0, (uint64_t)iValue, 1);
+					else if (iValue >= -32768)
+						Internal::WriteMsgPackTag(oOut, 0xD1, (uint64_t)iValue, 2);
+					else if (iValue >= -2147483647ll - 1)
+						Internal::WriteMsgPackTag(oOut, 0xD2, (uint64_t)iValue, 4);
+					else
+						Internal::WriteMsgPackTag(oOut, 0xD3, (uint64_t)iValue, 8);
+				}
+				break;
+			}
+		case E_TYPE_FLOAT:
+			{
+				uint64_t iBits;
+				memcpy(&iBits, &m_oValue.Float, sizeof(iBits));
+				Internal::WriteMsgPackTag(oOut, 0xCB, iBits, 8);
+				break;
+			}
+		default:
+			oOut += (char)0xC0;
+			break;
+		}
+	}
+
+#ifdef JsonStthmString
+	void JsonValue::WriteMsgPack(JsonStthmString& sOut) const
+	{
+		Internal::CharBuffer oBuffer;
+		WriteMsgPack(oBuffer);
+		sOut.resize(oBuffer.Size());
+		oBuffer.WriteTo((char*)sOut.data());
+	}
+#endif //JsonStthmString
+
+	int JsonValue::GetMemberCount() const
+	{
+		int iCount = 0;
+		if (m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY)
+		{
+			LoadLazyChilds();
+			if (m_iFlags & E_FLAG_INDEXED)
+				return (int)m_oValue.Childs.m_pIndex->m_iCount;
+
+			JsonValue* pChild = m_oValue.Childs.m_pFirst;
+			while (pChild != NULL)
+			{
+				++iCount;
+				pChild = pChild->m_pNext;
+			}
+		}
+
+		return iCount;
+	}
+
+	void JsonValue::BuildIndex()
+	{
+		if ((m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY) && (m_iFlags & E_FLAG_INDEXED) == 0)
+		{
+			const int iCount = GetMemberCount();
+			IndexChilds((uint32_t)iCount);
+		}
+	}
 
 	const char* JsonValue::ToString() const
 	{
-		if (m_eType == E_TYPE_STRING)
-			return m_oValue.String;
-		return NULL;
+		if (m_eType == E_TYPE_STRING)
+			return m_oValue.String;
+		return NULL;
+	}
+
+	bool JsonValue::ToBoolean() const
+	{
+		if (m_eType == E_TYPE_BOOLEAN)
+			return m_oValue.Boolean;
+		return false;
+	}
+
+	int64_t JsonValue::ToInteger() const
+	{
+		if (m_eType == E_TYPE_INTEGER)
+			return m_oValue.Integer;
+		else if (m_eType == E_TYPE_FLOAT)
+			return (int64_t)m_oValue.Float;
+		return 0;
+	}
+
+	double JsonValue::ToFloat() const
+	{
+		if (m_eType == E_TYPE_FLOAT)
+			return m_oValue.Float;
+		else if (m_eType == E_TYPE_INTEGER)
+			return (double)m_oValue.Integer;
+		return 0.0;
+	}
+
+#ifdef STTHM_ENABLE_IMPLICIT_CAST
+	JsonValue::operator const char*() const
+	{
+		return ToString();
+	}
+
+	JsonValue::operator bool() const
+	{
+		return ToBoolean();
+	}
+
+	JsonValue::operator int64_t() const
+	{
+		return ToInteger();
+	}
+
+	JsonValue::operator double() const
+	{
+		return ToFloat();
+	}
+#endif //STTHM_ENABLE_IMPLICIT_CAST
+
+	void JsonValue::SetString(const char* pValue, const char* pEnd)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return;
+
+		if (NULL != pValue)
+		{
+			InitType(E_TYPE_STRING);
+			SetStringValue(pValue, pEnd);
+		}
+		else
+		{
+			InitType(E_TYPE_NULL);
+		}
+	}
+
+	void JsonValue::SetBoolean(bool bValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return;
+
+		InitType(E_TYPE_BOOLEAN);
+		m_oValue.Boolean = bValue;
+	}
+
+	void JsonValue::SetInteger(int64_t iValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return;
+
+		InitType(E_TYPE_INTEGER);
+		m_oValue.Integer = iValue;
+	}
+
+	void JsonValue::SetFloat(double fValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return;
+
+		InitType(E_TYPE_FLOAT);
+		m_oValue.Float = fValue;
+	}
+
+	JsonValue& JsonValue::Append()
+	{
+		JsonStthmAssert(this != &INVALID);
+		if (this == &INVALID)
+			return INVALID;
+
+		if (m_eType == E_TYPE_NULL)
+			InitType(E_TYPE_ARRAY);
+
+		if (m_eType != E_TYPE_ARRAY)
+			return INVALID;
+
+		LoadLazyChilds();
+
+		// Append new element
+		JsonValue* pNewChild = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+		AppendChild(pNewChild);
+
+		return *pNewChild;
+	}
+
+	bool JsonValue::Combine(const JsonValue& oRight, bool bMergeSubMembers)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return false;
+
+		if (m_eType != oRight.m_eType)
+			return false;
+
+		LoadLazyChilds();
+		oRight.LoadLazyChilds();
+
+		switch(m_eType)
+		{
+		case E_TYPE_NULL:
+			// Nothing to do
+			break;
+		case E_TYPE_OBJECT:
+		{
+			// Replace value or try to add recursively values of sub objects
+			for (const JsonValue* pChild =  oRight.m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+			{
+				JsonValue& oLeftChild = (*this)[pChild->m_pName];
+				if (bMergeSubMembers && oLeftChild.m_eType == pChild->m_eType) // Combine again is the childrens's type is the same otherwise replace it
+				{
+					(*this)[pChild->m_pName].Combine(*pChild, true);
+				}
+				else
+				{
+					(*this)[pChild->m_pName] = *pChild;
+				}
+			}
+			break;
+		}
+		case E_TYPE_ARRAY:
+		{
+			// Append to array
+			for (const JsonValue* pChild = oRight.m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+			{
+				Append() = *pChild;
+			}
+			break;
+		}
+		case E_TYPE_STRING:
+		{
+			// Concatenate strings
+			size_t iLenLeft = strlen(m_oValue.String);
+			size_t iLenRight = strlen(oRight.m_oValue.String);
+			size_t iLenNew = iLenLeft + iLenRight;
+			char* pNewString = m_pAllocator->AllocString(iLenNew + 1, m_pAllocator->pUserData);
+			memcpy(pNewString, m_oValue.String, iLenLeft);
+			memcpy(pNewString + iLenLeft, oRight.m_oValue.String, iLenRight);
+			pNewString[iLenNew] = 0;
+			m_pAllocator->FreeString(m_oValue.String, m_pAllocator->pUserData);
+			m_oValue.String = pNewString;
+			break;
+		}
+		case E_TYPE_BOOLEAN:
+			m_oValue.Boolean = m_oValue.Boolean || oRight.m_oValue.Boolean;
+			break;
+		case E_TYPE_INTEGER:
+			m_oValue.Integer += oRight.m_oValue.Integer;
+			break;
+		case E_TYPE_FLOAT:
+			m_oValue.Float += oRight.m_oValue.Float;
+			break;
+		}
+
+		return true;
+	}
+
+	bool JsonValue::MoveFrom(JsonValue& oSource)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID || &oSource == &JsonStthm::JsonValue::INVALID)
+			return false;
+
+		if (this == &oSource)
+			return true;
+
+		// This value would own itself, or be freed by oSource.Reset()
+		if (IsDescendantOf(oSource))
+			return false;
+
+		if (m_pAllocator != oSource.m_pAllocator)
+		{
+			// oSource can be a child of this value
+			JsonValue oCopy(m_pAllocator);
+			oCopy = oSource;
+			oSource.Reset();
+			return MoveFrom(oCopy);
+		}
+
+		// Take content before reset, oSource can be a child of this value
+		EType eType = oSource.m_eType;
+		uint8_t iFlags = oSource.m_iFlags;
+		ValueUnion oValue = oSource.m_oValue;
+		oSource.m_eType = E_TYPE_NULL;
+		oSource.m_iFlags = 0;
+
+		Reset();
+		m_eType = eType;
+		m_iFlags = iFlags;
+		m_oValue = oValue;
+		return true;
+	}
+
+	bool JsonValue::IsDescendantOf(const JsonValue& oContainer) const
+	{
+		if ((oContainer.m_eType != E_TYPE_OBJECT && oContainer.m_eType != E_TYPE_ARRAY) || (oContainer.m_iFlags & E_FLAG_LAZY))
+			return false;
+
+		// Containers whose childs are not checked yet
+		Internal::Buffer<const JsonValue*, 64> oStack;
+		oStack.Push(&oContainer);
+		while (oStack.Size() > 0)
+		{
+			const JsonValue* pParent = oStack.Data()[oStack.Size() - 1];
+			oStack.Resize(oStack.Size() - 1);
+			for (const JsonValue* pChild = pParent->m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+			{
+				if (pChild == this)
+					return true;
+				if ((pChild->m_eType == E_TYPE_OBJECT || pChild->m_eType == E_TYPE_ARRAY) && (pChild->m_iFlags & E_FLAG_LAZY) == 0 && pChild->m_oValue.Childs.m_pFirst != NULL)
+					oStack.Push(pChild);
+			}
+		}
+		return false;
+	}
+
+	bool JsonValue::Detach(const char* pName, JsonValue& oOut)
+	{
+		if (m_eType != E_TYPE_OBJECT || pName == NULL)
+			return false;
+
+		JsonValue* pChild = FindMember(pName);
+		return pChild != NULL && DetachChild(pChild, oOut);
+	}
+
+	bool JsonValue::Detach(int iIndex, JsonValue& oOut)
+	{
+		if (m_eType != E_TYPE_OBJECT && m_eType != E_TYPE_ARRAY)
+			return false;
+
+		JsonValue* pChild = FindChild(iIndex);
+		return pChild != NULL && DetachChild(pChild, oOut);
+	}
+
+	bool JsonValue::Splice(JsonValue& oSource)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID || this == &oSource || oSource.IsContainer() == false)
+			return false;
+
+		// This value would be moved inside itself, or freed with oSource childs
+		if (IsDescendantOf(oSource))
+			return false;
+
+		if (m_eType == E_TYPE_NULL)
+			InitType(oSource.m_eType);
+
+		if (m_eType != oSource.m_eType)
+			return false;
+
+		LoadLazyChilds();
+		oSource.LoadLazyChilds();
+
+		if (m_pAllocator != oSource.m_pAllocator)
+		{
+			for (const JsonValue* pSourceChild = oSource.m_oValue.Childs.m_pFirst; pSourceChild != NULL; pSourceChild = pSourceChild->m_pNext)
+			{
+				JsonValue* pNewChild = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+				*pNewChild = *pSourceChild;
+
+				if (pSourceChild->m_pName != NULL)
+				{
+					size_t iNameLen = strlen(pSourceChild->m_pName) + 1;
+					char* pNewString = m_pAllocator->AllocString(iNameLen, m_pAllocator->pUserData);
+					memcpy(pNewString, pSourceChild->m_pName, iNameLen);
+					pNewChild->m_pName = pNewString;
+				}
+
+				AppendChild(pNewChild);
+			}
+			oSource.InitType(E_TYPE_NULL);
+			oSource.InitType(m_eType);
+			return true;
+		}
+
+		if (oSource.m_oValue.Childs.m_pFirst == NULL)
+			return true;
+
+		DropIndex();
+		oSource.DropIndex();
+
+		// Relink childs chain
+		if (m_oValue.Childs.m_pLast != NULL)
+			m_oValue.Childs.m_pLast->m_pNext = oSource.m_oValue.Childs.m_pFirst;
+		else
+			m_oValue.Childs.m_pFirst = oSource.m_oValue.Childs.m_pFirst;
+		m_oValue.Childs.m_pLast = oSource.m_oValue.Childs.m_pLast;
+
+		oSource.m_oValue.Childs.m_pFirst = NULL;
+		oSource.m_oValue.Childs.m_pLast = NULL;
+		return true;
+	}
+
+	bool JsonValue::operator ==(const JsonValue& oRight) const
+	{
+		if (m_eType != oRight.m_eType)
+			return false;
+
+		LoadLazyChilds();
+		oRight.LoadLazyChilds();
+
+		switch (m_eType)
+		{
+		case E_TYPE_NULL:
+			break;
+		case E_TYPE_OBJECT:
+		{
+			// We don't care if members order is not the same
+			const JsonValue* pChildLeft = m_oValue.Childs.m_pFirst;
+			while (pChildLeft != NULL)
+			{
+				if (*pChildLeft != oRight[pChildLeft->m_pName])
+					return false;
+
+				pChildLeft = pChildLeft->m_pNext;
+			}
+			break;
+		}
+		case E_TYPE_ARRAY:
+		{
+			JsonValue* pChildLeft = m_oValue.Childs.m_pFirst;
+			JsonValue* pChildRight = oRight.m_oValue.Childs.m_pFirst;
+			while (pChildLeft != NULL && pChildRight != NULL)
+			{
+				if (*pChildLeft != *pChildRight)
+					return false;
+
+				pChildLeft = pChildLeft->m_pNext;
+				pChildRight = pChildRight->m_pNext;
+			}
+
+			if (pChildLeft != NULL || pChildRight != NULL)
+				return false;
+			break;
+		}
+		case E_TYPE_STRING:
+			if (strcmp(m_oValue.String, oRight.m_oValue.String) != 0)
+				return false;
+			break;
+		case E_TYPE_BOOLEAN:
+			if (memcmp(&m_oValue.Boolean, &oRight.m_oValue.Boolean, sizeof(m_oValue.Boolean)) != 0)
+				return false;
+			break;
+		case E_TYPE_INTEGER:
+			if (memcmp(&m_oValue.Integer, &oRight.m_oValue.Integer, sizeof(m_oValue.Integer)) != 0)
+				return false;
+			break;
+		case E_TYPE_FLOAT:
+			if (memcmp(&m_oValue.Float, &oRight.m_oValue.Float, sizeof(m_oValue.Float)) != 0)
+				return false;
+			break;
+		}
+
+		return true;
+	}
+
+	bool JsonValue::operator !=(const JsonValue& oRight) const
+	{
+		return (*this == oRight) == false;
+	}
+
+	const JsonValue& JsonValue::operator[](const char* pName) const
+	{
+		if (m_eType == E_TYPE_OBJECT && pName != NULL)
+		{
+			JsonValue* pChild = FindMember(pName);
+			if (pChild != NULL)
+				return *pChild;
+		}
+		return JsonValue::INVALID;
+	}
+
+	JsonValue& JsonValue::operator[](const char* pName)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		if (pName == NULL || pName[0] == 0)
+			return JsonValue::INVALID;
+
+		if (m_eType == E_TYPE_NULL)
+			InitType(E_TYPE_OBJECT);
+		if (m_eType == E_TYPE_OBJECT)
+		{
+			int iScanned = 0;
+			JsonValue* pChild = FindMember(pName, &iScanned);
+
+			// Large object and member was not in first ones, next lookups will use an index
+			if (STTHM_OBJECT_INDEX_THRESHOLD > 0 && iScanned >= STTHM_OBJECT_INDEX_THRESHOLD)
+				BuildIndex();
+
+			if (pChild != NULL)
+				return *pChild;
+
+			JsonValue* pNewMember = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+
+			size_t iNameLen = strlen(pName) + 1;
+			void* pNewString = m_pAllocator->AllocString(iNameLen, m_pAllocator->pUserData);
+			memcpy(pNewString, (const void*)pName, iNameLen);
+			pNewMember->m_pName = (char*)pNewString;
+
+			AppendChild(pNewMember);
+			return *pNewMember;
+		}
+		return JsonValue::INVALID;
+	}
+
+	const JsonValue& JsonValue::operator[](char* pName) const
+	{
+		return (*this)[(const char*)pName];
+	}
+
+	JsonValue& JsonValue::operator[](char* pName)
+	{
+		return (*this)[(const char*)pName];
+	}
+
+	const JsonValue& JsonValue::operator [](int iIndex) const
+	{
+		if (m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY)
+		{
+			JsonValue* pChild = FindChild(iIndex);
+			if (pChild != NULL)
+				return *pChild;
+		}
+		return JsonValue::INVALID;
+	}
+
+	JsonValue& JsonValue::operator[](int iIndex)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		if (m_eType == E_TYPE_NULL)
+			InitType(E_TYPE_ARRAY);
+		if (m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY)
+		{
+			// Array is accessed far from its start, this access and next ones will use a table
+			if (STTHM_ARRAY_INDEX_THRESHOLD > 0 && m_eType == E_TYPE_ARRAY && iIndex >= STTHM_ARRAY_INDEX_THRESHOLD)
+				BuildIndex();
+
+			JsonValue* pChild = FindChild(iIndex);
+			if (pChild != NULL)
+				return *pChild;
+
+			if (m_eType == E_TYPE_ARRAY && iIndex >= 0)
+			{
+				int iCurrent = GetMemberCount();
+				JsonValue* pNewChild;
+				do
+				{
+					pNewChild = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+					AppendChild(pNewChild);
+				}
+				while (iCurrent++ != iIndex);
+				return *pNewChild;
+			}
+		}
+		return JsonValue::INVALID;
+	}
+
+	JsonValue& JsonValue::operator =(const JsonValue& oValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		// Would be reset before being copied
+		if (this == &oValue)
+			return *this;
+
+		oValue.LoadLazyChilds();
+
+		if (oValue.m_eType == E_TYPE_OBJECT)
+		{
+			InitType(E_TYPE_OBJECT);
+
+			JsonValue* pSourceChild = oValue.m_oValue.Childs.m_pFirst;
+			while (pSourceChild != NULL)
+			{
+				JsonValue* pNewChild = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+				*pNewChild = *pSourceChild;
+
+				if (pSourceChild->m_pName != NULL)
+				{
+					size_t iNameLen = strlen(pSourceChild->m_pName) + 1;
+					char* pNewString = m_pAllocator->AllocString(iNameLen, m_pAllocator->pUserData);
+					memcpy(pNewString, pSourceChild->m_pName, iNameLen);
+					pNewChild->m_pName = pNewString;
+				}
+
+				AppendChild(pNewChild);
+
+				pSourceChild = pSourceChild->m_pNext;
+			}
+			BuildIndex();
+		}
+		else if (oValue.m_eType == E_TYPE_ARRAY)
+		{
+			InitType(E_TYPE_ARRAY);
+
+			JsonValue* pSourceChild = oValue.m_oValue.Childs.m_pFirst;
+			while (pSourceChild != NULL)
+			{
+				JsonValue* pNewChild = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+				*pNewChild = *pSourceChild;
+
+				AppendChild(pNewChild);
+
+				pSourceChild = pSourceChild->m_pNext;
+			}
+			BuildIndex();
+		}
+		else if (oValue.m_eType == E_TYPE_BOOLEAN)
+		{
+			*this = oValue.ToBoolean();
+		}
+		else if (oValue.m_eType == E_TYPE_STRING)
+		{
+			*this = oValue.ToString();
+		}
+		else if (oValue.m_eType == E_TYPE_INTEGER)
+		{
+			*this = oValue.ToInteger();
+		}
+		else if (oValue.m_eType == E_TYPE_FLOAT)
+		{
+			*this = oValue.ToFloat();
+		}
+		else
+		{
+			InitType(E_TYPE_NULL);
+		}
+		return *this;
+	}
+
+#ifdef JsonStthmString
+	JsonValue& JsonValue::operator =(const JsonStthmString& sValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		InitType(E_TYPE_STRING);
+		SetStringValue(sValue.c_str());
+
+		return *this;
+	}
+#endif //JsonStthmString
+
+	JsonValue& JsonValue::operator =(const char* pValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		SetString(pValue);
+		return *this;
+	}
+
+	JsonValue& JsonValue::operator =(bool bValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		SetBoolean(bValue);
+		return *this;
+	}
+
+	JsonValue& JsonValue::operator =(int64_t iValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		SetInteger(iValue);
+		return *this;
+	}
+
+	JsonValue& JsonValue::operator =(double fValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		SetFloat(fValue);
+		return *this;
+	}
+
+#if defined(STTHM_USE_MOVE)
+	JsonValue& JsonValue::operator =(JsonValue&& oValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		MoveFrom(oValue);
+		return *this;
+	}
+#endif //STTHM_USE_MOVE
+
+	JsonValue& JsonValue::operator +=(const JsonValue& oValue)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID)
+			return JsonValue::INVALID;
+
+		if (m_eType == E_TYPE_ARRAY)
+		{
+			LoadLazyChilds();
+
+			JsonValue* pNewValue = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+			*pNewValue = oValue;
+
+			AppendChild(pNewValue);
+		}
+		else if (m_eType == E_TYPE_STRING)
+		{
+			if (oValue.IsString())
+			{
+				Internal::CharBuffer oNewStr;
+				const char* pAddString = oValue.ToString();
+				size_t iLen1 = strlen(m_oValue.String);
+				size_t iLen2 = strlen(pAddString);
+				oNewStr.Reserve(iLen1 + iLen2 + 1);
+				oNewStr.PushRange(m_oValue.String, iLen1);
+				oNewStr.PushRange(pAddString, iLen2);
+				oNewStr.Push(0);
+				SetStringValue(oNewStr.Data());
+			}
+		}
+		return *this;
+	}
+
+	bool JsonValue::Parse(const char*& pString, const char* pEnd, int iParseFlags)
+	{
+		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
+		if (this == &JsonStthm::JsonValue::INVALID || pString == NULL)
+			return false;
+
+		Internal::SkipSpaces(pString, pEnd);
+		if (pString >= pEnd || *pString == 0)
+		{
+			return true;
+		}
+		else if (*pString == '"')
+		{
+			char* pValue = ReadStringValue(++pString, pEnd, m_pAllocator, (iParseFlags & E_PARSE_FLAG_INSITU) != 0);
+			if (pValue == NULL)
+			{
+				return false;
+			}
+
+			InitType(E_TYPE_STRING);
+			m_oValue.String = pValue;
+			return true;
+		}
+		else if ((pEnd - pString) >= 3 && memcmp(pString, "NaN", 3) == 0)
+		{
+			pString += 3;
+			InitType(E_TYPE_FLOAT);
+			m_oValue.Float = Internal::c_fNaN;
+			return true;
+		}
+		else if ((pEnd - pString) >= 9 && memcmp(pString, "-Infinity", 9) == 0)
+		{
+			pString += 9;
+			InitType(E_TYPE_FLOAT);
+			m_oValue.Float = -Internal::c_fInfinity;
+			return true;
+		}
+		else if ((pEnd - pString) >= 8 && memcmp(pString, "Infinity", 8) == 0)
+		{
+			pString += 8;
+			InitType(E_TYPE_FLOAT);
+			m_oValue.Float = Internal::c_fInfinity;
+			return true;
+		}
+		else if (Internal::IsDigit(*pString) || *pString == '-')
+		{
+			return ReadNumericValue(pString, pEnd, *this);
+		}
+		else if ((pEnd - pString) >= 4 && memcmp(pString, "true", 4) == 0)
+		{
+			pString += 4;
+			InitType(E_TYPE_BOOLEAN);
+			m_oValue.Boolean = true;
+			return true;
+		}
+		else if ((pEnd - pString) >= 5 && memcmp(pString, "false", 5) == 0)
+		{
+			pString += 5;
+			InitType(E_TYPE_BOOLEAN);
+			m_oValue.Boolean = false;
+			return true;
+		}
+		else if ((pEnd - pString) >= 4 && memcmp(pString, "null", 4) == 0)
+		{
+			pString += 4;
+			InitType(E_TYPE_NULL);
+			return true;
+		}
+		else if (*pString == '{')
+		{
+			++pString;
+			if (iParseFlags & E_PARSE_FLAG_LAZY)
+				return ReadLazyValue(pString, pEnd, *this, E_TYPE_OBJECT);
+			return ReadObjectValue(pString, pEnd, *this, iParseFlags);
+		}
+		else if (*pString == '[')
+		{
+			++pString;
+			if (iParseFlags & E_PARSE_FLAG_LAZY)
+				return ReadLazyValue(pString, pEnd, *this, E_TYPE_ARRAY);
+			return ReadArrayValue(pString, pEnd, *this, iParseFlags);
+		}
+
+		// Error
+		return false;
+	}
+
+	// Static functions
+
+	int JsonValue::ReadSpecialChar(const char*& pString, const char* pEnd, char* pOut)
+	{
+		if( pString >= pEnd )
+			return 0;
+
+		if (*pString == 'n')		{ pOut[0] = '\n';	return 1; }
+		else if (*pString == 'r')	{ pOut[0] = '\r';	return 1; }
+		else if (*pString == 't')	{ pOut[0] = '\t';	return 1; }
+		else if (*pString == 'b')	{ pOut[0] = '\b';	return 1; }
+		else if (*pString == 'f')	{ pOut[0] = '\f';	return 1; }
+		else if (*pString == '"')	{ pOut[0] = '"';	return 1; }
+		else if (*pString == '\\')	{ pOut[0] = '\\';	return 1; }
+		else if (*pString == '/')	{ pOut[0] = '/';	return 1; }
+		else if (*pString == 'u')
+		{
+			uint32_t iChar = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				if (pString + 1 >= pEnd)
+					return 0;
+
+				uint8_t iXDigit = Internal::XDigitToUInt8(*++pString);
+				if (iXDigit != 255)
+					iChar = iChar * 16 + iXDigit;
+				else
+					return 0;
+			}
+
+			if (iChar >= 0xD800 && iChar <= 0xDFFF) // UTF16 Surrogate pair
+			{
+				if ((iChar & 0xFC00) != 0xD800)
+					return 0; //Invalid first pair code
+
+				if ((pEnd - pString) < 3 || pString[1] != '\\' || pString[2] != 'u')
+					return 0; //Not a valid pair
+				pString += 2;
+
+				uint32_t iChar2 = 0;
+				for (int i = 0; i < 4; ++i)
+				{
+					if (pString + 1 >= pEnd)
+						return 0;
+
+					uint8_t iXDigit = Internal::XDigitToUInt8(*++pString);
+					if (iXDigit != 255)
+						iChar2 = iChar2 * 16 + iXDigit;
+					else
+						return 0;
+				}
+
+				if ((iChar2 & 0xFC00) != 0xDC00)
+					return 0; //Invalid second pair code
+
+				iChar = 0x10000 + (((iChar & 0x3FF) << 10) | (iChar2 & 0x3FF));
+			}
+
+			if (iChar < 0x80)
+			{
+				pOut[0] = (char)iChar;
+				return 1;
+			}
+			if (iChar >= 0x80 && iChar <= 0x7FF)
+			{
+				pOut[0] = (char)(0xC0 | ((iChar >> 6)));
+				pOut[1] = (char)(0x80 | ((iChar >> 0) & 0x3F));
+				return 2;
+			}
+			if (iChar >= 0x800 && iChar <= 0xFFFF)
+			{
+				pOut[0] = (char)(0xE0 | ((iChar >> 12)));
+				pOut[1] = (char)(0x80 | ((iChar >> 6) & 0x3F));
+				pOut[2] = (char)(0x80 | ((iChar >> 0) & 0x3F));
+				return 3;
+			}
+			if (iChar >= 0x10000 && iChar <= 0x10FFFF)
+			{
+				pOut[0] = (char)(0xF0 | ((iChar >> 18)));
+				pOut[1] = (char)(0x80 | ((iChar >> 12) & 0x3F));
+				pOut[2] = (char)(0x80 | ((iChar >> 6) & 0x3F));
+				pOut[3] = (char)(0x80 | ((iChar >> 0) & 0x3F));
+				return 4;
+			}
+		}
+
+		return 0;
+	}
+
+	char* JsonValue::ReadStringValue(const char*& pString, const char* pEnd, Allocator* pAllocator, bool bInsitu)
+	{
+		size_t iLen = 0;
+		// Read string length
+		{
+			char pTemp[4];
+			const char* pCursor = pString;
+			while (true)
+			{
+				// Skip chars without escaping in bulk
+				const char* pSpecial = Internal::FindStringSpecial(pCursor, pEnd);
+				iLen += pSpecial - pCursor;
+				pCursor = pSpecial;
+
+				if (pCursor >= pEnd || *pCursor == 0)
+					return NULL; // Unterminated string
+				else if (*pCursor == '"')
+					break;
+
+				int iCharLen = ReadSpecialChar(++pCursor, pEnd, pTemp);
+				if (iCharLen == 0)
+					return NULL;
+				iLen += iCharLen;
+				++pCursor;
+			}
+
+			if (bInsitu && iLen == (size_t)(pCursor - pString))
+			{
+				// No escape, terminate string in place
+				char* pInsitu = const_cast<char*>(pString);
+				pInsitu[iLen] = '\0';
+				pString = pCursor + 1;
+				return pInsitu;
+			}
+		}
+
+		// Alloc string, or unescape it in place (unescaped string is never longer)
+		char* pNewString = bInsitu ? const_cast<char*>(pString) : pAllocator->AllocString(iLen + 1, pAllocator->pUserData);
+		char* pNewStringCursor = pNewString;
+
+		// Read string
+		{
+			while (true)
+			{
+				const char* pSpecial = Internal::FindStringSpecial(pString, pEnd);
+				memmove(pNewStringCursor, pString, pSpecial - pString);
+				pNewStringCursor += pSpecial - pString;
+				pString = pSpecial;
+
+				if (*pString == '"')
+				{
+					++pString;
+					*pNewStringCursor = '\0';
+					return pNewString;
+				}
+
+				// Can't fail, already checked by first pass
+				int iCharLen = ReadSpecialChar(++pString, pEnd, pNewStringCursor);
+				pNewStringCursor += iCharLen;
+				++pString;
+			}
+		}
+	}
+
+	bool JsonValue::ReadNumericValue(const char*& pString, const char* pEnd, JsonValue& oValue)
+	{
+		const char* pStart = pString;
+
+		bool bNeg = false;
+		if (*pString == '-')
+		{
+			++pString;
+			bNeg = true;
+		}
+
+		const char* pDigitsEnd = Internal::SkipDigits(pString, pEnd);
+		if (pDigitsEnd == pString)
+			return false;
+
+		// Only first 19 significant digits are kept, next ones update exponent
+		uint64_t iMantissa = 0;
+		int iSignificantDigits = 0;
+		int iExp10 = 0;
+		bool bTruncated = false;
+		for (; pString < pDigitsEnd; ++pString)
+		{
+			if (iSignificantDigits < 19)
+			{
+				iMantissa = iMantissa * 10 + (*pString & 0xF);
+				if (iMantissa != 0)
+					++iSignificantDigits;
+			}
+			else
+			{
+				++iExp10;
+				bTruncated |= *pString != '0';
+			}
+		}
+
+		bool bFloat = false;
+		if (pString < pEnd && *pString == '.')
+		{
+			bFloat = true;
+			pDigitsEnd = Internal::SkipDigits(++pString, pEnd);
+			for (; pString < pDigitsEnd; ++pString)
+			{
+				if (iSignificantDigits < 19)
+				{
+					iMantissa = iMantissa * 10 + (*pString & 0xF);
+					if (iMantissa != 0)
+						++iSignificantDigits;
+					--iExp10;
+				}
+				else
+				{
+					bTruncated |= *pString != '0';
+				}
+			}
+		}
+
+		if (pString < pEnd && (*pString == 'e' || *pString == 'E'))
+		{
+			const char* pExp = pString + 1;
+			bool bNegExp = false;
+			if (pExp < pEnd && (*pExp == '+' || *pExp == '-'))
+			{
+				bNegExp = *pExp == '-';
+				++pExp;
+			}
+
+			// Without digits, 'e' is not part of number
+			pDigitsEnd = Internal::SkipDigits(pExp, pEnd);
+			if (pDigitsEnd > pExp)
+			{
+				int iExpValue = 0;
+				for (; pExp < pDigitsEnd; ++pExp)
+				{
+					if (iExpValue < 100000)
+						iExpValue = iExpValue * 10 + (*pExp & 0xF);
+				}
+				iExp10 += bNegExp ? -iExpValue : iExpValue;
+				bFloat = true;
+				pString = pDigitsEnd;
+			}
+		}
+
+		// Integers out of int64 range are read as float
+		if (bFloat == false && iExp10 == 0 && iMantissa <= 0x7FFFFFFFFFFFFFFFULL + (bNeg ? 1 : 0))
+		{
+			oValue.InitType(E_TYPE_INTEGER);
+			oValue.m_oValue.Integer = bNeg ? (int64_t)(0 - iMantissa) : (int64_t)iMantissa;
+			return true;
+		}
+
+		double fValue;
+		double fUpperValue;
+		if (iMantissa == 0)
+		{
+			fValue = bNeg ? -0.0 : 0.0;
+		}
+		else if (bTruncated == false && iMantissa <= (1ULL << 53) && iExp10 >= -22 && iExp10 <= 22)
+		{
+			// Mantissa and power of ten are exact doubles, one operation is correctly rounded
+			fValue = (double)iMantissa;
+			if (iExp10 < 0)
+				fValue /= Internal::c_pExactPow10[-iExp10];
+			else
+				fValue *= Internal::c_pExactPow10[iExp10];
+			if (bNeg)
+				fValue = -fValue;
+		}
+		else if (Internal::EiselLemire(iMantissa, iExp10, bNeg, &fValue) == false
+			// Value is between iMantissa and iMantissa + 1 when digits were dropped
+			|| (bTruncated && (Internal::EiselLemire(iMantissa + 1, iExp10, bNeg, &fUpperValue) == false || fUpperValue != fValue)))
+		{
+			fValue = Internal::StrToDouble(pStart, pString);
+		}
+
+		oValue.InitType(E_TYPE_FLOAT);
+		oValue.m_oValue.Float = fValue;
+		return true;
+	}
+
+	bool JsonValue::ReadObjectValue(const char*& pString, const char* pEnd, JsonValue& oValue, int iParseFlags)
+	{
+		oValue.InitType(JsonValue::E_TYPE_OBJECT);
+
+		Internal::SkipSpaces(pString, pEnd);
+
+		if (pString < pEnd && *pString == '}')
+		{
+			++pString;
+			return true;
+		}
+
+		uint32_t iCount = 0;
+		while (pString < pEnd && *pString != 0)
+		{
+			Internal::SkipSpaces(pString, pEnd);
+
+			// Read member name
+			if (pString >= pEnd || *pString != '"')
+				return false;
+
+			char* pName = ReadStringValue(++pString, pEnd, oValue.m_pAllocator, (iParseFlags & E_PARSE_FLAG_INSITU) != 0);
+			if (pName == NULL)
+				return false;
+
+			JsonValue* pNewMember = oValue.m_pAllocator->CreateJsonValue(oValue.m_pAllocator, oValue.m_pAllocator->pUserData);
+			pNewMember->m_pName = pName;
+
+			Internal::SkipSpaces(pString, pEnd);
+
+			if (pString >= pEnd || *pString != ':')
+				return false;
+
+			++pString;
+
+			Internal::SkipSpaces(pString, pEnd);
+
+			if (pNewMember->Parse(pString, pEnd, iParseFlags) == false)
+			{
+				oValue.m_pAllocator->DeleteJsonValue(pNewMember, oValue.m_pAllocator->pUserData);
+				return false;
+			}
+
+			if (oValue.m_oValue.Childs.m_pFirst == NULL)
+			{
+				oValue.m_oValue.Childs.m_pFirst = pNewMember;
+			}
+			else
+			{
+				oValue.m_oValue.Childs.m_pLast->m_pNext = pNewMember;
+			}
+			oValue.m_oValue.Childs.m_pLast = pNewMember;
+			++iCount;
+
+			Internal::SkipSpaces(pString, pEnd);
+
+			if (pString >= pEnd)
+			{
+				return false;
+			}
+			else if (*pString == '}')
+			{
+				++pString;
+				oValue.IndexChilds(iCount);
+				return true;
+			}
+			else if (*pString != ',')
+			{
+				return false;
+			}
+			++pString;
+		}
+		return false;
+	}
+
+	bool JsonValue::ReadArrayValue(const char*& pString, const char* pEnd, JsonValue& oValue, int iParseFlags)
+	{
+		oValue.InitType(JsonValue::E_TYPE_ARRAY);
+
+		Internal::SkipSpaces(pString, pEnd);
+		if (pString < pEnd && *pString == ']')
+		{
+			++pString;
+			return true;
+		}
+
+		uint32_t iCount = 0;
+		while (pString < pEnd && *pString != 0)
+		{
+			Internal::SkipSpaces(pString, pEnd);
+
+			JsonValue* pNewValue = oValue.m_pAllocator->CreateJsonValue(oValue.m_pAllocator, oValue.m_pAllocator->pUserData);
+
+			if (pNewValue->Parse(pString, pEnd, iParseFlags) == false)
+			{
+				oValue.m_pAllocator->DeleteJsonValue(pNewValue, oValue.m_pAllocator->pUserData);
+
+				return false;
+			}
+
+			if (oValue.m_oValue.Childs.m_pFirst == NULL)
+			{
+				oValue.m_oValue.Childs.m_pFirst = pNewValue;
+			}
+			else
+			{
+				oValue.m_oValue.Childs.m_pLast->m_pNext = pNewValue;
+			}
+			oValue.m_oValue.Childs.m_pLast = pNewValue;
+			++iCount;
+
+			Internal::SkipSpaces(pString, pEnd);
+
+			if (pString >= pEnd)
+			{
+				return false;
+			}
+			else if (*pString == ']')
+			{
+				++pString;
+				oValue.IndexChilds(iCount);
+				return true;
+			}
+			else if (*pString != ',')
+			{
+				return false;
+			}
+			++pString;
+		}
+		return false;
+	}
+
+	bool JsonValue::ReadLazyValue(const char*& pString, const char* pEnd, JsonValue& oValue, EType eType)
+	{
+		const char* pBegin = pString;
+		if (Internal::SkipContainer(pString, pEnd, eType == E_TYPE_OBJECT ? '}' : ']') == false)
+			return false;
+
+		oValue.InitType(eType);
+		oValue.m_iFlags |= E_FLAG_LAZY;
+		oValue.m_oValue.Lazy.m_pBegin = pBegin;
+		oValue.m_oValue.Lazy.m_pEnd = pString;
+		return true;
+	}
+
+	void JsonValue::ParseLazyChilds() const
+	{
+		JsonStthmAssert(m_iFlags & E_FLAG_LAZY);
+		JsonValue* pThis = const_cast<JsonValue*>(this);
+
+		const char* pString = m_oValue.Lazy.m_pBegin;
+		const char* pEnd = m_oValue.Lazy.m_pEnd;
+
+		pThis->m_iFlags &= ~E_FLAG_LAZY;
+		pThis->m_oValue.Childs.m_pFirst = NULL;
+		pThis->m_oValue.Childs.m_pLast = NULL;
+
+		bool bOk;
+		if (m_eType == E_TYPE_OBJECT)
+			bOk = ReadObjectValue(pString, pEnd, *pThis, E_PARSE_FLAG_LAZY);
+		else
+			bOk = ReadArrayValue(pString, pEnd, *pThis, E_PARSE_FLAG_LAZY);
+
+		// Only bounds were checked on first pass, container with invalid content become null
+		// and the error is kept by its document (see JsonDoc::GetLazyError)
+		if (bOk == false)
+		{
+			pThis->InitType(E_TYPE_NULL);
+			if (m_pAllocator != NULL && m_pAllocator->CreateJsonValue == &JsonDoc::CreateJsonValue)
+				JsonDoc::SetLazyError((JsonDoc*)m_pAllocator->pUserData, pString);
+		}
+	}
+
+	void JsonValue::AppendChild(JsonValue* pChild)
+	{
+		JsonStthmAssert(IsContainer() && (m_iFlags & E_FLAG_LAZY) == 0);
+
+		if ((m_iFlags & E_FLAG_INDEXED) == 0)
+		{
+			if (NULL != m_oValue.Childs.m_pLast)
+				m_oValue.Childs.m_pLast->m_pNext = pChild;
+			else
+				m_oValue.Childs.m_pFirst = pChild;
+
+			m_oValue.Childs.m_pLast = pChild;
+			return;
+		}
+
+		ChildIndex* pIndex = m_oValue.Childs.m_pIndex;
+		pIndex->m_pLast->m_pNext = pChild;
+		pIndex->m_pLast = pChild;
+
+		if (m_eType == E_TYPE_ARRAY)
+		{
+			if (pIndex->m_iCount == pIndex->m_iCapacity)
+			{
+				// Grow table
+				const uint32_t iCapacity = pIndex->m_iCapacity * 2;
+				const size_t iSize = sizeof(ChildIndex) + iCapacity * sizeof(JsonValue*);
+				ChildIndex* pNewIndex = (ChildIndex*)Internal::AllocMemory(m_pAllocator, iSize, alignof(ChildIndex));
+				if (pNewIndex == NULL)
+				{
+					// Fallback to linked list only
+					Internal::FreeMemory(m_pAllocator, pIndex);
+					m_iFlags &= ~E_FLAG_INDEXED;
+					m_oValue.Childs.m_pLast = pChild;
+					return;
+				}
+				memcpy(pNewIndex, pIndex, sizeof(ChildIndex) + pIndex->m_iCount * sizeof(JsonValue*));
+				pNewIndex->m_iCapacity = iCapacity;
+				Internal::FreeMemory(m_pAllocator, pIndex);
+				m_oValue.Childs.m_pIndex = pIndex = pNewIndex;
+			}
+			pIndex->Slots()[pIndex->m_iCount++] = pChild;
+			return;
+		}
+
+		pIndex->m_iCount++;
+
+		// Keep load factor under 1/2
+		if (pIndex->m_iCount * 2 > pIndex->m_iCapacity)
+		{
+			// Rebuild a bigger index
+			const uint32_t iCount = pIndex->m_iCount;
+			Internal::FreeMemory(m_pAllocator, pIndex);
+			m_iFlags &= ~E_FLAG_INDEXED;
+			m_oValue.Childs.m_pLast = pChild;
+			BuildMemberIndex(iCount);
+		}
+		else
+		{
+			InsertIndexedMember(pIndex->Slots(), pIndex->m_iCapacity, pChild);
+		}
+	}
+
+	bool JsonValue::DetachChild(JsonValue* pChild, JsonValue& oOut)
+	{
+		JsonStthmAssert(IsContainer() && (m_iFlags & E_FLAG_LAZY) == 0);
+
+		// oOut would be freed with pChild, keep the child in place
+		if (&oOut == &JsonStthm::JsonValue::INVALID || &oOut == pChild || oOut.IsDescendantOf(*pChild))
+			return false;
+
+		DropIndex();
+
+		JsonValue* pPrevious = NULL;
+		JsonValue* pCurrent = m_oValue.Childs.m_pFirst;
+		while (pCurrent != pChild)
+		{
+			if (pCurrent == NULL)
+				return false;
+			pPrevious = pCurrent;
+			pCurrent = pCurrent->m_pNext;
+		}
+
+		if (pPrevious != NULL)
+			pPrevious->m_pNext = pChild->m_pNext;
+		else
+			m_oValue.Childs.m_pFirst = pChild->m_pNext;
+		if (m_oValue.Childs.m_pLast == pChild)
+			m_oValue.Childs.m_pLast = pPrevious;
+		pChild->m_pNext = NULL;
+
+		oOut.MoveFrom(*pChild);
+		m_pAllocator->DeleteJsonValue(pChild, m_pAllocator->pUserData);
+		return true;
+	}
+
+	void JsonValue::DropIndex()
+	{
+		if (m_iFlags & E_FLAG_INDEXED)
+		{
+			JsonValue* pLast = m_oValue.Childs.m_pIndex->m_pLast;
+			Internal::FreeMemory(m_pAllocator, m_oValue.Childs.m_pIndex);
+			m_oValue.Childs.m_pLast = pLast;
+			m_iFlags &= ~E_FLAG_INDEXED;
+		}
+	}
+
+	JsonValue* JsonValue::FindMember(const char* pName, int* pScanned) const
+	{
+		JsonStthmAssert(m_eType == E_TYPE_OBJECT);
+		LoadLazyChilds();
+
+		if (m_iFlags & E_FLAG_INDEXED)
+			return FindIndexedMember(pName, Internal::HashString(pName));
+
+		int iCount = 0;
+		JsonValue* pChild = m_oValue.Childs.m_pFirst;
+		while (pChild != NULL)
+		{
+			if (strcmp(pChild->m_pName, pName) == 0)
+				break;
+			pChild = pChild->m_pNext;
+			++iCount;
+		}
+
+		if (pScanned != NULL)
+			*pScanned = iCount;
+		return pChild;
+	}
+
+	JsonValue* JsonValue::FindIndexedMember(const char* pName, uint32_t iHash) const
+	{
+		JsonStthmAssert(m_eType == E_TYPE_OBJECT && (m_iFlags & E_FLAG_INDEXED));
+
+		ChildIndex* pIndex = m_oValue.Childs.m_pIndex;
+		JsonValue** pSlots = pIndex->Slots();
+		const uint32_t iMask = pIndex->m_iCapacity - 1;
+		for (uint32_t iSlot = iHash & iMask; pSlots[iSlot] != NULL; iSlot = (iSlot + 1) & iMask)
+		{
+			if (strcmp(pSlots[iSlot]->m_pName, pName) == 0)
+				return pSlots[iSlot];
+		}
+		return NULL;
+	}
+
+	JsonValue* JsonValue::FindChild(int iIndex) const
+	{
+		JsonStthmAssert(m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY);
+		LoadLazyChilds();
+
+		if (iIndex < 0)
+			return NULL;
+
+		if ((m_iFlags & E_FLAG_INDEXED) && m_eType == E_TYPE_ARRAY)
+		{
+			ChildIndex* pIndex = m_oValue.Childs.m_pIndex;
+			return ((uint32_t)iIndex < pIndex->m_iCount) ? pIndex->Slots()[iIndex] : NULL;
+		}
+
+		JsonValue* pChild = m_oValue.Childs.m_pFirst;
+		int iCurrent = 0;
+		while (pChild != NULL && iCurrent != iIndex)
+		{
+			pChild = pChild->m_pNext;
+			++iCurrent;
+		}
+		return pChild;
+	}
+
+	void JsonValue::BuildChildTable(uint32_t iCount)
+	{
+		JsonStthmAssert(m_eType == E_TYPE_ARRAY && (m_iFlags & (E_FLAG_LAZY | E_FLAG_INDEXED)) == 0);
+
+		uint32_t iCapacity = 16;
+		while (iCapacity < iCount)
+			iCapacity *= 2;
+
+		const size_t iSize = sizeof(ChildIndex) + iCapacity * sizeof(JsonValue*);
+		ChildIndex* pIndex = (ChildIndex*)Internal::AllocMemory(m_pAllocator, iSize, alignof(ChildIndex));
+		if (pIndex == NULL)
+			return; // Keep linear access
+
+		pIndex->m_pLast = m_oValue.Childs.m_pLast;
+		pIndex->m_iCount = iCount;
+		pIndex->m_iCapacity = iCapacity;
+		JsonValue** pSlots = pIndex->Slots();
+		for (JsonValue* pChild = m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+			*pSlots++ = pChild;
+
+		m_oValue.Childs.m_pIndex = pIndex;
+		m_iFlags |= E_FLAG_INDEXED;
+	}
+
+	void JsonValue::IndexChilds(uint32_t iCount)
+	{
+		JsonStthmAssert((m_iFlags & (E_FLAG_LAZY | E_FLAG_INDEXED)) == 0);
+		if (m_eType == E_TYPE_OBJECT && STTHM_OBJECT_INDEX_THRESHOLD > 0 && iCount >= STTHM_OBJECT_INDEX_THRESHOLD)
+			BuildMemberIndex(iCount);
+		else if (m_eType == E_TYPE_ARRAY && STTHM_ARRAY_INDEX_THRESHOLD > 0 && iCount >= STTHM_ARRAY_INDEX_THRESHOLD)
+			BuildChildTable(iCount);
+	}
+
+	void JsonValue::BuildMemberIndex(uint32_t iCount)
+	{
+		JsonStthmAssert(m_eType == E_TYPE_OBJECT && (m_iFlags & (E_FLAG_LAZY | E_FLAG_INDEXED)) == 0);
+
+		uint32_t iCapacity = 16;
+		while (iCapacity < iCount * 2)
+			iCapacity *= 2;
+
+		const size_t iSize = sizeof(ChildIndex) + iCapacity * sizeof(JsonValue*);
+		ChildIndex* pIndex = (ChildIndex*)Internal::AllocMemory(m_pAllocator, iSize, alignof(ChildIndex));
+		if (pIndex == NULL)
+			return; // Keep linear lookup
+
+		pIndex->m_pLast = m_oValue.Childs.m_pLast;
+		pIndex->m_iCount = iCount;
+		pIndex->m_iCapacity = iCapacity;
+		JsonValue** pSlots = pIndex->Slots();
+		memset(pSlots, 0, iCapacity * sizeof(JsonValue*));
+		for (JsonValue* pChild = m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+			InsertIndexedMember(pSlots, iCapacity, pChild);
+
+		m_oValue.Childs.m_pIndex = pIndex;
+		m_iFlags |= E_FLAG_INDEXED;
+	}
+
+	bool JsonValue::InsertIndexedMember(JsonValue** pSlots, uint32_t iCapacity, JsonValue* pMember)
+	{
+		const uint32_t iMask = iCapacity - 1;
+		uint32_t iSlot = Internal::HashString(pMember->m_pName) & iMask;
+		while (pSlots[iSlot] != NULL)
+		{
+			// Keep first member when names are duplicated, like linear lookup
+			if (strcmp(pSlots[iSlot]->m_pName, pMember->m_pName) == 0)
+				return false;
+			iSlot = (iSlot + 1) & iMask;
+		}
+		pSlots[iSlot] = pMember;
+		return true;
+	}
+
+	void JsonValue::WriteStringEscaped(Internal::CharBuffer& sOutJson, const char* pInput)
+	{
+		const char* pEnd = pInput + strlen(pInput);
+		while (pInput < pEnd)
+		{
+			// Escape by blocks, writing directly in buffer
+			// A char is written with 6 chars at most (\u00XX), 4 bytes UTF-8 chars with 12 chars
+			const char* pBlockEnd = (pEnd - pInput) > 4096 ? pInput + 4096 : pEnd;
+			const size_t iSize = sOutJson.Size();
+			sOutJson.Resize(iSize + (pBlockEnd - pInput) * 6 + 6);
+			char* pOut = sOutJson.Data() + iSize;
+
+			while (pInput < pBlockEnd)
+			{
+				// Copy chars without escaping in bulk
+				if (Internal::NeedEscape(*pInput) == false)
+				{
+					const char* pEscape = Internal::FindEscape(pInput, pBlockEnd);
+					memcpy(pOut, pInput, pEscape - pInput);
+					pOut += pEscape - pInput;
+					pInput = pEscape;
+					if (pInput >= pBlockEnd)
+						break;
+				}
+
+				char cChar = *pInput;
+				if (cChar == '\n')
+				{
+					*pOut++ = '\\'; *pOut++ = 'n';
+				}
+				else if (cChar == '\r')
+				{
+					*pOut++ = '\\'; *pOut++ = 'r';
+				}
+				else if (cChar == '\t')
+				{
+					*pOut++ = '\\'; *pOut++ = 't';
+				}
+				else if (cChar == '\b')
+				{
+					*pOut++ = '\\'; *pOut++ = 'b';
+				}
+				else if (cChar == '\f')
+				{
+					*pOut++ = '\\'; *pOut++ = 'f';
+				}
+				else if (cChar == '"')
+				{
+					*pOut++ = '\\'; *pOut++ = '"';
+				}
+				else if (cChar == '\\')
+				{
+					*pOut++ = '\\'; *pOut++ = '\\';
+				}
+				else if ((unsigned char)cChar < 0x20)
+				{
+					// Other control chars
+					pOut = Internal::WriteUnicodeEscape(pOut, (unsigned char)cChar);
+				}
+				else
+				{
+					uint32_t iChar = (unsigned char)cChar;
+					const size_t iRemaining = pEnd - pInput;
+					if ((iChar & 0xE0) == 0xC0 && iRemaining >= 2) // 2 byte
+					{
+						iChar = ((((unsigned char)pInput[0]) & 0x1F) << 6)
+							+ ((((unsigned char)pInput[1]) & 0x3F) << 0);
+						pInput += 1;
+					}
+					else if ((iChar & 0xF0) == 0xE0 && iRemaining >= 3) // 3 bytes
+					{
+						iChar = ((((unsigned char)pInput[0]) & 0x0F) << 12)
+							+ ((((unsigned char)pInput[1]) & 0x3F) << 6)
+							+ ((((unsigned char)pInput[2]) & 0x3F) << 0);
+						pInput += 2;
+					}
+					else if ((iChar & 0xF8) == 0xF0 && iChar <= 0xF4 && iRemaining >= 4) // 4 bytes
+					{
+						iChar = ((((unsigned char)pInput[0]) & 0x07) << 18)
+							+ ((((unsigned char)pInput[1]) & 0x3F) << 12)
+							+ ((((unsigned char)pInput[2]) & 0x3F) << 6)
+							+ ((((unsigned char)pInput[3]) & 0x3F) << 0);
+						pInput += 3;
+					}
+					else
+					{
+						//Invalid char
+						JsonStthmAssert(false);
+						iChar = 0;
+					}
+
+					if (iChar < 0x10000)
+					{
+						pOut = Internal::WriteUnicodeEscape(pOut, iChar);
+					}
+					else
+					{
+						//UTF-16 pair surrogate
+						uint32_t iCharBis = iChar - 0x10000;
+						pOut = Internal::WriteUnicodeEscape(pOut, 0xD800 | ((iCharBis >> 10) & 0x3FF));
+						pOut = Internal::WriteUnicodeEscape(pOut, 0xDC00 | (iCharBis & 0x3FF));
+					}
+				}
+
+				++pInput;
+			}
+
+			sOutJson.Resize(pOut - sOutJson.Data());
+		}
+	}
+
+	JsonValue* JsonValue::DefaultAllocatorCreateJsonValue(Allocator* pAllocator, void* /*pUserData*/)
+	{
+		return new JsonValue(pAllocator);
+	}
+
+	void JsonValue::DefaultAllocatorDeleteJsonValue(JsonValue* pValue, void* /*pUserData*/)
+	{
+		delete pValue;
+	}
+
+	char* JsonValue::DefaultAllocatorAllocString(size_t iSize, void* /*pUserData*/)
+	{
+		return (char*)JsonStthmMalloc(iSize);
+	}
+
+	void JsonValue::DefaultAllocatorFreeString(char* pString, void* /*pUserData*/)
+	{
+		JsonStthmFree(pString);
+	}
+
+	//////////////////////////////
+	// PoolAllocator
+	//////////////////////////////
+
+	PoolAllocator::PoolAllocator(size_t iPageSize)
+		: m_iPageSize(iPageSize)
+		, m_pLastPage(NULL)
+		, m_iPageCount(0)
+		, m_iLargeStringsSize(0)
+	{
+		m_oAllocator.CreateJsonValue	= &PoolAllocator::CreateJsonValue;
+		m_oAllocator.DeleteJsonValue	= &PoolAllocator::DeleteJsonValue;
+		m_oAllocator.AllocString		= &PoolAllocator::AllocString;
+		m_oAllocator.FreeString			= &PoolAllocator::FreeString;
+		m_oAllocator.pUserData			= this;
+
+		for (int iClass = 0; iClass < c_iClassCount; ++iClass)
+		{
+			SizeClass& oClass = m_pClasses[iClass];
+			oClass.m_iSlotSize = (size_t)16 << iClass;
+			oClass.m_pFreeSlots = NULL;
+			oClass.m_pCursor = NULL;
+			oClass.m_pEnd = NULL;
+		}
+		m_pClasses[c_iValueClass].m_iSlotSize = (sizeof(JsonValue) + alignof(JsonValue) - 1) & ~(alignof(JsonValue) - 1);
+
+		JsonStthmAssert(m_iPageSize >= sizeof(Page) + 2 * m_pClasses[c_iStringClassCount - 1].m_iSlotSize);
+	}
+
+	PoolAllocator::~PoolAllocator()
+	{
+		Page* pPage = m_pLastPage;
+		while (pPage != NULL)
+		{
+			Page* pPrevious = pPage->m_pPrevious;
+			JsonStthmFree(pPage);
+			pPage = pPrevious;
+		}
+	}
+
+	size_t PoolAllocator::MemoryUsage() const
+	{
+		return m_iPageCount * m_iPageSize + m_iLargeStringsSize;
+	}
+
+	void* PoolAllocator::AllocSlot(int iClass)
+	{
+		SizeClass& oClass = m_pClasses[iClass];
+		FreeSlot* pSlot = oClass.m_pFreeSlots;
+		if (pSlot != NULL)
+		{
+			oClass.m_pFreeSlots = pSlot->m_pNext;
+			return pSlot;
+		}
+
+		if ((size_t)(oClass.m_pEnd - oClass.m_pCursor) < oClass.m_iSlotSize)
+		{
+			// Each page is used by a single class
+			Page* pPage = (Page*)JsonStthmMalloc(m_iPageSize);
+			if (pPage == NULL)
+				return NULL;
+			pPage->m_pPrevious = m_pLastPage;
+			m_pLastPage = pPage;
+			++m_iPageCount;
+
+			const size_t iHeaderSize = (sizeof(Page) + alignof(JsonValue) - 1) & ~(alignof(JsonValue) - 1);
+			oClass.m_pCursor = (char*)pPage + iHeaderSize;
+			oClass.m_pEnd = (char*)pPage + m_iPageSize;
+		}
+
+		void* pNewSlot = oClass.m_pCursor;
+		oClass.m_pCursor += oClass.m_iSlotSize;
+		return pNewSlot;
+	}
+
+	void PoolAllocator::ReleaseSlot(int iClass, void* pSlot)
+	{
+		SizeClass& oClass = m_pClasses[iClass];
+		FreeSlot* pFreeSlot = (FreeSlot*)pSlot;
+		pFreeSlot->m_pNext = oClass.m_pFreeSlots;
+		oClass.m_pFreeSlots = pFreeSlot;
+	}
+
+	JsonValue* PoolAllocator::CreateJsonValue(Allocator* pAllocator, void* pUserData)
+	{
+		void* pSlot = ((PoolAllocator*)pUserData)->AllocSlot(c_iValueClass);
+		if (pSlot == NULL)
+			return NULL;
+		return new (pSlot) JsonValue(pAllocator);
+	}
+
+	void PoolAllocator::DeleteJsonValue(JsonValue* pValue, void* pUserData)
+	{
+		pValue->~JsonValue();
+		((PoolAllocator*)pUserData)->ReleaseSlot(c_iValueClass, pValue);
+	}
+
+	char* PoolAllocator::AllocString(size_t iSize, void* pUserData)
+	{
+		PoolAllocator* pPool = (PoolAllocator*)pUserData;
+
+		// Size class is stored before the string
+		for (int iClass = 0; iClass < c_iStringClassCount; ++iClass)
+		{
+			if (iSize + 1 <= pPool->m_pClasses[iClass].m_iSlotSize)
+			{
+				unsigned char* pSlot = (unsigned char*)pPool->AllocSlot(iClass);
+				if (pSlot == NULL)
+					return NULL;
+				pSlot[0] = (unsigned char)iClass;
+				return (char*)(pSlot + 1);
+			}
+		}
+
+		size_t iAllocSize = sizeof(size_t) + 1 + iSize;
+		unsigned char* pAlloc = (unsigned char*)JsonStthmMalloc(iAllocSize);
+		if (pAlloc == NULL)
+			return NULL;
+		memcpy(pAlloc, &iAllocSize, sizeof(size_t));
+		pAlloc[sizeof(size_t)] = c_iLargeString;
+		pPool->m_iLargeStringsSize += iAllocSize;
+		return (char*)(pAlloc + sizeof(size_t) + 1);
+	}
+
+	void PoolAllocator::FreeString(char* pString, void* pUserData)
+	{
+		if (pString == NULL)
+			return;
+
+		PoolAllocator* pPool = (PoolAllocator*)pUserData;
+		unsigned char* pHeader = (unsigned char*)pString - 1;
+		if (*pHeader == c_iLargeString)
+		{
+			unsigned char* pAlloc = pHeader - sizeof(size_t);
+			size_t iAllocSize;
+			memcpy(&iAllocSize, pAlloc, sizeof(size_t));
+			pPool->m_iLargeStringsSize -= iAllocSize;
+			JsonStthmFree(pAlloc);
+			return;
+		}
+
+		JsonStthmAssert(*pHeader < c_iStringClassCount);
+		pPool->ReleaseSlot(*pHeader, pHeader);
 	}
 
-	bool JsonValue::ToBoolean() const
+	//////////////////////////////
+	// BlockPool
+	//////////////////////////////
+
+	BlockPool::BlockPool(size_t iBlockSize, size_t iMaxSize)
+		: m_iBlockSize(iBlockSize)
+		, m_iMaxSize(iMaxSize)
+		, m_pFirstBlock(NULL)
+		, m_iBlockCount(0)
 	{
-		if (m_eType == E_TYPE_BOOLEAN)
-			return m_oValue.Boolean;
-		return false;
 	}
 
-	int64_t JsonValue::ToInteger() const
+	BlockPool::~BlockPool()
+	{
+		Clear();
+	}
+
+	void BlockPool::Clear()
+	{
+		while (m_pFirstBlock != NULL)
+		{
+			FreeBlock* pNext = m_pFirstBlock->m_pNext;
+			JsonStthmFree(m_pFirstBlock);
+			m_pFirstBlock = pNext;
+		}
+		m_iBlockCount = 0;
+	}
+
+	void BlockPool::SetMaxSize(size_t iMaxSize)
+	{
+		m_iMaxSize = iMaxSize;
+		while (m_pFirstBlock != NULL && GetSize() > m_iMaxSize)
+		{
+			FreeBlock* pNext = m_pFirstBlock->m_pNext;
+			JsonStthmFree(m_pFirstBlock);
+			m_pFirstBlock = pNext;
+			--m_iBlockCount;
+		}
+	}
+
+	void* BlockPool::Take()
+	{
+		FreeBlock* pBlock = m_pFirstBlock;
+		if (pBlock != NULL)
+		{
+			m_pFirstBlock = pBlock->m_pNext;
+			--m_iBlockCount;
+		}
+		return pBlock;
+	}
+
+	bool BlockPool::Release(void* pBlock)
+	{
+		if (GetSize() + m_iBlockSize > m_iMaxSize)
+			return false;
+
+		FreeBlock* pFreeBlock = (FreeBlock*)pBlock;
+		pFreeBlock->m_pNext = m_pFirstBlock;
+		m_pFirstBlock = pFreeBlock;
+		++m_iBlockCount;
+		return true;
+	}
+
+	BlockPool& BlockPool::GetThreadPool()
+	{
+#if defined(STTHM_USE_THREADS)
+		static thread_local BlockPool s_oPool;
+#else
+		static BlockPool s_oPool;
+#endif //STTHM_USE_THREADS
+		return s_oPool;
+	}
+
+	//////////////////////////////
+	// JsonDoc
+	//////////////////////////////
+
+	JsonDoc::JsonDoc(size_t iBlockSize)
+		: m_oRoot(&m_oAllocator)
+		, m_iBlockSize(iBlockSize)
+		, m_pLastBlock(NULL)
+		, m_oRetainedBlocks(iBlockSize, 0)
+		, m_pBlockPool(&m_oRetainedBlocks)
+		, m_pFileContent(NULL)
+		, m_iFileSize(0)
+		, m_bFileMapped(false)
+		, m_pLazyJson(NULL)
+		, m_pLazyJsonEnd(NULL)
+		, m_pLazyError(NULL)
+	{
+		m_oAllocator.CreateJsonValue	= &JsonDoc::CreateJsonValue;
+		m_oAllocator.DeleteJsonValue	= &JsonDoc::DeleteJsonValue;
+		m_oAllocator.AllocString		= &JsonDoc::AllocString;
+		m_oAllocator.FreeString			= &JsonDoc::FreeString;
+		m_oAllocator.pUserData			= this;
+	}
+
+	JsonDoc::~JsonDoc()
+	{
+		Clear();
+		for (size_t iWorker = 0; iWorker < m_oWorkerDocs.Size(); ++iWorker)
+			delete m_oWorkerDocs.Data()[iWorker];
+	}
+
+	void JsonDoc::Clear()
+	{
+		m_oRoot.m_eType = JsonValue::E_TYPE_NULL;
+		m_oRoot.m_iFlags = 0;
+		m_pLazyJson = m_pLazyJsonEnd = m_pLazyError = NULL;
+		for (size_t iWorker = 0; iWorker < m_oWorkerDocs.Size(); ++iWorker)
+			m_oWorkerDocs.Data()[iWorker]->Clear();
+		if (m_pFileContent != NULL)
+		{
+			Internal::FreeFileContent(m_pFileContent, m_iFileSize, m_bFileMapped);
+			m_pFileContent = NULL;
+			m_iFileSize = 0;
+			m_bFileMapped = false;
+		}
+		Block* pBlock = m_pLastBlock;
+		while (pBlock != NULL)
+		{
+			Block* pPrevious = pBlock->m_pPrevious;
+			if (pBlock->m_iSize != m_iBlockSize || m_pBlockPool->Release(pBlock) == false)
+				JsonStthmFree(pBlock);
+			pBlock = pPrevious;
+		}
+		m_pLastBlock = NULL;
+	}
+
+	int JsonDoc::GetLazyError() const
+	{
+		if (m_pLazyError == NULL)
+			return 0;
+		return Internal::GetErrorLine(m_pLazyJson, m_pLazyJsonEnd, m_pLazyError);
+	}
+
+	void JsonDoc::SetLazyError(JsonDoc* pDoc, const char* pError)
+	{
+		// Keep first error
+		if (pDoc->m_pLazyError == NULL && pError >= pDoc->m_pLazyJson && pError <= pDoc->m_pLazyJsonEnd)
+			pDoc->m_pLazyError = pError;
+	}
+
+	void JsonDoc::SetRetainedSize(size_t iMaxSize)
+	{
+		m_oRetainedBlocks.SetMaxSize(iMaxSize);
+		for (size_t iWorker = 0; iWorker < m_oWorkerDocs.Size(); ++iWorker)
+			m_oWorkerDocs.Data()[iWorker]->SetRetainedSize(iMaxSize);
+	}
+
+	void JsonDoc::SetBlockPool(BlockPool* pPool)
+	{
+		JsonStthmAssert(pPool == NULL || pPool->GetBlockSize() == m_iBlockSize);
+		if (pPool != NULL && pPool->GetBlockSize() != m_iBlockSize)
+			return;
+
+		// Blocks in use are released to the new pool
+		m_pBlockPool = (pPool != NULL) ? pPool : &m_oRetainedBlocks;
+		if (pPool != NULL)
+			m_oRetainedBlocks.Clear();
+	}
+
+	int JsonDoc::ReadString(const char* pJson, const char* pJsonEnd, EParseMode eMode)
+	{
+		Clear();
+
+		if (pJson == NULL)
+			return -1;
+
+		if (pJsonEnd == NULL)
+			pJsonEnd = pJson + strlen(pJson);
+
+		return Parse(pJson, pJsonEnd, eMode, 0);
+	}
+
+	int JsonDoc::ReadStringInsitu(char* pJson, char* pJsonEnd, EParseMode eMode)
+	{
+		Clear();
+
+		if (pJson == NULL)
+			return -1;
+
+		if (pJsonEnd == NULL)
+			pJsonEnd = pJson + strlen(pJson);
+
+		// Not with lazy parsing, containers content is parsed again on access
+		return Parse(pJson, pJsonEnd, eMode, eMode != E_PARSE_MODE_LAZY ? JsonValue::E_PARSE_FLAG_INSITU : 0);
+	}
+
+	int JsonDoc::ReadFile(const char* pFilename, EParseMode eMode)
+	{
+		Clear();
+
+		char* pString;
+		size_t iSize;
+		bool bMapped;
+		// Recursive parser is slower on a mapped file when writing strings in place, file is read in a buffer for it
+		int iError = Internal::ReadFileContent(pFilename, &pString, &iSize, eMode != E_PARSE_MODE_DEFAULT, &bMapped);
+		if (iError != 0)
+			return iError;
+
+		// Content is owned by the document, strings can be read in place
+		// Not with lazy parsing, containers content is parsed again on access
+		m_pFileContent = pString;
+		m_iFileSize = iSize;
+		m_bFileMapped = bMapped;
+
+		return Parse(pString, pString + iSize, eMode, eMode != E_PARSE_MODE_LAZY ? JsonValue::E_PARSE_FLAG_INSITU : 0);
+	}
+
+	int JsonDoc::ReadMsgPack(const void* pData, size_t iSize)
+	{
+		Clear();
+
+		if (pData == NULL)
+			return -1;
+
+		const uint8_t* pCursor = (const uint8_t*)pData;
+		if (m_oRoot.ParseMsgPack(pCursor, pCursor + iSize) == false || pCursor != (const uint8_t*)pData + iSize)
+			return (int)(pCursor - (const uint8_t*)pData) + 1;
+		return 0;
+	}
+
+	int JsonDoc::Parse(const char* pJson, const char* pJsonEnd, EParseMode eMode, int iParseFlags)
+	{
+		// Offsets of structural index are 32 bits
+		if (eMode == E_PARSE_MODE_STRUCTURAL_INDEX && (size_t)(pJsonEnd - pJson) < (size_t)0xFFFFFFFF)
+		{
+			Internal::Buffer<uint32_t> oIndex;
+			oIndex.Reserve((pJsonEnd - pJson) / 8 + 64);
+
+			Internal::BuildStructuralIndex(pJson, pJsonEnd, oIndex);
+
+			const char* pError = NULL;
+			if (ParseStructuralIndex(pJson, pJsonEnd, oIndex.Data(), oIndex.Size(), iParseFlags, pError) == false)
+				return Internal::GetErrorLine(pJson, pJsonEnd, pError);
+
+			return 0;
+		}
+		else if (eMode == E_PARSE_MODE_LAZY)
+		{
+			iParseFlags |= JsonValue::E_PARSE_FLAG_LAZY;
+			m_pLazyJson = pJson;
+			m_pLazyJsonEnd = pJsonEnd;
+		}
+		else if (eMode == E_PARSE_MODE_PARALLEL)
+		{
+			const char* pError = NULL;
+			if (ParseParallel(pJson, pJsonEnd, iParseFlags, pError))
+				return (pError != NULL) ? Internal::GetErrorLine(pJson, pJsonEnd, pError) : 0;
+		}
+
+		const char* pCursor = pJson;
+		if (m_oRoot.Parse(pCursor, pJsonEnd, iParseFlags) == false)
+			return Internal::GetErrorLine(pJson, pJsonEnd, pCursor);
+		return 0;
+	}
+
+	bool JsonDoc::ParseStructuralIndex(const char* pJson, const char* pEnd, const uint32_t* pIndex, size_t iIndexCount, int iParseFlags, const char*& pError)
+	{
+		const bool bInsitu = (iParseFlags & JsonValue::E_PARSE_FLAG_INSITU) != 0;
+
+		// Stage two : walk the structural index to build the tree without recursion
+		Internal::Buffer<JsonValue*, 64> oStack;
+		// Childs count of containers in oStack
+		Internal::Buffer<uint32_t, 64> oCounts;
+		size_t iCursor = 0;
+		JsonValue* pValue = &m_oRoot;
+
+		if (iIndexCount == 0)
+			return true;
+
+		while (true)
+		{
+			// Read a value
+			const char* pToken = pJson + pIndex[iCursor++];
+			pError = pToken;
+			bool bValueDone = true;
+			if (*pToken == '{' || *pToken == '[')
+			{
+				const bool bObject = *pToken == '{';
+				pValue->InitType(bObject ? JsonValue::E_TYPE_OBJECT : JsonValue::E_TYPE_ARRAY);
+				if (iCursor < iIndexCount && pJson[pIndex[iCursor]] == (bObject ? '}' : ']'))
+				{
+					++iCursor;
+				}
+				else
+				{
+					oStack.Push(pValue);
+					oCounts.Push(0);
+					bValueDone = false;
+				}
+			}
+			else if (*pToken == '"')
+			{
+				const char* pString = pToken + 1;
+				char* pNewString = JsonValue::ReadStringValue(pString, pEnd, &m_oAllocator, bInsitu);
+				if (pNewString == NULL)
+					return false;
+				pValue->InitType(JsonValue::E_TYPE_STRING);
+				pValue->m_oValue.String = pNewString;
+			}
+			else
+			{
+				const char* pScalarEnd = pToken;
+				if (pValue->Parse(pScalarEnd, pEnd) == false)
+					return false;
+
+				// Scalar in container should end right before next structural char
+				Internal::SkipSpaces(pScalarEnd, pEnd);
+				if (oStack.Size() > 0 && (iCursor >= iIndexCount || pScalarEnd != pJson + pIndex[iCursor]))
+				{
+					pError = pScalarEnd;
+					return false;
+				}
+			}
+
+			// Close finished containers until a new value is expected
+			while (bValueDone)
+			{
+				if (oStack.Size() == 0)
+					return true; // Root value read
+
+				if (iCursor >= iIndexCount)
+				{
+					pError = pEnd;
+					return false;
+				}
+
+				JsonValue* pParent = oStack.Data()[oStack.Size() - 1];
+				const char cChar = pJson[pIndex[iCursor]];
+				if (cChar == ',')
+				{
+					++iCursor;
+					bValueDone = false;
+				}
+				else if (cChar == (pParent->IsObject() ? '}' : ']'))
+				{
+					++iCursor;
+					pParent->IndexChilds(oCounts.Data()[oCounts.Size() - 1]);
+					oStack.Resize(oStack.Size() - 1);
+					oCounts.Resize(oCounts.Size() - 1);
+				}
+				else
+				{
+					pError = pJson + pIndex[iCursor];
+					return false;
+				}
+			}
+
+			// Create next child of current container
+			JsonValue* pParent = oStack.Data()[oStack.Size() - 1];
+			pValue = CreateJsonValue(&m_oAllocator, this);
+			if (pParent->IsObject())
+			{
+				if (iCursor + 1 >= iIndexCount || pJson[pIndex[iCursor]] != '"' || pJson[pIndex[iCursor + 1]] != ':')
+				{
+					pError = (iCursor < iIndexCount) ? pJson + pIndex[iCursor] : pEnd;
+					return false;
+				}
+
+				const char* pName = pJson + pIndex[iCursor] + 1;
+				pError = pName;
+				pValue->m_pName = JsonValue::ReadStringValue(pName, pEnd, &m_oAllocator, bInsitu);
+				if (pValue->m_pName == NULL)
+					return false;
+				iCursor += 2;
+			}
+
+			if (pParent->m_oValue.Childs.m_pFirst == NULL)
+				pParent->m_oValue.Childs.m_pFirst = pValue;
+			else
+				pParent->m_oValue.Childs.m_pLast->m_pNext = pValue;
+			pParent->m_oValue.Childs.m_pLast = pValue;
+			++oCounts.Data()[oCounts.Size() - 1];
+
+			if (iCursor >= iIndexCount)
+			{
+				pError = pEnd;
+				return false;
+			}
+		}
+	}
+
+	bool JsonDoc::ParseParallel(const char* pJson, const char* pEnd, int iParseFlags, const char*& pError)
+	{
+		// Chunks should be big enough to be worth a thread
+		const size_t c_iMinChunkSize = 64 * 1024;
+		const size_t iThreadCount = Internal::GetThreadCount();
+		const size_t iSize = pEnd - pJson;
+		if (iThreadCount <= 1 || iSize < 2 * c_iMinChunkSize)
+			return false;
+
+		const char* pCursor = pJson;
+		Internal::SkipSpaces(pCursor, pEnd);
+		if (pCursor >= pEnd || *pCursor != '[')
+			return false;
+		++pCursor;
+
+		// Several chunks per thread to balance elements of different sizes
+		size_t iChunkSize = iSize / (iThreadCount * 4);
+		if (iChunkSize < c_iMinChunkSize)
+			iChunkSize = c_iMinChunkSize;
+
+		// Pre-scan : split root array after commas following top level elements, only strings and braces are checked
+		// Elements are only split after a string or a container, an array of numbers stays in one chunk
+		Internal::Buffer<ParallelChunk, 64> oChunks;
+		ParallelChunk oChunk;
+		memset(&oChunk, 0, sizeof(oChunk));
+		oChunk.m_pBegin = pCursor;
+		const char* pNextSplit = pCursor + iChunkSize;
+		int iDepth = 1;
+		while (true)
+		{
+			pCursor = Internal::FindBracket(pCursor, pEnd);
+			if (pCursor >= pEnd || *pCursor == 0)
+				return false;
+
+			const char cChar = *pCursor++;
+			if (cChar == '"')
+			{
+				if (Internal::SkipString(pCursor, pEnd) == false)
+					return false;
+			}
+			else if (cChar == '{' || cChar == '[')
+			{
+				++iDepth;
+				continue;
+			}
+			else if (--iDepth == 0)
+			{
+				break;
+			}
+
+			if (iDepth == 1 && pCursor >= pNextSplit)
+			{
+				const char* pComma = pCursor;
+				Internal::SkipSpaces(pComma, pEnd);
+				if (pComma < pEnd && *pComma == ',')
+				{
+					oChunk.m_pEnd = pComma + 1;
+					oChunks.Push(oChunk);
+					oChunk.m_pBegin = oChunk.m_pEnd;
+					pNextSplit = oChunk.m_pBegin + iChunkSize;
+				}
+			}
+		}
+
+		if (oChunks.Size() == 0)
+			return false;
+
+		oChunk.m_pEnd = pEnd;
+		oChunks.Push(oChunk);
+
+		// One arena per worker, workers run on other threads and can't use a shared pool
+		size_t iWorkerCount = (iThreadCount < oChunks.Size()) ? iThreadCount : oChunks.Size();
+		while (m_oWorkerDocs.Size() < iWorkerCount)
+		{
+			JsonDoc* pWorkerDoc = new JsonDoc(m_iBlockSize);
+			pWorkerDoc->SetRetainedSize(m_oRetainedBlocks.GetMaxSize());
+			m_oWorkerDocs.Push(pWorkerDoc);
+		}
+
+		ParallelContext oContext;
+		oContext.m_pDoc = this;
+		oContext.m_pChunks = oChunks.Data();
+		oContext.m_iChunkCount = oChunks.Size();
+		oContext.m_iParseFlags = iParseFlags;
+		Internal::RunWorkers(iWorkerCount, &JsonDoc::ParseParallelChunks, &oContext);
+
+		// Stitch chunks elements in root
+		m_oRoot.InitType(JsonValue::E_TYPE_ARRAY);
+		JsonValue::JsonChilds& oChilds = m_oRoot.m_oValue.Childs;
+		for (size_t iChunk = 0; iChunk < oChunks.Size(); ++iChunk)
+		{
+			const ParallelChunk& oParsedChunk = oChunks.Data()[iChunk];
+			if (oParsedChunk.m_pError != NULL)
+			{
+				m_oRoot.m_eType = JsonValue::E_TYPE_NULL;
+				pError = oParsedChunk.m_pError;
+				return true;
+			}
+
+			if (oChilds.m_pFirst == NULL)
+				oChilds.m_pFirst = oParsedChunk.m_pFirst;
+			else
+				oChilds.m_pLast->m_pNext = oParsedChunk.m_pFirst;
+			oChilds.m_pLast = oParsedChunk.m_pLast;
+		}
+		m_oRoot.BuildIndex();
+		return true;
+	}
+
+	void JsonDoc::ParseParallelChunks(size_t iWorker, size_t iWorkerCount, void* pUserData)
+	{
+		ParallelContext* pContext = (ParallelContext*)pUserData;
+		Allocator* pAllocator = &pContext->m_pDoc->m_oWorkerDocs.Data()[iWorker]->m_oAllocator;
+
+		// Chunks are shared round robin
+		for (size_t iChunk = iWorker; iChunk < pContext->m_iChunkCount; iChunk += iWorkerCount)
+		{
+			ParallelChunk& oChunk = pContext->m_pChunks[iChunk];
+			const bool bLastChunk = (iChunk + 1) == pContext->m_iChunkCount;
+			const char* pString = oChunk.m_pBegin;
+			while (true)
+			{
+				JsonValue* pValue = pAllocator->CreateJsonValue(pAllocator, pAllocator->pUserData);
+				if (pValue->Parse(pString, oChunk.m_pEnd, pContext->m_iParseFlags) == false)
+				{
+					oChunk.m_pError = pString;
+					break;
+				}
+
+				if (oChunk.m_pFirst == NULL)
+					oChunk.m_pFirst = pValue;
+				else
+					oChunk.m_pLast->m_pNext = pValue;
+				oChunk.m_pLast = pValue;
+
+				Internal::SkipSpaces(pString, oChunk.m_pEnd);
+				if (pString < oChunk.m_pEnd && *pString == ',')
+				{
+					// Other chunks end after a comma
+					if (++pString == oChunk.m_pEnd && bLastChunk == false)
+						break;
+				}
+				else if (pString < oChunk.m_pEnd && *pString == ']' && bLastChunk)
+				{
+					break;
+				}
+				else
+				{
+					oChunk.m_pError = pString;
+					break;
+				}
+			}
+		}
+	}
+
+	void* JsonDoc::Allocate(JsonDoc* pDoc, size_t iSize, size_t iAlign)
 	{
-		if (m_eType == E_TYPE_INTEGER)
-			return m_oValue.Integer;
-		else if (m_eType == E_TYPE_FLOAT)
-			return (int64_t)m_oValue.Float;
-		return 0;
-	}
+		Block* pHead = pDoc->m_pLastBlock;
+		if (pHead != NULL && (iSize + iAlign + pHead->m_iUsed) <= pDoc->m_iBlockSize)
+		{
+			char* pMem = ((char*)pHead) + pHead->m_iUsed;
+			size_t iAlignOffset = iAlign - ((intptr_t)pMem % iAlign);
+			pMem += iAlignOffset;
 
-	double JsonValue::ToFloat() const
-	{
-		if (m_eType == E_TYPE_FLOAT)
-			return m_oValue.Float;
-		else if (m_eType == E_TYPE_INTEGER)
-			return (double)m_oValue.Integer;
-		return 0.0;
+			JsonStthmAssert((intptr_t)pMem % iAlign == 0);
+
+			pHead->m_iUsed += iSize + iAlignOffset;
+			return pMem;
+		}
+
+		size_t iAllocSize = sizeof(Block) + iSize + iAlign;
+		size_t iBlockSize = (iAllocSize <= pDoc->m_iBlockSize) ? pDoc->m_iBlockSize : iAllocSize;
+		Block* pBlock = NULL;
+		if (iBlockSize == pDoc->m_iBlockSize)
+			pBlock = (Block*)pDoc->m_pBlockPool->Take();
+		if (pBlock == NULL)
+			pBlock = (Block*)JsonStthmMalloc(iBlockSize);
+
+		char* pMem = (char*)(pBlock + 1);
+		size_t iAlignOffset = iAlign - ((intptr_t)pMem % iAlign);
+		pMem += iAlignOffset;
+
+		pBlock->m_iUsed = sizeof(Block) + iSize + iAlignOffset;
+		pBlock->m_iSize = iBlockSize;
+
+		// Big allocations are inserted behind current block which is not full yet
+		if (iBlockSize == pDoc->m_iBlockSize || pHead == NULL)
+		{
+			pBlock->m_pPrevious = pHead;
+			pDoc->m_pLastBlock = pBlock;
+		}
+		else
+		{
+			pBlock->m_pPrevious = pHead->m_pPrevious;
+			pHead->m_pPrevious = pBlock;
+		}
+
+		JsonStthmAssert((intptr_t)pMem % iAlign == 0);
+
+		return pMem;
 	}
 
-#ifdef STTHM_ENABLE_IMPLICIT_CAST
-	JsonValue::operator const char*() const
+	JsonValue* JsonDoc::CreateJsonValue(Allocator* pAllocator, void* pUserData)
 	{
-		return ToString();
+		JsonValue* pValue = (JsonValue*)Allocate((JsonDoc*)pUserData, sizeof(JsonValue), alignof(JsonValue));
+		if (pValue != NULL)
+		{
+			memset(pValue, 0, sizeof(JsonValue));
+			pValue->m_pAllocator = pAllocator;
+			return pValue;
+		}
+		return NULL;
 	}
 
-	JsonValue::operator bool() const
+	void JsonDoc::DeleteJsonValue(JsonValue* /*pValue*/, void* /*pUserData*/)
 	{
-		return ToBoolean();
+		// Do nothing
 	}
 
-	JsonValue::operator int64_t() const
+	char* JsonDoc::AllocString(size_t iSize, void* pUserData)
 	{
-		return ToInteger();
+		return (char*)Allocate((JsonDoc*)pUserData, iSize, 1);
 	}
 
-	JsonValue::operator double() const
+	void JsonDoc::FreeString(char* /*pString*/, void* /*pUserData*/)
 	{
-		return ToFloat();
+		// Do nothing
 	}
-#endif //STTHM_ENABLE_IMPLICIT_CAST
 
-	void JsonValue::SetString(const char* pValue, const char* pEnd)
+	size_t JsonDoc::MemoryUsage() const
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return;
-
-		if (NULL != pValue)
-		{
-			InitType(E_TYPE_STRING);
-			SetStringValue(pValue, pEnd);
-		}
-		else
+		Block* pBlock = m_pLastBlock;
+		size_t iSize = 0;
+		for (size_t iWorker = 0; iWorker < m_oWorkerDocs.Size(); ++iWorker)
+			iSize += m_oWorkerDocs.Data()[iWorker]->MemoryUsage();
+		while (pBlock != NULL)
 		{
-			InitType(E_TYPE_NULL);
+			iSize += pBlock->m_iSize;
+			pBlock = pBlock->m_pPrevious;
 		}
+		return iSize;
 	}
 
-	void JsonValue::SetBoolean(bool bValue)
-	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return;
+	//////////////////////////////
+	// JsonLinesDoc
+	//////////////////////////////
 
-		InitType(E_TYPE_BOOLEAN);
-		m_oValue.Boolean = bValue;
+	JsonLinesDoc::JsonLinesDoc(int iThreadCount, size_t iBlockSize)
+		: m_iThreadCount(iThreadCount)
+		, m_iBlockSize(iBlockSize)
+		, m_iCount(0)
+		, m_iParseFlags(0)
+		, m_pFileContent(NULL)
+		, m_iFileSize(0)
+		, m_bFileMapped(false)
+	{
+		if (m_iThreadCount <= 0)
+			m_iThreadCount = (int)Internal::GetThreadCount();
 	}
 
-	void JsonValue::SetInteger(int64_t iValue)
+	JsonLinesDoc::~JsonLinesDoc()
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return;
-
-		InitType(E_TYPE_INTEGER);
-		m_oValue.Integer = iValue;
+		Clear();
 	}
 
-	void JsonValue::SetFloat(double fValue)
+	void JsonLinesDoc::Clear()
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return;
+		for (size_t iChunk = 0; iChunk < m_oChunks.Size(); ++iChunk)
+			delete m_oChunks.Data()[iChunk];
+		m_oChunks.Clear();
+		m_iCount = 0;
 
-		InitType(E_TYPE_FLOAT);
-		m_oValue.Float = fValue;
+		if (m_pFileContent != NULL)
+		{
+			Internal::FreeFileContent(m_pFileContent, m_iFileSize, m_bFileMapped);
+			m_pFileContent = NULL;
+			m_iFileSize = 0;
+			m_bFileMapped = false;
+		}
 	}
 
-	JsonValue& JsonValue::Append()
+	int JsonLinesDoc::ReadString(const char* pJson, const char* pJsonEnd)
 	{
-		JsonStthmAssert(this != &INVALID);
-		if (this == &INVALID)
-			return INVALID;
+		Clear();
 
-		if (m_eType == E_TYPE_NULL)
-			InitType(E_TYPE_ARRAY);
+		if (pJson == NULL)
+			return -1;
 
-		if (m_eType != E_TYPE_ARRAY)
-			return INVALID;
+		if (pJsonEnd == NULL)
+			pJsonEnd = pJson + strlen(pJson);
 
-		// Append new element
-		JsonValue* pNewChild = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+		return Parse(pJson, pJsonEnd, 0);
+	}
 
-		if (NULL != m_oValue.Childs.m_pLast)
-			m_oValue.Childs.m_pLast->m_pNext = pNewChild;
-		else
-			m_oValue.Childs.m_pFirst = pNewChild;
+	int JsonLinesDoc::ReadFile(const char* pFilename)
+	{
+		Clear();
 
-		m_oValue.Childs.m_pLast = pNewChild;
+		char* pString;
+		size_t iSize;
+		bool bMapped;
+		int iError = Internal::ReadFileContent(pFilename, &pString, &iSize, true, &bMapped);
+		if (iError != 0)
+			return iError;
 
-		return *m_oValue.Childs.m_pLast;
+		m_pFileContent = pString;
+		m_iFileSize = iSize;
+		m_bFileMapped = bMapped;
+
+		return Parse(pString, pString + iSize, JsonValue::E_PARSE_FLAG_INSITU);
 	}
 
-	bool JsonValue::Combine(const JsonValue& oRight, bool bMergeSubMembers)
+	const JsonValue& JsonLinesDoc::GetValue(size_t iIndex) const
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return false;
-
-		if (m_eType != oRight.m_eType)
-			return false;
+		if (iIndex >= m_iCount)
+			return JsonValue::INVALID;
 
-		switch(m_eType)
-		{
-		case E_TYPE_NULL:
-			// Nothing to do
-			break;
-		case E_TYPE_OBJECT:
-		{
-			// Replace value or try to add recursively values of sub objects
-			for (const JsonValue* pChild =  oRight.m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
-			{
-				JsonValue& oLeftChild = (*this)[pChild->m_pName];
-				if (bMergeSubMembers && oLeftChild.m_eType == pChild->m_eType) // Combine again is the childrens's type is the same otherwise replace it
-				{
-					(*this)[pChild->m_pName].Combine(*pChild, true);
-				}
-				else
-				{
-					(*this)[pChild->m_pName] = *pChild;
-				}
-			}
-			break;
-		}
-		case E_TYPE_ARRAY:
+		// Last chunk starting at or before iIndex
+		Chunk* const* pChunks = m_oChunks.Data();
+		size_t iLow = 0;
+		size_t iHigh = m_oChunks.Size() - 1;
+		while (iLow < iHigh)
 		{
-			// Append to array
-			for (const JsonValue* pChild = oRight.m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
-			{
-				Append() = *pChild;
-			}
-			break;
+			size_t iMiddle = (iLow + iHigh + 1) / 2;
+			if (pChunks[iMiddle]->m_iFirst <= iIndex)
+				iLow = iMiddle;
+			else
+				iHigh = iMiddle - 1;
 		}
-		case E_TYPE_STRING:
+		return *pChunks[iLow]->m_oValues.Data()[iIndex - pChunks[iLow]->m_iFirst];
+	}
+
+	size_t JsonLinesDoc::MemoryUsage() const
+	{
+		size_t iSize = 0;
+		for (size_t iChunk = 0; iChunk < m_oChunks.Size(); ++iChunk)
 		{
-			// Concatenate strings
-			size_t iLenLeft = strlen(m_oValue.String);
-			size_t iLenRight = strlen(oRight.m_oValue.String);
-			size_t iLenNew = iLenLeft + iLenRight;
-			char* pNewString = m_pAllocator->AllocString(iLenNew + 1, m_pAllocator->pUserData);
-			memcpy(pNewString, m_oValue.String, iLenLeft);
-			memcpy(pNewString + iLenLeft, oRight.m_oValue.String, iLenRight);
-			pNewString[iLenNew] = 0;
-			m_pAllocator->FreeString(m_oValue.String, m_pAllocator->pUserData);
-			m_oValue.String = pNewString;
-			break;
-		}
-		case E_TYPE_BOOLEAN:
-			m_oValue.Boolean = m_oValue.Boolean || oRight.m_oValue.Boolean;
-			break;
-		case E_TYPE_INTEGER:
-			m_oValue.Integer += oRight.m_oValue.Integer;
-			break;
-		case E_TYPE_FLOAT:
-			m_oValue.Float += oRight.m_oValue.Float;
-			break;
+			const Chunk* pChunk = m_oChunks.Data()[iChunk];
+			iSize += pChunk->m_oDoc.MemoryUsage() + pChunk->m_oValues.Capacity() * sizeof(JsonValue*);
 		}
-
-		return true;
+		return iSize;
 	}
 
-	bool JsonValue::operator ==(const JsonValue& oRight) const
+	int JsonLinesDoc::Parse(const char* pJson, const char* pJsonEnd, int iParseFlags)
 	{
-		if (m_eType != oRight.m_eType)
-			return false;
-
-		switch (m_eType)
-		{
-		case E_TYPE_NULL:
-			break;
-		case E_TYPE_OBJECT:
+		// Several chunks per thread to balance lines of different lengths, but not too small ones
+		const size_t c_iMinChunkSize = 64 * 1024;
+		size_t iSize = pJsonEnd - pJson;
+		size_t iChunkCount = 1;
+		if (m_iThreadCount > 1)
 		{
-			// We don't care if members order is not the same
-			const JsonValue* pChildLeft = m_oValue.Childs.m_pFirst;
-			while (pChildLeft != NULL)
-			{
-				if (*pChildLeft != oRight[pChildLeft->m_pName])
-					return false;
-
-				pChildLeft = pChildLeft->m_pNext;
-			}
-			break;
+			iChunkCount = (size_t)m_iThreadCount * 4;
+			if (iChunkCount > iSize / c_iMinChunkSize + 1)
+				iChunkCount = iSize / c_iMinChunkSize + 1;
 		}
-		case E_TYPE_ARRAY:
+
+		const char* pBegin = pJson;
+		for (size_t iChunk = 1; iChunk <= iChunkCount && pBegin < pJsonEnd; ++iChunk)
 		{
-			JsonValue* pChildLeft = m_oValue.Childs.m_pFirst;
-			JsonValue* pChildRight = oRight.m_oValue.Childs.m_pFirst;
-			while (pChildLeft != NULL && pChildRight != NULL)
+			const char* pEnd = pJsonEnd;
+			if (iChunk < iChunkCount)
 			{
-				if (*pChildLeft != *pChildRight)
-					return false;
-
-				pChildLeft = pChildLeft->m_pNext;
-				pChildRight = pChildRight->m_pNext;
+				// Chunks end after a new line
+				pEnd = pJson + (iSize / iChunkCount) * iChunk;
+				if (pEnd < pBegin)
+					pEnd = pBegin;
+				const char* pNewLine = (const char*)memchr(pEnd, '\n', pJsonEnd - pEnd);
+				pEnd = (pNewLine != NULL) ? pNewLine + 1 : pJsonEnd;
 			}
 
-			if (pChildLeft != NULL || pChildRight != NULL)
-				return false;
-			break;
-		}
-		case E_TYPE_STRING:
-			if (strcmp(m_oValue.String, oRight.m_oValue.String) != 0)
-				return false;
-			break;
-		case E_TYPE_BOOLEAN:
-			if (memcmp(&m_oValue.Boolean, &oRight.m_oValue.Boolean, sizeof(m_oValue.Boolean)) != 0)
-				return false;
-			break;
-		case E_TYPE_INTEGER:
-			if (memcmp(&m_oValue.Integer, &oRight.m_oValue.Integer, sizeof(m_oValue.Integer)) != 0)
-				return false;
-			break;
-		case E_TYPE_FLOAT:
-			if (memcmp(&m_oValue.Float, &oRight.m_oValue.Float, sizeof(m_oValue.Float)) != 0)
-				return false;
-			break;
+			Chunk* pChunk = new Chunk(m_iBlockSize);
+			pChunk->m_pBegin = pBegin;
+			pChunk->m_pEnd = pEnd;
+			m_oChunks.Push(pChunk);
+			pBegin = pEnd;
 		}
 
-		return true;
+		size_t iWorkerCount = (size_t)m_iThreadCount;
+		if (iWorkerCount > m_oChunks.Size())
+			iWorkerCount = m_oChunks.Size();
+
+		m_iParseFlags = iParseFlags;
+		Internal::RunWorkers(iWorkerCount, &JsonLinesDoc::ParseChunks, this);
+
+		for (size_t iChunk = 0; iChunk < m_oChunks.Size(); ++iChunk)
+		{
+			Chunk* pChunk = m_oChunks.Data()[iChunk];
+			if (pChunk->m_pError != NULL)
+			{
+				int iLine = Internal::GetErrorLine(pJson, pJsonEnd, pChunk->m_pError);
+				Clear();
+				return iLine;
+			}
+			pChunk->m_iFirst = m_iCount;
+			m_iCount += pChunk->m_oValues.Size();
+		}
+		return 0;
 	}
 
-	bool JsonValue::operator !=(const JsonValue& oRight) const
+	void JsonLinesDoc::ParseChunks(size_t iWorker, size_t iWorkerCount, void* pUserData)
 	{
-		return (*this == oRight) == false;
+		// Chunks are shared round robin
+		JsonLinesDoc* pDoc = (JsonLinesDoc*)pUserData;
+		for (size_t iChunk = iWorker; iChunk < pDoc->m_oChunks.Size(); iChunk += iWorkerCount)
+			ParseChunk(pDoc->m_oChunks.Data()[iChunk], pDoc->m_iParseFlags);
 	}
 
-	const JsonValue& JsonValue::operator[](const char* pName) const
+	void JsonLinesDoc::ParseChunk(Chunk* pChunk, int iParseFlags)
 	{
-		if (m_eType == E_TYPE_OBJECT)
+		Allocator* pAllocator = &pChunk->m_oDoc.m_oAllocator;
+		const char* pString = pChunk->m_pBegin;
+		const char* pEnd = pChunk->m_pEnd;
+		while (true)
 		{
-			JsonValue* pChild = m_oValue.Childs.m_pFirst;
-			while (pChild != NULL)
+			Internal::SkipSpaces(pString, pEnd);
+			if (pString >= pEnd || *pString == 0)
+				return;
+
+			// Value is parsed up to the end of its line only, whatever the chunks are
+			const char* pLineEnd = (const char*)memchr(pString, '\n', pEnd - pString);
+			if (pLineEnd == NULL)
+				pLineEnd = pEnd;
+
+			JsonValue* pValue = pAllocator->CreateJsonValue(pAllocator, pAllocator->pUserData);
+			if (pValue->Parse(pString, pLineEnd, iParseFlags) == false)
 			{
-				if (strcmp(pChild->m_pName, pName) == 0)
-					return *pChild;
-				if (pChild->m_pNext == NULL)
-					break;
-				pChild = pChild->m_pNext;
+				pChunk->m_pError = pString;
+				return;
+			}
+
+			// Only spaces can follow the value on its line
+			while (pString < pLineEnd && (*pString == ' ' || *pString == '\t' || *pString == '\r'))
+				++pString;
+			if (pString < pLineEnd)
+			{
+				pChunk->m_pError = pString;
+				return;
 			}
+			pChunk->m_oValues.Push(pValue);
 		}
-		return JsonValue::INVALID;
 	}
 
-	JsonValue& JsonValue::operator[](const char* pName)
+	//////////////////////////////
+	// CompactDoc
+	//////////////////////////////
+
+	const char* const CompactDoc::c_pTapeMagic = "JSTT";
+
+	CompactDoc::CompactDoc()
+		: m_pNodes(NULL)
+		, m_iNodeCount(0)
+		, m_pStrings(NULL)
+		, m_iStringsSize(0)
+		, m_pTape(NULL)
+		, m_iTapeSize(0)
+		, m_bTapeMapped(false)
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return JsonValue::INVALID;
+		m_oStringAllocator = JsonValue::s_oDefaultAllocator;
+		m_oStringAllocator.AllocString = &CompactDoc::AllocString;
+		m_oStringAllocator.pUserData = this;
+	}
 
-		if (pName == NULL || pName[0] == 0)
-			return JsonValue::INVALID;
+	CompactDoc::~CompactDoc()
+	{
+		Clear();
+	}
 
-		if (m_eType == E_TYPE_NULL)
-			InitType(E_TYPE_OBJECT);
-		if (m_eType == E_TYPE_OBJECT)
+	CompactValue CompactDoc::GetRoot() const
+	{
+		if (m_iNodeCount == 0)
+			return CompactValue();
+		return CompactValue(this, m_pNodes);
+	}
+
+	void CompactDoc::Clear()
+	{
+		m_oNodes.Clear();
+		m_oStrings.Clear();
+		m_pNodes = NULL;
+		m_iNodeCount = 0;
+		m_pStrings = NULL;
+		m_iStringsSize = 0;
+		if (m_pTape != NULL)
 		{
-			JsonValue* pChild = m_oValue.Childs.m_pFirst;
-			while (pChild != NULL)
-			{
-				if (strcmp(pChild->m_pName, pName) == 0)
-					return *pChild;
-				if (pChild->m_pNext == NULL)
-					break;
-				pChild = pChild->m_pNext;
-			}
+			Internal::FreeFileContent(m_pTape, m_iTapeSize, m_bTapeMapped);
+			m_pTape = NULL;
+			m_iTapeSize = 0;
+			m_bTapeMapped = false;
+		}
+	}
 
-			JsonValue* pNewMember = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
+	int CompactDoc::ReadString(const char* pJson, const char* pJsonEnd)
+	{
+		Clear();
 
-			size_t iNameLen = strlen(pName) + 1;
-			void* pNewString = m_pAllocator->AllocString(iNameLen, m_pAllocator->pUserData);
-			memcpy(pNewString, (const void*)pName, iNameLen);
-			pNewMember->m_pName = (char*)pNewString;
+		if (pJson == NULL)
+			return -1;
 
-			if (NULL != m_oValue.Childs.m_pLast)
-				m_oValue.Childs.m_pLast->m_pNext = pNewMember;
-			else
-				m_oValue.Childs.m_pFirst = pNewMember;
+		if (pJsonEnd == NULL)
+			pJsonEnd = pJson + strlen(pJson);
 
-			m_oValue.Childs.m_pLast = pNewMember;
-			return *pNewMember;
+		const char* pCursor = pJson;
+		Internal::SkipSpaces(pCursor, pJsonEnd);
+		if (pCursor >= pJsonEnd || *pCursor == 0)
+		{
+			// Empty document, root is null
+			m_oNodes.Resize(1);
+			m_oNodes.Data()[0].m_iHeader = JsonValue::E_TYPE_NULL;
+			m_oNodes.Data()[0].m_iName = c_iNoName;
 		}
-		return JsonValue::INVALID;
+		else if (ParseValue(pCursor, pJsonEnd, c_iNoName) == false)
+		{
+			int iLine = Internal::GetErrorLine(pJson, pJsonEnd, pCursor);
+			Clear();
+			return iLine;
+		}
+		m_oNodes.Data()[0].m_iHeader |= E_NODE_LAST;
+
+		// Document is read only, release unused memory
+		m_oNodes.Reserve(m_oNodes.Size());
+		if (m_oStrings.Size() > 0)
+			m_oStrings.Reserve(m_oStrings.Size());
+
+		m_pNodes = m_oNodes.Data();
+		m_iNodeCount = m_oNodes.Size();
+		m_pStrings = m_oStrings.Data();
+		m_iStringsSize = m_oStrings.Size();
+		return 0;
 	}
 
-	const JsonValue& JsonValue::operator[](char* pName) const
+	int CompactDoc::ReadFile(const char* pFilename)
 	{
-		return (*this)[(const char*)pName];
+		char* pString;
+		size_t iSize;
+		bool bMapped;
+		int iError = Internal::ReadFileContent(pFilename, &pString, &iSize, true, &bMapped);
+		if (iError != 0)
+			return iError;
+
+		int iLine = ReadString(pString, pString + iSize);
+
+		Internal::FreeFileContent(pString, iSize, bMapped);
+		return iLine;
 	}
 
-	JsonValue& JsonValue::operator[](char* pName)
+	bool CompactDoc::WriteTape(const char* pFilename) const
 	{
-		return (*this)[(const char*)pName];
+		if (m_iNodeCount == 0)
+			return false;
+
+		FILE* pFile = fopen(pFilename, "wb");
+		if (pFile == NULL)
+			return false;
+
+		TapeHeader oHeader;
+		memcpy(oHeader.m_pMagic, c_pTapeMagic, 4);
+		oHeader.m_iVersion = c_iTapeVersion;
+		oHeader.m_iNodeCount = (uint32_t)m_iNodeCount;
+		oHeader.m_iStringsSize = (uint32_t)m_iStringsSize;
+
+		bool bOk = fwrite(&oHeader, sizeof(TapeHeader), 1, pFile) == 1
+			&& fwrite(m_pNodes, sizeof(Node), m_iNodeCount, pFile) == m_iNodeCount
+			&& fwrite(m_pStrings, 1, m_iStringsSize, pFile) == m_iStringsSize;
+		bOk = fclose(pFile) == 0 && bOk;
+		return bOk;
 	}
 
-	const JsonValue& JsonValue::operator [](int iIndex) const
+	int CompactDoc::ReadTape(const char* pFilename)
 	{
-		if (m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY)
+		Clear();
+
+		char* pTape;
+		size_t iSize;
+		bool bMapped;
+		int iError = Internal::ReadFileContent(pFilename, &pTape, &iSize, true, &bMapped);
+		if (iError != 0)
+			return iError;
+
+		// Nodes are used in place, only check that the tape is complete
+		const TapeHeader* pHeader = (const TapeHeader*)pTape;
+		if (iSize < sizeof(TapeHeader)
+			|| memcmp(pHeader->m_pMagic, c_pTapeMagic, 4) != 0
+			|| pHeader->m_iVersion != c_iTapeVersion
+			|| pHeader->m_iNodeCount == 0
+			|| iSize != sizeof(TapeHeader) + (size_t)pHeader->m_iNodeCount * sizeof(Node) + pHeader->m_iStringsSize
+			|| (pHeader->m_iStringsSize > 0 && pTape[iSize - 1] != '\0'))
 		{
-			JsonValue* pChild = m_oValue.Childs.m_pFirst;
-			int iCurrent = 0;
-			while (pChild != NULL)
-			{
-				if (iCurrent++ == iIndex)
-					return *pChild;
-				pChild = pChild->m_pNext;
-			}
+			Internal::FreeFileContent(pTape, iSize, bMapped);
+			return -3;
 		}
-		return JsonValue::INVALID;
+
+		m_pTape = pTape;
+		m_iTapeSize = iSize;
+		m_bTapeMapped = bMapped;
+
+		m_pNodes = (const Node*)(pTape + sizeof(TapeHeader));
+		m_iNodeCount = pHeader->m_iNodeCount;
+		m_pStrings = (const char*)(m_pNodes + m_iNodeCount);
+		m_iStringsSize = pHeader->m_iStringsSize;
+		return 0;
 	}
 
-	JsonValue& JsonValue::operator[](int iIndex)
+	size_t CompactDoc::MemoryUsage() const
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return JsonValue::INVALID;
+		if (m_pTape != NULL)
+			return m_iTapeSize;
+		return m_oNodes.Capacity() * sizeof(Node) + m_oStrings.Capacity();
+	}
 
-		if (m_eType == E_TYPE_NULL)
-			InitType(E_TYPE_ARRAY);
-		if (m_eType == E_TYPE_OBJECT || m_eType == E_TYPE_ARRAY)
+	bool CompactDoc::ParseValue(const char*& pString, const char* pEnd, uint32_t iName)
+	{
+		// Nodes are referenced by 32 bits indexes
+		if (m_oNodes.Size() >= 0xFFFFFFFF)
+			return false;
+
+		// Nodes are stored in pre-order, childs follow their container
+		const size_t iNode = m_oNodes.Size();
+		m_oNodes.Resize(iNode + 1);
+		m_oNodes.Data()[iNode].m_iName = iName;
+
+		if (*pString == '"')
 		{
-			JsonValue* pChild = m_oValue.Childs.m_pFirst;
-			int iCurrent = 0;
-			while (pChild != NULL)
+			uint32_t iOffset, iLength;
+			if (ReadStringValue(++pString, pEnd, iOffset, iLength) == false)
+				return false;
+
+			Node& oNode = m_oNodes.Data()[iNode];
+			oNode.m_iHeader = JsonValue::E_TYPE_STRING;
+			oNode.m_oValue.String.m_iOffset = iOffset;
+			oNode.m_oValue.String.m_iLength = iLength;
+			return true;
+		}
+		else if (*pString == '{' || *pString == '[')
+		{
+			const bool bObject = *pString == '{';
+			const char cClose = bObject ? '}' : ']';
+			size_t iLastChild = 0;
+			uint32_t iCount = 0;
+
+			++pString;
+			Internal::SkipSpaces(pString, pEnd);
+			if (pString < pEnd && *pString == cClose)
 			{
-				if (iCurrent++ == iIndex)
-					return *pChild;
-				if (pChild->m_pNext == NULL)
-					break;
-				pChild = pChild->m_pNext;
+				++pString;
 			}
-			if (m_eType == E_TYPE_ARRAY)
+			else
 			{
-				do
+				while (true)
 				{
-					JsonValue* pNewChild = m_pAllocator->CreateJsonValue(m_pAllocator, m_pAllocator->pUserData);
-
-					if (NULL != m_oValue.Childs.m_pLast)
-						m_oValue.Childs.m_pLast->m_pNext = pNewChild;
-					else
-						m_oValue.Childs.m_pFirst = pNewChild;
-
-					m_oValue.Childs.m_pLast = pNewChild;
+					uint32_t iChildName = c_iNoName;
+					if (bObject)
+					{
+						uint32_t iNameLength;
+						if (pString >= pEnd || *pString != '"' || ReadStringValue(++pString, pEnd, iChildName, iNameLength) == false)
+							return false;
+
+						Internal::SkipSpaces(pString, pEnd);
+						if (pString >= pEnd || *pString != ':')
+							return false;
+						++pString;
+						Internal::SkipSpaces(pString, pEnd);
+					}
+
+					iLastChild = m_oNodes.Size();
+					if (pString >= pEnd || ParseValue(pString, pEnd, iChildName) == false)
+						return false;
+					++iCount;
+
+					Internal::SkipSpaces(pString, pEnd);
+					if (pString >= pEnd)
+						return false;
+
+					if (*pString == cClose)
+					{
+						++pString;
+						break;
+					}
+					else if (*pString != ',')
+					{
+						return false;
+					}
+					++pString;
+					Internal::SkipSpaces(pString, pEnd);
 				}
-				while (iCurrent++ != iIndex);
-				return *m_oValue.Childs.m_pLast;
+
+				m_oNodes.Data()[iLastChild].m_iHeader |= E_NODE_LAST;
 			}
+
+			Node& oNode = m_oNodes.Data()[iNode];
+			oNode.m_iHeader = bObject ? JsonValue::E_TYPE_OBJECT : JsonValue::E_TYPE_ARRAY;
+			oNode.m_oValue.Container.m_iEnd = (uint32_t)m_oNodes.Size();
+			oNode.m_oValue.Container.m_iCount = iCount;
+			return true;
 		}
-		return JsonValue::INVALID;
+
+		// Other values are read by JsonValue, without allocation
+		JsonValue oScalar;
+		if (oScalar.Parse(pString, pEnd) == false)
+			return false;
+
+		Node& oNode = m_oNodes.Data()[iNode];
+		oNode.m_iHeader = oScalar.m_eType;
+		if (oScalar.m_eType == JsonValue::E_TYPE_BOOLEAN)
+			oNode.m_oValue.Boolean = oScalar.m_oValue.Boolean;
+		else if (oScalar.m_eType == JsonValue::E_TYPE_INTEGER)
+			oNode.m_oValue.Integer = oScalar.m_oValue.Integer;
+		else if (oScalar.m_eType == JsonValue::E_TYPE_FLOAT)
+			oNode.m_oValue.Float = oScalar.m_oValue.Float;
+		return true;
 	}
 
-	JsonValue& JsonValue::operator =(const JsonValue& oValue)
+	bool CompactDoc::ReadStringValue(const char*& pString, const char* pEnd, uint32_t& iOffset, uint32_t& iLength)
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return JsonValue::INVALID;
+		const size_t iStart = m_oStrings.Size();
+		if (JsonValue::ReadStringValue(pString, pEnd, &m_oStringAllocator) == NULL)
+			return false;
 
-		if (oValue.m_eType == E_TYPE_OBJECT)
-		{
-			InitType(E_TYPE_OBJECT);
+		// Strings are referenced by 32 bits offsets
+		if (m_oStrings.Size() > 0xFFFFFFFF)
+			return false;
 
-			JsonValue* pSourceChild = oValue.m_oValue.Childs.m_pFirst;
-			while (pSourceChild != NULL)
-			{
-				JsonValue* pNewChild = new JsonValue(*pSourceChild);
+		iOffset = (uint32_t)iStart;
+		iLength = (uint32_t)(m_oStrings.Size() - iStart - 1);
+		return true;
+	}
 
-				if (pSourceChild->m_pName != NULL)
-				{
-					size_t iNameLen = strlen(pSourceChild->m_pName) + 1;
-					char* pNewString = m_pAllocator->AllocString(iNameLen, m_pAllocator->pUserData);
-					memcpy(pNewString, pSourceChild->m_pName, iNameLen);
-					pNewChild->m_pName = pNewString;
-				}
+	const CompactDoc::Node* CompactDoc::GetNextSibling(const Node* pNode) const
+	{
+		if (pNode->m_iHeader & E_NODE_LAST)
+			return NULL;
 
-				if (NULL != m_oValue.Childs.m_pLast)
-					m_oValue.Childs.m_pLast->m_pNext = pNewChild;
-				else
-					m_oValue.Childs.m_pFirst = pNewChild;
+		const uint32_t iType = pNode->m_iHeader & E_NODE_TYPE_MASK;
+		if (iType == JsonValue::E_TYPE_OBJECT || iType == JsonValue::E_TYPE_ARRAY)
+			return m_pNodes + pNode->m_oValue.Container.m_iEnd;
+		return pNode + 1;
+	}
 
-				m_oValue.Childs.m_pLast = pNewChild;
+	char* CompactDoc::AllocString(size_t iSize, void* pUserData)
+	{
+		// Strings are appended to the pool, pointer is only used while reading the string
+		CompactDoc* pDoc = (CompactDoc*)pUserData;
+		const size_t iOffset = pDoc->m_oStrings.Size();
+		pDoc->m_oStrings.Resize(iOffset + iSize);
+		return pDoc->m_oStrings.Data() + iOffset;
+	}
 
-				pSourceChild = pSourceChild->m_pNext;
-			}
-		}
-		else if (oValue.m_eType == E_TYPE_ARRAY)
-		{
-			InitType(E_TYPE_ARRAY);
+	//////////////////////////////
+	// CompactValue::Iterator
+	//////////////////////////////
 
-			JsonValue* pSourceChild = oValue.m_oValue.Childs.m_pFirst;
-			while (pSourceChild != NULL)
-			{
-				JsonValue* pNewChild = new JsonValue(*pSourceChild);
+	CompactValue::Iterator::Iterator(const CompactDoc* pDoc, const CompactDoc::Node* pNode)
+		: m_pDoc(pDoc)
+		, m_pNode(pNode)
+	{
+	}
 
-				if (NULL != m_oValue.Childs.m_pLast)
-					m_oValue.Childs.m_pLast->m_pNext = pNewChild;
-				else
-					m_oValue.Childs.m_pFirst = pNewChild;
+	bool CompactValue::Iterator::IsValid() const
+	{
+		return m_pNode != NULL;
+	}
 
-				m_oValue.Childs.m_pLast = pNewChild;
+	bool CompactValue::Iterator::operator!=(const Iterator& oIte) const
+	{
+		return m_pNode != oIte.m_pNode;
+	}
 
-				pSourceChild = pSourceChild->m_pNext;
-			}
-		}
-		else if (oValue.m_eType == E_TYPE_BOOLEAN)
-		{
-			*this = oValue.ToBoolean();
-		}
-		else if (oValue.m_eType == E_TYPE_STRING)
-		{
-			*this = oValue.ToString();
-		}
-		else if (oValue.m_eType == E_TYPE_INTEGER)
+	void CompactValue::Iterator::operator++()
+	{
+		if (m_pNode != NULL)
+			m_pNode = m_pDoc->GetNextSibling(m_pNode);
+	}
+
+	CompactValue CompactValue::Iterator::operator*() const
+	{
+		return CompactValue(m_pDoc, m_pNode);
+	}
+
+	//////////////////////////////
+	// CompactValue
+	//////////////////////////////
+
+	CompactValue::CompactValue()
+		: m_pDoc(NULL)
+		, m_pNode(NULL)
+	{
+	}
+
+	CompactValue::CompactValue(const CompactDoc* pDoc, const CompactDoc::Node* pNode)
+		: m_pDoc(pDoc)
+		, m_pNode(pNode)
+	{
+	}
+
+	JsonValue::EType CompactValue::GetType() const
+	{
+		if (m_pNode == NULL)
+			return JsonValue::E_TYPE_NULL;
+		return (JsonValue::EType)(m_pNode->m_iHeader & CompactDoc::E_NODE_TYPE_MASK);
+	}
+
+	int CompactValue::GetMemberCount() const
+	{
+		if (IsContainer())
+			return (int)m_pNode->m_oValue.Container.m_iCount;
+		return 0;
+	}
+
+	const char* CompactValue::GetName() const
+	{
+		if (m_pNode == NULL || m_pNode->m_iName == CompactDoc::c_iNoName)
+			return NULL;
+		return m_pDoc->m_pStrings + m_pNode->m_iName;
+	}
+
+	CompactValue CompactValue::GetNext() const
+	{
+		if (m_pNode == NULL)
+			return CompactValue();
+		return CompactValue(m_pDoc, m_pDoc->GetNextSibling(m_pNode));
+	}
+
+	const char* CompactValue::ToString() const
+	{
+		if (IsString())
+			return m_pDoc->m_pStrings + m_pNode->m_oValue.String.m_iOffset;
+		return NULL;
+	}
+
+	size_t CompactValue::GetStringLength() const
+	{
+		if (IsString())
+			return m_pNode->m_oValue.String.m_iLength;
+		return 0;
+	}
+
+	bool CompactValue::ToBoolean() const
+	{
+		if (IsBoolean())
+			return m_pNode->m_oValue.Boolean;
+		return false;
+	}
+
+	int64_t CompactValue::ToInteger() const
+	{
+		if (IsInteger())
+			return m_pNode->m_oValue.Integer;
+		else if (IsFloat())
+			return (int64_t)m_pNode->m_oValue.Float;
+		return 0;
+	}
+
+	double CompactValue::ToFloat() const
+	{
+		if (IsFloat())
+			return m_pNode->m_oValue.Float;
+		else if (IsInteger())
+			return (double)m_pNode->m_oValue.Integer;
+		return 0.0;
+	}
+
+	void CompactValue::ToJsonValue(JsonValue& oValue) const
+	{
+		switch (GetType())
 		{
-			*this = oValue.ToInteger();
+		case JsonValue::E_TYPE_OBJECT:
+			oValue.InitType(JsonValue::E_TYPE_OBJECT);
+			for (Iterator it = begin(); it != end(); ++it)
+			{
+				CompactValue oMember = *it;
+				oMember.ToJsonValue(oValue[oMember.GetName()]);
+			}
+			break;
+		case JsonValue::E_TYPE_ARRAY:
+			oValue.InitType(JsonValue::E_TYPE_ARRAY);
+			for (Iterator it = begin(); it != end(); ++it)
+				(*it).ToJsonValue(oValue.Append());
+			break;
+		case JsonValue::E_TYPE_STRING:
+			oValue.SetString(ToString(), ToString() + GetStringLength());
+			break;
+		case JsonValue::E_TYPE_BOOLEAN:
+			oValue.SetBoolean(ToBoolean());
+			break;
+		case JsonValue::E_TYPE_INTEGER:
+			oValue.SetInteger(ToInteger());
+			break;
+		case JsonValue::E_TYPE_FLOAT:
+			oValue.SetFloat(ToFloat());
+			break;
+		default:
+			oValue.InitType(JsonValue::E_TYPE_NULL);
+			break;
 		}
-		else if (oValue.m_eType == E_TYPE_FLOAT)
+	}
+
+	CompactValue CompactValue::operator [](const char* pName) const
+	{
+		if (IsObject() && pName != NULL)
 		{
-			*this = oValue.ToFloat();
+			for (Iterator it = begin(); it != end(); ++it)
+			{
+				if (strcmp(m_pDoc->m_pStrings + it.m_pNode->m_iName, pName) == 0)
+					return *it;
+			}
 		}
-		else
+		return CompactValue();
+	}
+
+	CompactValue CompactValue::operator [](int iIndex) const
+	{
+		if (IsContainer() && iIndex >= 0 && iIndex < GetMemberCount())
 		{
-			InitType(E_TYPE_NULL);
+			Iterator it = begin();
+			while (iIndex-- > 0)
+				++it;
+			return *it;
 		}
-		return *this;
+		return CompactValue();
 	}
 
-#ifdef JsonStthmString
-	JsonValue& JsonValue::operator =(const JsonStthmString& sValue)
+	CompactValue::Iterator CompactValue::begin() const
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return JsonValue::INVALID;
+		if (GetMemberCount() > 0)
+			return Iterator(m_pDoc, m_pNode + 1);
+		return end();
+	}
 
-		InitType(E_TYPE_STRING);
-		SetStringValue(sValue.c_str());
+	CompactValue::Iterator CompactValue::end() const
+	{
+		return Iterator(m_pDoc, NULL);
+	}
 
-		return *this;
+	//////////////////////////////
+	// Reader
+	//////////////////////////////
+
+	Reader::Reader()
+		: m_pFile(NULL)
+	{
+		m_oStringAllocator = JsonValue::s_oDefaultAllocator;
+		m_oStringAllocator.AllocString = &Reader::AllocString;
+		m_oStringAllocator.FreeString = &Reader::FreeString;
+		m_oStringAllocator.pUserData = this;
+
+		SetInput(NULL);
 	}
-#endif //JsonStthmString
 
-	JsonValue& JsonValue::operator =(const char* pValue)
+	Reader::~Reader()
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return JsonValue::INVALID;
+		Close();
+	}
 
-		SetString(pValue);
-		return *this;
+	void Reader::Reset()
+	{
+		m_iBaseOffset = 0;
+		m_bEndOfInput = false;
+		m_eEvent = E_EVENT_NONE;
+		m_eState = E_STATE_ROOT;
+		m_oStack.Clear();
+		m_oBuffer.Clear();
+		m_oString.Resize(1);
+		m_oString.Data()[0] = 0;
+		m_iStringLength = 0;
+		m_oScalar.InitType(JsonValue::E_TYPE_NULL);
+		m_bFeed = false;
+		m_bNeedInput = false;
+		m_iResumeScan = 0;
+		m_iSkipDepth = 0;
+		m_bSkipInString = false;
+		m_eSkipValueEvent = E_EVENT_NONE;
 	}
 
-	JsonValue& JsonValue::operator =(bool bValue)
+	void Reader::SetInput(const char* pJson, const char* pJsonEnd)
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return JsonValue::INVALID;
+		Close();
+		Reset();
 
-		SetBoolean(bValue);
-		return *this;
+		if (pJson != NULL && pJsonEnd == NULL)
+			pJsonEnd = pJson + strlen(pJson);
+
+		m_pBase = m_pCursor = pJson;
+		m_pEnd = pJsonEnd;
+		m_pReadCallback = NULL;
+		m_pReadUserData = NULL;
+		m_iChunkSize = 0;
 	}
 
-	JsonValue& JsonValue::operator =(int64_t iValue)
+	void Reader::SetInput(ReadCallback pCallback, void* pUserData, size_t iChunkSize)
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return JsonValue::INVALID;
+		JsonStthmAssert(pCallback != NULL && iChunkSize > 0);
+		Close();
+		Reset();
 
-		SetInteger(iValue);
-		return *this;
+		m_pBase = m_pCursor = m_pEnd = m_oBuffer.Data();
+		m_pReadCallback = pCallback;
+		m_pReadUserData = pUserData;
+		m_iChunkSize = iChunkSize;
 	}
 
-	JsonValue& JsonValue::operator =(double fValue)
+	void Reader::SetFeedInput()
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return JsonValue::INVALID;
+		Close();
+		Reset();
 
-		SetFloat(fValue);
-		return *this;
+		m_pBase = m_pCursor = m_pEnd = m_oBuffer.Data();
+		m_pReadCallback = NULL;
+		m_pReadUserData = NULL;
+		m_iChunkSize = 0;
+		m_bFeed = true;
 	}
 
-	JsonValue& JsonValue::operator +=(const JsonValue& oValue)
+	void Reader::Feed(const char* pData, size_t iSize)
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID)
-			return JsonValue::INVALID;
+		JsonStthmAssert(m_bFeed && m_bEndOfInput == false);
 
-		if (m_eType == E_TYPE_ARRAY)
+		// Keep unread data at start of buffer, like Refill
+		const size_t iRemaining = m_pEnd - m_pCursor;
+		m_iBaseOffset += m_pCursor - m_pBase;
+		memmove(m_oBuffer.Data(), m_pCursor, iRemaining);
+		m_oBuffer.Resize(iRemaining + iSize);
+		memcpy(m_oBuffer.Data() + iRemaining, pData, iSize);
+
+		m_pBase = m_pCursor = m_oBuffer.Data();
+		m_pEnd = m_pCursor + m_oBuffer.Size();
+	}
+
+	void Reader::EndFeed()
+	{
+		JsonStthmAssert(m_bFeed);
+		m_bEndOfInput = true;
+	}
+
+	bool Reader::OpenFile(const char* pFilename, size_t iChunkSize)
+	{
+		FILE* pFile = fopen(pFilename, "rb");
+		if (pFile == NULL)
 		{
-			JsonValue* pNewValue = new JsonValue(oValue);
+			SetInput(NULL);
+			return false;
+		}
 
-			if (NULL != m_oValue.Childs.m_pLast)
-				m_oValue.Childs.m_pLast->m_pNext = pNewValue;
-			else
-				m_oValue.Childs.m_pFirst = pNewValue;
+		SetInput(&Reader::ReadFileCallback, pFile, iChunkSize);
+		m_pFile = pFile;
+		return true;
+	}
 
-			m_oValue.Childs.m_pLast = pNewValue;
+	void Reader::Close()
+	{
+		if (m_pFile != NULL)
+		{
+			fclose((FILE*)m_pFile);
+			m_pFile = NULL;
 		}
-		else if (m_eType == E_TYPE_STRING)
+	}
+
+	Reader::EEvent Reader::Next()
+	{
+		if (m_bFeed == false)
+			return ReadNext();
+
+		m_bNeedInput = false;
+		if (m_iSkipDepth > 0)
 		{
-			if (oValue.IsString())
+			// Resume SkipContainer(), its progress is kept
+			if (SkipContainer() && m_eSkipValueEvent != E_EVENT_NONE)
+				return m_eSkipValueEvent;
+			return m_eEvent;
+		}
+
+		// Token not fed entirely, read it again from here on next call
+		const char* pCursor = m_pCursor;
+		const EState eState = m_eState;
+		const EEvent eEvent = ReadNext();
+		if (m_bNeedInput == false)
+			return eEvent;
+
+		m_pCursor = pCursor;
+		m_eState = eState;
+		return m_eEvent = E_EVENT_NEED_INPUT;
+	}
+
+	Reader::EEvent Reader::ReadNext()
+	{
+		if (m_eEvent == E_EVENT_ERROR || m_eEvent == E_EVENT_END)
+			return m_eEvent;
+
+		while (true)
+		{
+			if (SkipSpaces() == false)
 			{
-				Internal::CharBuffer oNewStr;
-				const char* pAddString = oValue.ToString();
-				size_t iLen1 = strlen(m_oValue.String);
-				size_t iLen2 = strlen(pAddString);
-				oNewStr.Reserve(iLen1 + iLen2 + 1);
-				oNewStr.PushRange(m_oValue.String, iLen1);
-				oNewStr.PushRange(pAddString, iLen2);
-				oNewStr.Push(0);
-				SetStringValue(oNewStr.Data());
+				if (m_eState == E_STATE_ROOT)
+					return m_eEvent = E_EVENT_END;
+				return SetError();
+			}
+
+			const char cChar = *m_pCursor;
+			switch (m_eState)
+			{
+			case E_STATE_SEPARATOR:
+				if (cChar == ',')
+				{
+					++m_pCursor;
+					m_eState = (m_oStack.Data()[m_oStack.Size() - 1] == '{') ? E_STATE_MEMBER : E_STATE_VALUE;
+					continue;
+				}
+				return ReadContainerEnd(cChar);
+			case E_STATE_FIRST_MEMBER:
+				if (cChar == '}')
+					return ReadContainerEnd(cChar);
+				// Fall through
+			case E_STATE_MEMBER:
+				if (cChar != '"' || ReadString() == false)
+					return SetError();
+				m_eState = E_STATE_COLON;
+				return m_eEvent = E_EVENT_KEY;
+			case E_STATE_COLON:
+				if (cChar != ':')
+					return SetError();
+				++m_pCursor;
+				m_eState = E_STATE_VALUE;
+				continue;
+			case E_STATE_FIRST_ELEMENT:
+				if (cChar == ']')
+					return ReadContainerEnd(cChar);
+				// Fall through
+			case E_STATE_VALUE:
+			case E_STATE_ROOT:
+				return ReadValueEvent(cChar);
 			}
 		}
-		return *this;
 	}
 
-	bool JsonValue::Parse(const char*& pString, const char* pEnd)
+	Reader::EEvent Reader::SkipValue()
 	{
-		JsonStthmAssert(this != &JsonStthm::JsonValue::INVALID);
-		if (this == &JsonStthm::JsonValue::INVALID || pString == NULL)
+		EEvent eEvent = Next();
+		if (eEvent == E_EVENT_START_OBJECT || eEvent == E_EVENT_START_ARRAY)
+		{
+			if (SkipContainer() == false)
+			{
+				// E_EVENT_ERROR or E_EVENT_NEED_INPUT, resumed skip then return eEvent
+				m_eSkipValueEvent = eEvent;
+				return m_eEvent;
+			}
+		}
+		return eEvent;
+	}
+
+	bool Reader::SkipContainer()
+	{
+		if (m_eEvent == E_EVENT_ERROR || m_oStack.Size() == 0)
 			return false;
 
-		Internal::SkipSpaces(pString, pEnd);
-		if (pString >= pEnd || *pString == 0)
+		// Only strings and braces are checked, like Internal::SkipContainer
+		// Depth is kept in members to resume it once more input is fed
+		if (m_iSkipDepth == 0)
 		{
-			return true;
+			m_iSkipDepth = 1;
+			m_bSkipInString = false;
+			m_eSkipValueEvent = E_EVENT_NONE;
 		}
-		else if (*pString == '"')
+		m_bNeedInput = false;
+
+		while (true)
 		{
-			char* pValue = ReadStringValue(++pString, pEnd, m_pAllocator);
-			if (pValue == NULL)
+			if (m_bSkipInString)
+			{
+				if (SkipStringBody() == false)
+					break;
+				m_bSkipInString = false;
+			}
+
+			m_pCursor = Internal::FindBracket(m_pCursor, m_pEnd);
+			if (m_pCursor >= m_pEnd)
+			{
+				if (Refill() == false)
+					break;
+				continue;
+			}
+
+			const char cChar = *m_pCursor;
+			if (cChar == '"')
 			{
+				++m_pCursor;
+				m_bSkipInString = true;
+			}
+			else if (cChar == 0)
+			{
+				break;
+			}
+			else if (cChar == '{' || cChar == '[')
+			{
+				++m_pCursor;
+				++m_iSkipDepth;
+			}
+			else if (--m_iSkipDepth > 0)
+			{
+				++m_pCursor;
+			}
+			else
+			{
+				ReadContainerEnd(m_oStack.Data()[m_oStack.Size() - 1] == '{' ? '}' : ']');
+				return true;
+			}
+		}
+
+		if (m_bNeedInput)
+		{
+			m_eEvent = E_EVENT_NEED_INPUT;
+			return false;
+		}
+
+		m_iSkipDepth = 0;
+		SetError();
+		return false;
+	}
+
+	bool Reader::ReadValue(JsonValue& oValue)
+	{
+		EEvent eEvent = Next();
+
+		Internal::Buffer<JsonValue*, 64> oStack;
+		JsonValue* pValue = &oValue;
+		while (true)
+		{
+			switch (eEvent)
+			{
+			case E_EVENT_START_OBJECT:
+				pValue->InitType(JsonValue::E_TYPE_OBJECT);
+				oStack.Push(pValue);
+				break;
+			case E_EVENT_START_ARRAY:
+				pValue->InitType(JsonValue::E_TYPE_ARRAY);
+				oStack.Push(pValue);
+				break;
+			case E_EVENT_STRING:
+				pValue->InitType(JsonValue::E_TYPE_STRING);
+				pValue->SetStringValue(m_oString.Data(), m_oString.Data() + m_iStringLength);
+				break;
+			case E_EVENT_INTEGER:
+				*pValue = m_oScalar.m_oValue.Integer;
+				break;
+			case E_EVENT_FLOAT:
+				*pValue = m_oScalar.m_oValue.Float;
+				break;
+			case E_EVENT_BOOLEAN:
+				*pValue = m_oScalar.m_oValue.Boolean;
+				break;
+			case E_EVENT_NULL:
+				pValue->InitType(JsonValue::E_TYPE_NULL);
+				break;
+			default:
 				return false;
 			}
 
-			InitType(E_TYPE_STRING);
-			m_oValue.String = pValue;
-			return true;
+			// Next child of current container
+			while (true)
+			{
+				if (oStack.Size() == 0)
+					return true;
+
+				JsonValue* pParent = oStack.Data()[oStack.Size() - 1];
+				eEvent = Next();
+				if (eEvent == E_EVENT_END_OBJECT || eEvent == E_EVENT_END_ARRAY)
+				{
+					pParent->BuildIndex();
+					oStack.Resize(oStack.Size() - 1);
+					continue;
+				}
+
+				Allocator* pAllocator = pParent->m_pAllocator;
+				pValue = pAllocator->CreateJsonValue(pAllocator, pAllocator->pUserData);
+				pParent->AppendChild(pValue);
+
+				if (eEvent == E_EVENT_KEY)
+				{
+					pValue->m_pName = pAllocator->AllocString(m_iStringLength + 1, pAllocator->pUserData);
+					memcpy(pValue->m_pName, m_oString.Data(), m_iStringLength + 1);
+					eEvent = Next();
+				}
+				break;
+			}
 		}
-		else if ((pEnd - pString) >= 3 && memcmp(pString, "NaN", 3) == 0)
+	}
+
+	bool Reader::Refill()
+	{
+		if (m_bFeed)
 		{
-			pString += 3;
-			InitType(E_TYPE_FLOAT);
-			m_oValue.Float = Internal::c_fNaN;
-			return true;
+			// Next() return E_EVENT_NEED_INPUT
+			m_bNeedInput = m_bEndOfInput == false;
+			return false;
 		}
-		else if ((pEnd - pString) >= 9 && memcmp(pString, "-Infinity", 9) == 0)
+
+		if (m_pReadCallback == NULL || m_bEndOfInput)
+			return false;
+
+		// Keep unread data at start of buffer, then append a new chunk
+		const size_t iRemaining = m_pEnd - m_pCursor;
+		m_iBaseOffset += m_pCursor - m_pBase;
+		memmove(m_oBuffer.Data(), m_pCursor, iRemaining);
+		m_oBuffer.Resize(iRemaining + m_iChunkSize);
+
+		const size_t iRead = m_pReadCallback(m_oBuffer.Data() + iRemaining, m_iChunkSize, m_pReadUserData);
+		JsonStthmAssert(iRead <= m_iChunkSize);
+		m_oBuffer.Resize(iRemaining + iRead);
+
+		m_pBase = m_pCursor = m_oBuffer.Data();
+		m_pEnd = m_pCursor + m_oBuffer.Size();
+
+		if (iRead == 0)
 		{
-			pString += 9;
-			InitType(E_TYPE_FLOAT);
-			m_oValue.Float = -Internal::c_fInfinity;
-			return true;
+			m_bEndOfInput = true;
+			return false;
 		}
-		else if ((pEnd - pString) >= 8 && memcmp(pString, "Infinity", 8) == 0)
+		return true;
+	}
+
+	bool Reader::SkipSpaces()
+	{
+		while (true)
 		{
-			pString += 8;
-			InitType(E_TYPE_FLOAT);
-			m_oValue.Float = Internal::c_fInfinity;
-			return true;
+			Internal::SkipSpaces(m_pCursor, m_pEnd);
+			if (m_pCursor < m_pEnd)
+				return true;
+			if (Refill() == false)
+				return false;
 		}
-		else if (Internal::IsDigit(*pString) || *pString == '-')
+	}
+
+	bool Reader::EnsureAvailable(size_t iCount)
+	{
+		while ((size_t)(m_pEnd - m_pCursor) < iCount)
 		{
-			return ReadNumericValue(pString, pEnd, *this);
+			if (Refill() == false)
+				return false;
 		}
-		else if ((pEnd - pString) >= 4 && memcmp(pString, "true", 4) == 0)
+		return true;
+	}
+
+	bool Reader::ReadString()
+	{
+		JsonStthmAssert(*m_pCursor == '"');
+
+		// Wait for closing quote before reading the string
+		// With fed input, scan resume where previous call stopped
+		size_t iScan = (m_iResumeScan > 0) ? m_iResumeScan : 1;
+		m_iResumeScan = 0;
+		while (true)
 		{
-			pString += 4;
-			InitType(E_TYPE_BOOLEAN);
-			m_oValue.Boolean = true;
-			return true;
+			const char* pScan = m_pCursor + iScan;
+			while (true)
+			{
+				pScan = Internal::FindStringSpecial(pScan, m_pEnd);
+				if (pScan >= m_pEnd || *pScan == '"')
+					break;
+				if (*pScan == 0)
+					return false;
+				if (pScan + 1 >= m_pEnd)
+					break; // Escaped char not read yet
+				pScan += 2;
+			}
+
+			iScan = pScan - m_pCursor;
+			if (pScan < m_pEnd && *pScan == '"')
+				break;
+			if (Refill() == false)
+			{
+				if (m_bNeedInput)
+					m_iResumeScan = iScan;
+				return false;
+			}
 		}
-		else if ((pEnd - pString) >= 5 && memcmp(pString, "false", 5) == 0)
+
+		const char* pString = m_pCursor + 1;
+		const char* pValue = JsonValue::ReadStringValue(pString, m_pEnd, &m_oStringAllocator);
+		if (pValue == NULL)
+			return false;
+
+		m_pCursor = pString;
+		return true;
+	}
+
+	bool Reader::SkipStringBody()
+	{
+		// Skipped content is dropped on refill
+		while (true)
 		{
-			pString += 5;
-			InitType(E_TYPE_BOOLEAN);
-			m_oValue.Boolean = false;
-			return true;
+			const char* pScan = Internal::FindStringSpecial(m_pCursor, m_pEnd);
+			if (pScan < m_pEnd && *pScan == '"')
+			{
+				m_pCursor = pScan + 1;
+				return true;
+			}
+			if (pScan < m_pEnd && *pScan == 0)
+				return false;
+
+			if (pScan + 1 < m_pEnd)
+			{
+				m_pCursor = pScan + 2; // Escaped char
+				continue;
+			}
+
+			m_pCursor = pScan;
+			if (Refill() == false)
+				return false;
+		}
+	}
+
+	Reader::EEvent Reader::ReadValueEvent(char cChar)
+	{
+		const EState eNextState = m_oStack.Size() > 0 ? E_STATE_SEPARATOR : E_STATE_ROOT;
+
+		if (cChar == '{' || cChar == '[')
+		{
+			++m_pCursor;
+			m_oStack.Push(cChar);
+			m_eState = (cChar == '{') ? E_STATE_FIRST_MEMBER : E_STATE_FIRST_ELEMENT;
+			return m_eEvent = (cChar == '{') ? E_EVENT_START_OBJECT : E_EVENT_START_ARRAY;
 		}
-		else if ((pEnd - pString) >= 4 && memcmp(pString, "null", 4) == 0)
+		else if (cChar == '"')
 		{
-			pString += 4;
-			InitType(E_TYPE_NULL);
-			return true;
+			if (ReadString() == false)
+				return SetError();
+			m_eState = eNextState;
+			return m_eEvent = E_EVENT_STRING;
 		}
-		else if (*pString == '{')
+		else if (Internal::IsDigit(cChar) || (cChar == '-' && (EnsureAvailable(2) == false || m_pCursor[1] != 'I')))
 		{
-			++pString;
-			return ReadObjectValue(pString, pEnd, *this);
+			// Wait for the whole number
+			size_t iLength = 0;
+			while (true)
+			{
+				const char* pScan = m_pCursor + iLength;
+				while (pScan < m_pEnd && (Internal::IsDigit(*pScan) || *pScan == '-' || *pScan == '+' || *pScan == '.' || *pScan == 'e' || *pScan == 'E'))
+					++pScan;
+				iLength = pScan - m_pCursor;
+				if (pScan < m_pEnd || Refill() == false)
+					break;
+			}
+
+			const char* pNumber = m_pCursor;
+			if (JsonValue::ReadNumericValue(pNumber, m_pCursor + iLength, m_oScalar) == false || pNumber != m_pCursor + iLength)
+				return SetError();
+
+			m_pCursor = pNumber;
+			m_eState = eNextState;
+			return m_eEvent = m_oScalar.IsInteger() ? E_EVENT_INTEGER : E_EVENT_FLOAT;
 		}
-		else if (*pString == '[')
+
+		static const struct
 		{
-			++pString;
-			return ReadArrayValue(pString, pEnd, *this);
+			const char*	m_pLiteral;
+			size_t		m_iLength;
+			EEvent		m_eEvent;
+			double		m_fValue;
+		} c_pLiterals[] = {
+			{ "true", 4, E_EVENT_BOOLEAN, 1.0 },
+			{ "false", 5, E_EVENT_BOOLEAN, 0.0 },
+			{ "null", 4, E_EVENT_NULL, 0.0 },
+			{ "NaN", 3, E_EVENT_FLOAT, Internal::c_fNaN },
+			{ "Infinity", 8, E_EVENT_FLOAT, Internal::c_fInfinity },
+			{ "-Infinity", 9, E_EVENT_FLOAT, -Internal::c_fInfinity }
+		};
+
+		for (size_t iLiteral = 0; iLiteral < sizeof(c_pLiterals) / sizeof(c_pLiterals[0]); ++iLiteral)
+		{
+			if (c_pLiterals[iLiteral].m_pLiteral[0] != cChar)
+				continue;
+
+			const size_t iLength = c_pLiterals[iLiteral].m_iLength;
+			if (EnsureAvailable(iLength) == false || memcmp(m_pCursor, c_pLiterals[iLiteral].m_pLiteral, iLength) != 0)
+				return SetError();
+
+			m_pCursor += iLength;
+			m_eState = eNextState;
+			m_eEvent = c_pLiterals[iLiteral].m_eEvent;
+			if (m_eEvent == E_EVENT_BOOLEAN)
+				m_oScalar = c_pLiterals[iLiteral].m_fValue != 0.0;
+			else if (m_eEvent == E_EVENT_FLOAT)
+				m_oScalar = c_pLiterals[iLiteral].m_fValue;
+			return m_eEvent;
 		}
 
-		// Error
-		return false;
+		return SetError();
 	}
 
-	// Static functions
+	Reader::EEvent Reader::ReadContainerEnd(char cChar)
+	{
+		JsonStthmAssert(m_oStack.Size() > 0);
+		const char cOpening = m_oStack.Data()[m_oStack.Size() - 1];
+		if ((cOpening == '{' && cChar != '}') || (cOpening == '[' && cChar != ']'))
+			return SetError();
+
+		++m_pCursor;
+		m_oStack.Resize(m_oStack.Size() - 1);
+		m_eState = m_oStack.Size() > 0 ? E_STATE_SEPARATOR : E_STATE_ROOT;
+		return m_eEvent = (cChar == '}') ? E_EVENT_END_OBJECT : E_EVENT_END_ARRAY;
+	}
 
-	int JsonValue::ReadSpecialChar(const char*& pString, const char* pEnd, char* pOut)
+	Reader::EEvent Reader::SetError()
 	{
-		if( pString >= pEnd )
-			return 0;
+		return m_eEvent = E_EVENT_ERROR;
+	}
 
-		if (*pString == 'n')		{ pOut[0] = '\n';	return 1; }
-		else if (*pString == 'r')	{ pOut[0] = '\r';	return 1; }
-		else if (*pString == 't')	{ pOut[0] = '\t';	return 1; }
-		else if (*pString == 'b')	{ pOut[0] = '\b';	return 1; }
-		else if (*pString == 'f')	{ pOut[0] = '\f';	return 1; }
-		else if (*pString == '"')	{ pOut[0] = '"';	return 1; }
-		else if (*pString == '\\')	{ pOut[0] = '\\';	return 1; }
-		else if (*pString == '/')	{ pOut[0] = '/';	return 1; }
-		else if (*pString == 'u')
-		{
-			uint32_t iChar = 0;
-			for (int i = 0; i < 4; ++i)
-			{
-				if (pString >= pEnd)
-					return 0;
+	size_t Reader::ReadFileCallback(char* pBuffer, size_t iSize, void* pUserData)
+	{
+		return fread(pBuffer, 1, iSize, (FILE*)pUserData);
+	}
 
-				uint8_t iXDigit = Internal::XDigitToUInt8(*++pString);
-				if (iXDigit != 255)
-					iChar = iChar * 16 + iXDigit;
-				else
-					return 0;
-			}
+	char* Reader::AllocString(size_t iSize, void* pUserData)
+	{
+		// Only one string is read at time, reuse same buffer
+		Reader* pReader = (Reader*)pUserData;
+		pReader->m_oString.Resize(iSize);
+		pReader->m_iStringLength = iSize - 1;
+		return pReader->m_oString.Data();
+	}
 
-			if (iChar >= 0xD800 && iChar <= 0xDFFF) // UTF16 Surrogate pair
-			{
-				if ((iChar & 0xFC00) != 0xD800)
-					return 0; //Invalid first pair code
+	void Reader::FreeString(char* /*pString*/, void* /*pUserData*/)
+	{
+		// Do nothing
+	}
 
-				if (pString >= pEnd || *++pString != '\\' || *++pString != 'u')
-					return 0; //Not a valid pair
+	//////////////////////////////
+	// Writer
+	//////////////////////////////
 
-				uint32_t iChar2 = 0;
-				for (int i = 0; i < 4; ++i)
-				{
-					if (pString >= pEnd)
-						return 0;
+	Writer::Writer(bool bCompact, size_t iFlushSize)
+		: m_bCompact(bCompact)
+		, m_iFlushSize(iFlushSize)
+		, m_bFirst(true)
+		, m_bAfterKey(false)
+		, m_bFailed(false)
+		, m_iWrittenSize(0)
+		, m_pWriteCallback(NULL)
+		, m_pWriteUserData(NULL)
+		, m_pFile(NULL)
+		, m_pOutput(NULL)
+		, m_iOutputSize(0)
+	{
+		m_oBuffer.Reserve(iFlushSize + 256);
+	}
 
-					uint8_t iXDigit = Internal::XDigitToUInt8(*++pString);
-					if (iXDigit != 255)
-						iChar2 = iChar2 * 16 + iXDigit;
-					else
-						return 0;
-				}
+	Writer::~Writer()
+	{
+		Close();
+	}
 
-				if ((iChar2 & 0xFC00) != 0xDC00)
-					return 0; //Invalid second pair code
+	bool Writer::OpenFile(const char* pFilename)
+	{
+		Close();
+		FILE* pFile = fopen(pFilename, "wb");
+		if (pFile == NULL)
+			return false;
 
-				iChar = 0x10000 + (((iChar & 0x3FF) << 10) | (iChar2 & 0x3FF));
-			}
+		SetOutput(&Writer::WriteFileCallback, pFile);
+		m_pFile = pFile;
+		return true;
+	}
 
-			if (iChar < 0x80)
-			{
-				pOut[0] = (char)iChar;
-				return 1;
-			}
-			if (iChar >= 0x80 && iChar <= 0x7FF)
-			{
-				pOut[0] = (char)(0xC0 | ((iChar >> 6)));
-				pOut[1] = (char)(0x80 | ((iChar >> 0) & 0x3F));
-				return 2;
-			}
-			if (iChar >= 0x800 && iChar <= 0xFFFF)
-			{
-				pOut[0] = (char)(0xE0 | ((iChar >> 12)));
-				pOut[1] = (char)(0x80 | ((iChar >> 6) & 0x3F));
-				pOut[2] = (char)(0x80 | ((iChar >> 0) & 0x3F));
-				return 3;
-			}
-			if (iChar >= 0x10000 && iChar <= 0x10FFFF)
-			{
-				pOut[0] = (char)(0xF0 | ((iChar >> 18)));
-				pOut[1] = (char)(0x80 | ((iChar >> 12) & 0x3F));
-				pOut[2] = (char)(0x80 | ((iChar >> 6) & 0x3F));
-				pOut[3] = (char)(0x80 | ((iChar >> 0) & 0x3F));
-				return 4;
-			}
-		}
+	void Writer::SetOutput(WriteCallback pCallback, void* pUserData)
+	{
+		Close();
+		m_pWriteCallback = pCallback;
+		m_pWriteUserData = pUserData;
+		m_oStack.Clear();
+		m_bFirst = true;
+		m_bAfterKey = false;
+		m_bFailed = false;
+		m_iWrittenSize = 0;
+	}
 
-		return 0;
+	void Writer::SetOutput(char* pBuffer, size_t iSize)
+	{
+		SetOutput(&Writer::WriteMemoryCallback, this);
+		m_pOutput = pBuffer;
+		m_iOutputSize = iSize;
 	}
 
-	char* JsonValue::ReadStringValue(const char*& pString, const char* pEnd, Allocator* pAllocator)
+	bool Writer::Close()
 	{
-		size_t iLen = 0;
-		// Read string length
+		JsonStthmAssert(m_oStack.Size() == 0 || m_bFailed);
+		Flush();
+		if (m_pFile != NULL)
 		{
-			char pTemp[4];
-			const char* pCursor = pString;
-			while (pCursor < pEnd && *pCursor != 0)
-			{
-				if (*pCursor == '\\')
-				{
-					int iCharLen = ReadSpecialChar(++pCursor, pEnd, pTemp);
-					if (iCharLen == 0)
-						return NULL;
-					iLen += iCharLen;
-					++pCursor;
-					continue;
-				}
-				else if (*pCursor == '"')
-				{
-					++pCursor;
-					break;
-				}
+			m_bFailed |= fclose((FILE*)m_pFile) != 0;
+			m_pFile = NULL;
+		}
+		m_pWriteCallback = NULL;
+		m_pWriteUserData = NULL;
+		m_pOutput = NULL;
+		m_iOutputSize = 0;
+		return m_bFailed == false;
+	}
 
-				++iLen;
-				++pCursor;
-			}
+	bool Writer::Flush()
+	{
+		if (m_oBuffer.Size() > 0)
+		{
+			if (m_bFailed == false && m_pWriteCallback != NULL && m_pWriteCallback(m_oBuffer.Data(), m_oBuffer.Size(), m_pWriteUserData))
+				m_iWrittenSize += m_oBuffer.Size();
+			else
+				m_bFailed = true;
+			m_oBuffer.Clear();
 		}
+		return m_bFailed == false;
+	}
 
-		// Alloc string
-		char* pNewString = pAllocator->AllocString(iLen + 1, pAllocator->pUserData);
-		pNewString[iLen] = '\0';
-		char* pNewStringCursor = pNewString;
+	void Writer::BeginObject()
+	{
+		BeginValue();
+		m_oBuffer += '{';
+		m_oStack.Push('{');
+		m_bFirst = true;
+	}
 
-		// Read string
+	void Writer::EndObject()
+	{
+		JsonStthmAssert(m_oStack.Size() > 0 && m_oStack.Data()[m_oStack.Size() - 1] == '{' && m_bAfterKey == false);
+		m_oStack.Resize(m_oStack.Size() - 1);
+		if (m_bCompact == false)
 		{
-			while (pString < pEnd && *pString != 0)
-			{
-				if (*pString == '\\')
-				{
-					int iCharLen = ReadSpecialChar(++pString, pEnd, pNewStringCursor);
-					if (iCharLen == 0)
-						return NULL;
-					pNewStringCursor += iCharLen;
-					++pString;
-					continue;
-				}
-				else if (*pString == '"')
-				{
-					++pString;
-					return pNewString;
-				}
-
-				*pNewStringCursor = *pString;
-				++pNewStringCursor;
-				++pString;
-			}
+			m_oBuffer += '\n';
+			m_oBuffer.PushRepeat('\t', m_oStack.Size());
 		}
-		return NULL;
+		m_oBuffer += '}';
+		EndValue();
 	}
 
-	bool JsonValue::ReadNumericValue(const char*& pString, const char* pEnd, JsonValue& oValue)
+	void Writer::BeginArray()
 	{
-	#ifdef STTHM_USE_CUSTOM_NUMERIC_PARSER
-		static double const c_pExpTable[] = {
-			1e5, 1e4, 1e3, 1e2, 10, 1,
-			0.1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6,
-			1e-7, 1e-8, 1e-9, 1e-10, 1e-11, 1e-12,
-			1e-13, 1e-14, 1e-15, 1e-16, 1e-17
-		};
-		static double const* c_pExpLookup = &c_pExpTable[5];
+		BeginValue();
+		m_oBuffer += '[';
+		m_oStack.Push('[');
+		m_bFirst = true;
+	}
 
-		bool bNeg = false;
-		if (*pString == '-')
+	void Writer::EndArray()
+	{
+		JsonStthmAssert(m_oStack.Size() > 0 && m_oStack.Data()[m_oStack.Size() - 1] == '[');
+		m_oStack.Resize(m_oStack.Size() - 1);
+		if (m_bCompact == false)
 		{
-			++pString;
-			bNeg = true;
+			m_oBuffer += '\n';
+			m_oBuffer.PushRepeat('\t', m_oStack.Size());
 		}
+		m_oBuffer += ']';
+		EndValue();
+	}
 
-		uint64_t lValue = 0;
-		int iNegFract = 0;
-
-		while (pString < pEnd && Internal::IsDigit(*pString))
-			lValue = lValue * 10 + (*pString++ & 0xF);
+	void Writer::Key(const char* pName)
+	{
+		JsonStthmAssert(m_oStack.Size() > 0 && m_oStack.Data()[m_oStack.Size() - 1] == '{' && m_bAfterKey == false);
+		BeginValue();
+		m_oBuffer += '\"';
+		JsonValue::WriteStringEscaped(m_oBuffer, pName);
+		m_oBuffer += '\"';
+		m_oBuffer += ':';
+		if (m_bCompact == false)
+			m_oBuffer += ' ';
+		m_bAfterKey = true;
+	}
 
-		if (*pString == '.')
+	void Writer::Value(const char* pValue)
+	{
+		if (pValue == NULL)
 		{
-			const char* pStart = ++pString;
-
-			while (pString < pEnd && Internal::IsDigit(*pString))
-				lValue = lValue * 10 + (*pString++ & 0xF);
+			Null();
+			return;
+		}
+		BeginValue();
+		m_oBuffer += '\"';
+		JsonValue::WriteStringEscaped(m_oBuffer, pValue);
+		m_oBuffer += '\"';
+		EndValue();
+	}
 
-			iNegFract = (int)(pString - pStart);
+	void Writer::Value(bool bValue)
+	{
+		BeginValue();
+		if (bValue)
+			m_oBuffer.PushRange("true", 4);
+		else
+			m_oBuffer.PushRange("false", 5);
+		EndValue();
+	}
 
-			if (pString < pEnd && (*pString == 'e' || *pString == 'E'))
-			{
-				++pString;
+	void Writer::Value(int64_t iValue)
+	{
+		BeginValue();
+		Internal::WriteIntegerValue(m_oBuffer, iValue);
+		EndValue();
+	}
 
-				bool bNegExp = false;
-				if (pString < pEnd && *pString == '+')
-				{
-					++pString;
-				}
-				else if (pString < pEnd && *pString == '-')
-				{
-					++pString;
-					bNegExp = true;
-				}
+	void Writer::Value(double fValue)
+	{
+		BeginValue();
+		Internal::WriteFloatValue(m_oBuffer, fValue);
+		EndValue();
+	}
 
-				uint64_t iExpValue = 0;
-				while (pString < pEnd && Internal::IsDigit(*pString))
-					iExpValue = iExpValue * 10 + (*pString++ & 0xF);
+	void Writer::Value(const JsonValue& oValue)
+	{
+		oValue.LoadLazyChilds();
 
-				iNegFract += bNegExp ? (int)iExpValue : -(int)iExpValue;
-			}
-			oValue = (bNeg ? -1.0 : 1.0) * lValue * c_pExpLookup[iNegFract];
-		}
-		else
-		{
-			//TODO manage E/e for long?
-			oValue = (int64_t)(bNeg ? -(int64_t)lValue : lValue);
-		}
-		return true;
-	#else //STTHM_USE_CUSTOM_NUMERIC_PARSER
-		char* pEndDouble;
-		char* pEndLong;
-		double fValue = strtod(pString, &pEndDouble); // TODO : Unsafe
-		int64_t iValue = Internal::StrToInt64(pString, pEnd, &pEndLong);
-		if (pEndDouble > pEndLong)
-		{
-			pString = pEndDouble;
-			oValue.InitType(E_TYPE_FLOAT);
-			oValue.m_oValue.Float = fValue;
-		}
-		else
+		switch (oValue.m_eType)
 		{
-			pString = pEndLong;
-			oValue.InitType(E_TYPE_INTEGER);
-			oValue.m_oValue.Integer= iValue;
+		case JsonValue::E_TYPE_OBJECT:
+			BeginObject();
+			for (const JsonValue* pChild = oValue.m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+			{
+				Key(pChild->m_pName);
+				Value(*pChild);
+			}
+			EndObject();
+			break;
+		case JsonValue::E_TYPE_ARRAY:
+			BeginArray();
+			for (const JsonValue* pChild = oValue.m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext)
+				Value(*pChild);
+			EndArray();
+			break;
+		case JsonValue::E_TYPE_STRING:
+			Value((const char*)oValue.m_oValue.String);
+			break;
+		case JsonValue::E_TYPE_BOOLEAN:
+			Value(oValue.m_oValue.Boolean);
+			break;
+		case JsonValue::E_TYPE_INTEGER:
+			Value(oValue.m_oValue.Integer);
+			break;
+		case JsonValue::E_TYPE_FLOAT:
+			Value(oValue.m_oValue.Float);
+			break;
+		default:
+			Null();
+			break;
 		}
-
-		return true;
-	#endif // !STTHM_USE_CUSTOM_NUMERIC_PARSER
 	}
 
-	bool JsonValue::ReadObjectValue(const char*& pString, const char* pEnd, JsonValue& oValue)
+	void Writer::Null()
 	{
-		oValue.InitType(JsonValue::E_TYPE_OBJECT);
+		BeginValue();
+		m_oBuffer.PushRange("null", 4);
+		EndValue();
+	}
 
-		Internal::SkipSpaces(pString, pEnd);
+	void Writer::BeginValue()
+	{
+		if (m_bAfterKey)
+		{
+			m_bAfterKey = false;
+			return;
+		}
 
-		if (pString < pEnd && *pString == '}')
+		if (m_bFirst == false)
 		{
-			++pString;
-			return true;
+			// Root values are separated by a new line
+			m_oBuffer += (m_oStack.Size() > 0) ? ',' : '\n';
 		}
+		m_bFirst = false;
 
-		while (pString < pEnd && *pString != 0)
+		if (m_bCompact == false && m_oStack.Size() > 0)
 		{
-			Internal::SkipSpaces(pString, pEnd);
+			m_oBuffer += '\n';
+			m_oBuffer.PushRepeat('\t', m_oStack.Size());
+		}
+	}
 
-			// Read member name
-			if (pString >= pEnd || *pString != '"')
-				return false;
+	void Writer::EndValue()
+	{
+		m_bFirst = false;
+		if (m_oBuffer.Size() >= m_iFlushSize)
+			Flush();
+	}
 
-			char* pName = ReadStringValue(++pString, pEnd, oValue.m_pAllocator);
-			if (pName == NULL)
-				return false;
+	bool Writer::WriteFileCallback(const char* pData, size_t iSize, void* pUserData)
+	{
+		return fwrite(pData, 1, iSize, (FILE*)pUserData) == iSize;
+	}
 
-			JsonValue* pNewMember = oValue.m_pAllocator->CreateJsonValue(oValue.m_pAllocator, oValue.m_pAllocator->pUserData);
-			pNewMember->m_pName = pName;
+	bool Writer::WriteMemoryCallback(const char* pData, size_t iSize, void* pUserData)
+	{
+		Writer* pWriter = (Writer*)pUserData;
+		if (pWriter->m_iWrittenSize + iSize > pWriter->m_iOutputSize)
+			return false;
+		memcpy(pWriter->m_pOutput + pWriter->m_iWrittenSize, pData, iSize);
+		return true;
+	}
 
-			Internal::SkipSpaces(pString, pEnd);
+	//////////////////////////////
+	// Binding
+	//////////////////////////////
 
-			if (pString >= pEnd || *pString != ':')
+	namespace Internal
+	{
+		bool ReadBindingStruct(Reader& oReader, Reader::EEvent eEvent, void* pOut, const BindingMember* pMembers, size_t iMemberCount)
+		{
+			if (eEvent != Reader::E_EVENT_START_OBJECT)
 				return false;
 
-			++pString;
+			// Members usually come in declaration order, search starts after previous one
+			size_t iNextMember = 0;
+			while (true)
+			{
+				eEvent = oReader.Next();
+				if (eEvent == Reader::E_EVENT_END_OBJECT)
+					return true;
+				if (eEvent != Reader::E_EVENT_KEY)
+					return false;
 
-			Internal::SkipSpaces(pString, pEnd);
+				const char* pName = oReader.GetString();
+				const BindingMember* pMember = NULL;
+				for (size_t iSearch = 0; iSearch < iMemberCount; ++iSearch)
+				{
+					size_t iMember = iNextMember + iSearch;
+					if (iMember >= iMemberCount)
+						iMember -= iMemberCount;
+					if (strcmp(pMembers[iMember].pName, pName) == 0)
+					{
+						pMember = pMembers + iMember;
+						iNextMember = iMember + 1;
+						break;
+					}
+				}
 
-			if (pNewMember->Parse(pString, pEnd) == false)
-			{
-				oValue.m_pAllocator->DeleteJsonValue(pNewMember, oValue.m_pAllocator->pUserData);
-				return false;
+				eEvent = oReader.Next();
+				if (pMember == NULL || eEvent == Reader::E_EVENT_NULL)
+				{
+					if (SkipBindingValue(oReader, eEvent) == false)
+						return false;
+				}
+				else if (pMember->Read(oReader, eEvent, pOut, pMember->pMember) == false)
+				{
+					return false;
+				}
 			}
+		}
 
-			if (oValue.m_oValue.Childs.m_pFirst == NULL)
-			{
-				oValue.m_oValue.Childs.m_pFirst = pNewMember;
-			}
-			else
+		void WriteBindingStruct(Writer& oWriter, const void* pValue, const BindingMember* pMembers, size_t iMemberCount)
+		{
+			oWriter.BeginObject();
+			for (size_t iMember = 0; iMember < iMemberCount; ++iMember)
 			{
-				oValue.m_oValue.Childs.m_pLast->m_pNext = pNewMember;
+				oWriter.Key(pMembers[iMember].pName);
+				pMembers[iMember].Write(oWriter, pValue, pMembers[iMember].pMember);
 			}
-			oValue.m_oValue.Childs.m_pLast = pNewMember;
-
-			Internal::SkipSpaces(pString, pEnd);
+			oWriter.EndObject();
+		}
 
-			if (*pString == '}')
+		bool SkipBindingValue(Reader& oReader, Reader::EEvent eEvent)
+		{
+			switch (eEvent)
 			{
-				++pString;
+			case Reader::E_EVENT_START_OBJECT:
+			case Reader::E_EVENT_START_ARRAY:
+			{
+				// Read by Next() up to its end, SkipContainer() would only check strings and braces
+				const int iDepth = oReader.GetDepth();
+				do
+				{
+					eEvent = oReader.Next();
+					if (eEvent == Reader::E_EVENT_ERROR || eEvent == Reader::E_EVENT_END || eEvent == Reader::E_EVENT_NEED_INPUT)
+						return false;
+				}
+				while (oReader.GetDepth() >= iDepth);
 				return true;
 			}
-			else if (*pString != ',')
-			{
+			case Reader::E_EVENT_STRING:
+			case Reader::E_EVENT_INTEGER:
+			case Reader::E_EVENT_FLOAT:
+			case Reader::E_EVENT_BOOLEAN:
+			case Reader::E_EVENT_NULL:
+				return true;
+			default:
 				return false;
 			}
-			++pString;
 		}
-		return false;
 	}
 
-	bool JsonValue::ReadArrayValue(const char*& pString, const char* pEnd, JsonValue& oValue)
+	//////////////////////////////
+	// JsonPath
+	//////////////////////////////
+
+	JsonPath::JsonPath()
+		: m_pSegments(NULL)
+		, m_iSegmentCount(0)
+		, m_bValid(false)
+		, m_bSingle(false)
 	{
-		oValue.InitType(JsonValue::E_TYPE_ARRAY);
+	}
 
-		Internal::SkipSpaces(pString, pEnd);
-		if (*pString == ']')
+	JsonPath::JsonPath(const char* pPath)
+		: m_pSegments(NULL)
+		, m_iSegmentCount(0)
+		, m_bValid(false)
+		, m_bSingle(false)
+	{
+		Compile(pPath);
+	}
+
+	JsonPath::~JsonPath()
+	{
+		Clear();
+	}
+
+	void JsonPath::Clear()
+	{
+		if (m_pSegments != NULL)
 		{
-			++pString;
-			return true;
+			JsonStthmFree(m_pSegments);
+			m_pSegments = NULL;
 		}
+		m_iSegmentCount = 0;
+		m_bValid = false;
+		m_bSingle = false;
+	}
 
-		while (pString < pEnd && *pString != 0)
-		{
-			Internal::SkipSpaces(pString, pEnd);
+	bool JsonPath::Compile(const char* pPath)
+	{
+		Clear();
 
-			JsonValue* pNewValue = oValue.m_pAllocator->CreateJsonValue(oValue.m_pAllocator, oValue.m_pAllocator->pUserData);
+		if (pPath == NULL)
+			return false;
 
-			if (pNewValue->Parse(pString, pEnd) == false)
-			{
-				oValue.m_pAllocator->DeleteJsonValue(pNewValue, oValue.m_pAllocator->pUserData);
+		SegmentBuffer oSegments;
+		NameBuffer oNames;
 
-				return false;
-			}
+		// JSON Pointers are empty or start with '/'
+		bool bValid;
+		if (*pPath == 0 || *pPath == '/')
+			bValid = CompilePointer(pPath, oSegments, oNames);
+		else
+			bValid = CompileExpression(pPath, oSegments, oNames);
 
-			if (oValue.m_oValue.Childs.m_pFirst == NULL)
-			{
-				oValue.m_oValue.Childs.m_pFirst = pNewValue;
-			}
-			else
-			{
-				oValue.m_oValue.Childs.m_pLast->m_pNext = pNewValue;
-			}
-			oValue.m_oValue.Childs.m_pLast = pNewValue;
+		if (bValid == false)
+			return false;
 
-			Internal::SkipSpaces(pString, pEnd);
+		if (oSegments.Size() > 0)
+		{
+			m_pSegments = (Segment*)JsonStthmMalloc(oSegments.Size() * sizeof(Segment) + oNames.Size());
+			JsonStthmAssert(m_pSegments != NULL);
+			oSegments.WriteTo(m_pSegments);
+			oNames.WriteTo((char*)(m_pSegments + oSegments.Size()));
+		}
+		m_iSegmentCount = oSegments.Size();
+		m_bValid = true;
 
-			if (*pString == ']')
-			{
-				++pString;
-				return true;
-			}
-			else if (*pString != ',')
-			{
-				return false;
-			}
-			++pString;
+		m_bSingle = true;
+		for (size_t iSegment = 0; iSegment < m_iSegmentCount; ++iSegment)
+		{
+			ESegmentType eType = m_pSegments[iSegment].m_eType;
+			m_bSingle &= eType == E_SEGMENT_MEMBER || eType == E_SEGMENT_INDEX;
 		}
-		return false;
+		return true;
 	}
 
-	void JsonValue::WriteStringEscaped(Internal::CharBuffer& sOutJson, const char* pInput)
+	bool JsonPath::CompilePointer(const char* pPath, SegmentBuffer& oSegments, NameBuffer& oNames)
 	{
-		while (*pInput != '\0')
+		while (*pPath == '/')
 		{
-			char cChar = *pInput;
-			if (cChar == '\n')
-			{
-				sOutJson.PushRange("\\n", 2);
-			}
-			else if (cChar == '\r')
-			{
-				sOutJson.PushRange("\\r", 2);
-			}
-			else if (cChar == '\t')
-			{
-				sOutJson.PushRange("\\t", 2);
-			}
-			else if (cChar == '\b')
-			{
-				sOutJson.PushRange("\\b", 2);
-			}
-			else if (cChar == '\f')
-			{
-				sOutJson.PushRange("\\f", 2);
-			}
-			else if (cChar == '"')
-			{
-				sOutJson.PushRange("\\\"", 2);
-			}
-			else if (cChar == '\\')
-			{
-				sOutJson.PushRange("\\\\", 2);
-			}
-			else if ((unsigned char)cChar < 0x80)
-			{
-				sOutJson += cChar;
-			}
-			else
+			++pPath;
+			size_t iName = oNames.Size();
+			while (*pPath != 0 && *pPath != '/')
 			{
-				uint32_t iChar = (unsigned char)cChar;
-				if ((iChar & 0xE0) == 0xC0) // 2 byte
+				char cChar = *pPath++;
+				if (cChar == '~')
 				{
-					iChar = ((((unsigned char)pInput[0]) & 0x1F) << 6)
-						+ ((((unsigned char)pInput[1]) & 0x3F) << 0);
-					pInput += 1;
+					if (*pPath == '0')
+						cChar = '~';
+					else if (*pPath == '1')
+						cChar = '/';
+					else
+						return false;
+					++pPath;
 				}
-				else if ((iChar & 0xF0) == 0xE0) // 3 bytes
+				oNames.Push(cChar);
+			}
+			PushMember(oSegments, oNames, iName, true);
+		}
+		return *pPath == 0;
+	}
+
+	bool JsonPath::CompileExpression(const char* pPath, SegmentBuffer& oSegments, NameBuffer& oNames)
+	{
+		// First member can be written without '.' when path doesn't start with '$'
+		bool bFirst = true;
+		if (*pPath == '$')
+		{
+			++pPath;
+			bFirst = false;
+		}
+
+		while (*pPath != 0)
+		{
+			if (*pPath == '[')
+			{
+				++pPath;
+				if (*pPath == '*')
 				{
-					iChar = ((((unsigned char)pInput[0]) & 0x0F) << 12)
-						+ ((((unsigned char)pInput[1]) & 0x3F) << 6)
-						+ ((((unsigned char)pInput[2]) & 0x3F) << 0);
-					pInput += 2;
+					++pPath;
+					PushSegment(oSegments, E_SEGMENT_WILDCARD);
 				}
-				else if ((iChar & 0xF8) == 0xF0 && iChar <= 0xF4) // 4 bytes
+				else if (*pPath == '\'' || *pPath == '"')
 				{
-					iChar = ((((unsigned char)pInput[0]) & 0x07) << 18)
-						+ ((((unsigned char)pInput[1]) & 0x3F) << 12)
-						+ ((((unsigned char)pInput[2]) & 0x3F) << 6)
-						+ ((((unsigned char)pInput[3]) & 0x3F) << 0);
-					pInput += 3;
+					const char cQuote = *pPath++;
+					size_t iName = oNames.Size();
+					while (*pPath != cQuote)
+					{
+						if (*pPath == 0)
+							return false;
+						if (*pPath == '\\' && pPath[1] != 0)
+							++pPath;
+						oNames.Push(*pPath++);
+					}
+					++pPath;
+					PushMember(oSegments, oNames, iName, false);
 				}
 				else
 				{
-					//Invalid char
-					JsonStthmAssert(false);
-					iChar = 0;
+					int iStart = 0, iEnd = 0, iStep = 1;
+					bool bStart = ParseIndex(pPath, iStart);
+					if (*pPath == ':')
+					{
+						++pPath;
+						bool bEnd = ParseIndex(pPath, iEnd);
+						if (*pPath == ':')
+						{
+							++pPath;
+							// Only forward steps, values are matched in document order
+							if (ParseIndex(pPath, iStep) && iStep <= 0)
+								return false;
+						}
+						PushSegment(oSegments, E_SEGMENT_SLICE, iStart, iEnd, iStep, (bStart ? E_SLICE_START : 0) | (bEnd ? E_SLICE_END : 0));
+					}
+					else if (bStart)
+					{
+						PushSegment(oSegments, E_SEGMENT_INDEX, iStart);
+					}
+					else
+					{
+						return false;
+					}
 				}
 
-				const char* const pHexa = "0123456789abcdef";
+				if (*pPath != ']')
+					return false;
+				++pPath;
+			}
+			else if (*pPath == '.' || bFirst)
+			{
+				if (*pPath == '.')
+					++pPath;
 
-				if (iChar < 0xFFFF)
+				if (*pPath == '*')
 				{
-					sOutJson.PushRange("\\u", 2);
-					sOutJson.Push(pHexa[(iChar >> 12) & 0x0f]);
-					sOutJson.Push(pHexa[(iChar >> 8) & 0x0f]);
-					sOutJson.Push(pHexa[(iChar >> 4) & 0x0f]);
-					sOutJson.Push(pHexa[(iChar >> 0) & 0x0f]);
+					++pPath;
+					PushSegment(oSegments, E_SEGMENT_WILDCARD);
 				}
 				else
 				{
-					//UTF-16 pair surrogate
-					uint32_t iCharBis = iChar - 0x10000;
-					uint32_t iW1 = 0xD800 | ((iCharBis >> 10) & 0x3FF);
-					uint32_t iW2 = 0xDC00 | (iCharBis & 0x3FF);
-					sOutJson.PushRange("\\u", 2);
-					sOutJson.Push(pHexa[(iW1 >> 12) & 0x0f]);
-					sOutJson.Push(pHexa[(iW1 >> 8) & 0x0f]);
-					sOutJson.Push(pHexa[(iW1 >> 4) & 0x0f]);
-					sOutJson.Push(pHexa[(iW1 >> 0) & 0x0f]);
-					sOutJson.PushRange("\\u", 2);
-					sOutJson.Push(pHexa[(iW2 >> 12) & 0x0f]);
-					sOutJson.Push(pHexa[(iW2 >> 8) & 0x0f]);
-					sOutJson.Push(pHexa[(iW2 >> 4) & 0x0f]);
-					sOutJson.Push(pHexa[(iW2 >> 0) & 0x0f]);
+					size_t iName = oNames.Size();
+					while (*pPath != 0 && *pPath != '.' && *pPath != '[')
+						oNames.Push(*pPath++);
+					if (oNames.Size() == iName)
+						return false;
+					PushMember(oSegments, oNames, iName, false);
 				}
 			}
-
-			++pInput;
+			else
+			{
+				return false;
+			}
+			bFirst = false;
 		}
+		return true;
 	}
 
-	JsonValue* JsonValue::DefaultAllocatorCreateJsonValue(Allocator* pAllocator, void* /*pUserData*/)
+	void JsonPath::PushSegment(SegmentBuffer& oSegments, ESegmentType eType, int iIndex, int iEnd, int iStep, int iSliceFlags)
 	{
-		return new JsonValue(pAllocator);
+		Segment oSegment;
+		oSegment.m_eType = eType;
+		oSegment.m_iName = 0;
+		oSegment.m_iHash = 0;
+		oSegment.m_iIndex = iIndex;
+		oSegment.m_iEnd = iEnd;
+		oSegment.m_iStep = iStep;
+		oSegment.m_iSliceFlags = iSliceFlags;
+		oSegments.Push(oSegment);
 	}
 
-	void JsonValue::DefaultAllocatorDeleteJsonValue(JsonValue* pValue, void* /*pUserData*/)
+	void JsonPath::PushMember(SegmentBuffer& oSegments, NameBuffer& oNames, size_t iName, bool bPointerToken)
 	{
-		delete pValue;
-	}
+		oNames.Push(0);
+		const char* pName = oNames.Data() + iName;
 
-	char* JsonValue::DefaultAllocatorAllocString(size_t iSize, void* /*pUserData*/)
-	{
-		return (char*)JsonStthmMalloc(iSize);
+		// Pointer token "0" or digits without leading zero is also an array index
+		int iIndex = -1;
+		size_t iLength = strlen(pName);
+		if (bPointerToken && iLength > 0 && iLength <= 9 && (pName[0] != '0' || iLength == 1))
+		{
+			iIndex = 0;
+			for (size_t iChar = 0; iChar < iLength && iIndex >= 0; ++iChar)
+				iIndex = (pName[iChar] >= '0' && pName[iChar] <= '9') ? iIndex * 10 + (pName[iChar] - '0') : -1;
+		}
+
+		PushSegment(oSegments, E_SEGMENT_MEMBER, iIndex);
+		Segment& oSegment = oSegments.Data()[oSegments.Size() - 1];
+		oSegment.m_iName = (uint32_t)iName;
+		oSegment.m_iHash = Internal::HashString(pName);
 	}
 
-	void JsonValue::DefaultAllocatorFreeString(char* pString, void* /*pUserData*/)
+	bool JsonPath::ParseIndex(const char*& pString, int& iIndex)
 	{
-		JsonStthmFree(pString);
-	}
+		const char* pChar = pString;
+		bool bNegative = *pChar == '-';
+		if (bNegative)
+			++pChar;
+
+		int iValue = 0;
+		int iDigits = 0;
+		while (*pChar >= '0' && *pChar <= '9' && iDigits < 9)
+		{
+			iValue = iValue * 10 + (*pChar++ - '0');
+			++iDigits;
+		}
 
-	//////////////////////////////
-	// JsonDoc
-	//////////////////////////////
+		if (iDigits == 0)
+			return false;
 
-	JsonDoc::JsonDoc(size_t iBlockSize)
-		: m_oRoot(&m_oAllocator)
-		, m_iBlockSize(iBlockSize)
-		, m_pLastBlock(NULL)
+		iIndex = bNegative ? -iValue : iValue;
+		pString = pChar;
+		return true;
+	}
+
+	const JsonValue* JsonPath::FindChild(const JsonValue& oNode, const Segment& oSegment) const
 	{
-		m_oAllocator.CreateJsonValue	= &JsonDoc::CreateJsonValue;
-		m_oAllocator.DeleteJsonValue	= &JsonDoc::DeleteJsonValue;
-		m_oAllocator.AllocString		= &JsonDoc::AllocString;
-		m_oAllocator.FreeString			= &JsonDoc::FreeString;
-		m_oAllocator.pUserData			= this;
+		if (oSegment.m_eType == E_SEGMENT_MEMBER)
+		{
+			if (oNode.m_eType == JsonValue::E_TYPE_OBJECT)
+			{
+				// Hash was computed on compilation
+				oNode.LoadLazyChilds();
+				if (oNode.m_iFlags & JsonValue::E_FLAG_INDEXED)
+					return oNode.FindIndexedMember(GetName(oSegment), oSegment.m_iHash);
+				return oNode.FindMember(GetName(oSegment));
+			}
+			if (oNode.m_eType == JsonValue::E_TYPE_ARRAY && oSegment.m_iIndex >= 0)
+				return oNode.FindChild(oSegment.m_iIndex);
+		}
+		else if (oSegment.m_eType == E_SEGMENT_INDEX && oNode.m_eType == JsonValue::E_TYPE_ARRAY)
+		{
+			int iIndex = oSegment.m_iIndex;
+			if (iIndex < 0)
+				iIndex += oNode.GetMemberCount();
+			return oNode.FindChild(iIndex);
+		}
+		return NULL;
 	}
 
-	JsonDoc::~JsonDoc()
+	const JsonValue* JsonPath::FindSingle(const JsonValue& oNode, size_t iSegment) const
 	{
-		Clear();
+		JsonStthmAssert(m_bSingle);
+		const JsonValue* pValue = &oNode;
+		for (; iSegment < m_iSegmentCount && pValue != NULL; ++iSegment)
+			pValue = FindChild(*pValue, m_pSegments[iSegment]);
+		return pValue;
 	}
 
-	void JsonDoc::Clear()
+	bool JsonPath::MatchChild(const JsonValue& oParent, const JsonValue& oChild, int iPosition, int iCount, const Segment& oSegment) const
 	{
-		m_oRoot.m_eType = JsonValue::E_TYPE_NULL;
-		Block* pBlock = m_pLastBlock;
-		while (pBlock != NULL)
+		switch (oSegment.m_eType)
 		{
-			Block* pPrevious = pBlock->m_pPrevious;
-			JsonStthmFree(pBlock);
-			pBlock = pPrevious;
+		case E_SEGMENT_MEMBER:
+			if (oParent.m_eType == JsonValue::E_TYPE_OBJECT)
+				return strcmp(oChild.m_pName, GetName(oSegment)) == 0;
+			return iPosition == oSegment.m_iIndex;
+		case E_SEGMENT_INDEX:
+			return oParent.m_eType == JsonValue::E_TYPE_ARRAY && iPosition == (oSegment.m_iIndex < 0 ? iCount + oSegment.m_iIndex : oSegment.m_iIndex);
+		case E_SEGMENT_WILDCARD:
+			return true;
+		case E_SEGMENT_SLICE:
+			if (oParent.m_eType == JsonValue::E_TYPE_ARRAY)
+			{
+				int iStart, iEnd;
+				GetSliceBounds(oSegment, iCount, iStart, iEnd);
+				return iPosition >= iStart && iPosition < iEnd && ((iPosition - iStart) % oSegment.m_iStep) == 0;
+			}
+			return false;
 		}
-		m_pLastBlock = NULL;
+		return false;
 	}
 
-	int JsonDoc::ReadString(const char* pJson, const char* pEnd)
+	bool JsonPath::NeedCount(const Segment& oSegment)
 	{
-		Clear();
-		return m_oRoot.ReadString(pJson, pEnd);
+		if (oSegment.m_eType == E_SEGMENT_INDEX)
+			return oSegment.m_iIndex < 0;
+		if (oSegment.m_eType == E_SEGMENT_SLICE)
+			return ((oSegment.m_iSliceFlags & E_SLICE_START) && oSegment.m_iIndex < 0) || ((oSegment.m_iSliceFlags & E_SLICE_END) && oSegment.m_iEnd < 0);
+		return false;
 	}
 
-	int JsonDoc::ReadFile(const char* pFilename)
+	void JsonPath::GetSliceBounds(const Segment& oSegment, int iCount, int& iStart, int& iEnd)
 	{
-		Clear();
-		return m_oRoot.ReadFile(pFilename);
+		iStart = 0;
+		iEnd = 0x7FFFFFFF;
+		if (oSegment.m_iSliceFlags & E_SLICE_START)
+		{
+			iStart = oSegment.m_iIndex;
+			if (iStart < 0)
+				iStart = (iCount + iStart) > 0 ? iCount + iStart : 0;
+		}
+		if (oSegment.m_iSliceFlags & E_SLICE_END)
+		{
+			iEnd = oSegment.m_iEnd;
+			if (iEnd < 0)
+				iEnd = (iCount + iEnd) > 0 ? iCount + iEnd : 0;
+		}
 	}
 
-	void* JsonDoc::Allocate(JsonDoc* pDoc, size_t iSize, size_t iAlign)
+	bool JsonPath::SelectRecursive(const JsonValue& oNode, size_t iSegment, MatchCallback pCallback, void* pUserData, size_t& iMatchCount) const
 	{
-		Block* pHead = pDoc->m_pLastBlock;
-		if (pHead != NULL && (iSize + iAlign + pHead->m_iUsed) <= pDoc->m_iBlockSize)
+		if (iSegment == m_iSegmentCount)
 		{
-			char* pMem = ((char*)pHead) + pHead->m_iUsed;
-			size_t iAlignOffset = iAlign - ((intptr_t)pMem % iAlign);
-			pMem += iAlignOffset;
-
-			JsonStthmAssert((intptr_t)pMem % iAlign == 0);
+			++iMatchCount;
+			return pCallback == NULL || pCallback(oNode, pUserData);
+		}
 
-			pHead->m_iUsed += iSize + iAlignOffset;
-			return pMem;
+		const Segment& oSegment = m_pSegments[iSegment];
+		if (oSegment.m_eType == E_SEGMENT_MEMBER || oSegment.m_eType == E_SEGMENT_INDEX)
+		{
+			const JsonValue* pChild = FindChild(oNode, oSegment);
+			return pChild == NULL || SelectRecursive(*pChild, iSegment + 1, pCallback, pUserData, iMatchCount);
 		}
 
-		size_t iAllocSize = sizeof(Block) + iSize + iAlign;
-		size_t iBlockSize = (iAllocSize <= pDoc->m_iBlockSize) ? pDoc->m_iBlockSize : iAllocSize;
-		Block* pBlock = (Block*)JsonStthmMalloc(iBlockSize);
+		if (oNode.IsContainer() == false)
+			return true;
 
-		char* pMem = (char*)(pBlock + 1);
-		size_t iAlignOffset = iAlign - ((intptr_t)pMem % iAlign);
-		pMem += iAlignOffset;
+		oNode.LoadLazyChilds();
+		const int iCount = NeedCount(oSegment) ? oNode.GetMemberCount() : -1;
 
-		pBlock->m_iUsed = sizeof(Block) + iSize + iAlignOffset;
+		int iSliceStart, iSliceEnd;
+		GetSliceBounds(oSegment, iCount, iSliceStart, iSliceEnd);
 
-		if (iAllocSize <= iBlockSize || pHead == NULL)
+		int iPosition = 0;
+		for (const JsonValue* pChild = oNode.m_oValue.Childs.m_pFirst; pChild != NULL; pChild = pChild->m_pNext, ++iPosition)
 		{
-			pBlock->m_pPrevious = pHead;
-			pDoc->m_pLastBlock = pBlock;
-		}
-		else
-		{
-			pBlock->m_pPrevious = pHead->m_pPrevious;
-			pHead->m_pPrevious = pBlock;
-		}
+			if (oSegment.m_eType == E_SEGMENT_SLICE && iPosition >= iSliceEnd)
+				break;
 
-		JsonStthmAssert((intptr_t)pMem % iAlign == 0);
+			if (MatchChild(oNode, *pChild, iPosition, iCount, oSegment) && SelectRecursive(*pChild, iSegment + 1, pCallback, pUserData, iMatchCount) == false)
+				return false;
+		}
+		return true;
+	}
 
-		return pMem;
+	bool JsonPath::GetFirstCallback(const JsonValue& oValue, void* pUserData)
+	{
+		*(const JsonValue**)pUserData = &oValue;
+		return false;
 	}
 
-	JsonValue* JsonDoc::CreateJsonValue(Allocator* pAllocator, void* pUserData)
+	const JsonValue& JsonPath::Get(const JsonValue& oRoot) const
 	{
-		JsonValue* pValue = (JsonValue*)Allocate((JsonDoc*)pUserData, sizeof(JsonValue), alignof(JsonValue));
-		if (pValue != NULL)
+		if (m_bValid == false)
+			return JsonValue::INVALID;
+
+		const JsonValue* pValue;
+		if (m_bSingle)
 		{
-			memset(pValue, 0, sizeof(JsonValue));
-			pValue->m_pAllocator = pAllocator;
-			return pValue;
+			pValue = FindSingle(oRoot, 0);
+		}
+		else
+		{
+			pValue = NULL;
+			size_t iMatchCount = 0;
+			SelectRecursive(oRoot, 0, GetFirstCallback, &pValue, iMatchCount);
 		}
-		return NULL;
-	}
 
-	void JsonDoc::DeleteJsonValue(JsonValue* /*pValue*/, void* /*pUserData*/)
-	{
-		// Do nothing
+		return (pValue != NULL) ? *pValue : JsonValue::INVALID;
 	}
 
-	char* JsonDoc::AllocString(size_t iSize, void* pUserData)
+	JsonValue& JsonPath::Get(JsonValue& oRoot) const
 	{
-		return (char*)Allocate((JsonDoc*)pUserData, iSize, 1);
+		return const_cast<JsonValue&>(Get((const JsonValue&)oRoot));
 	}
 
-	void JsonDoc::FreeString(char* /*pString*/, void* /*pUserData*/)
+	size_t JsonPath::Select(const JsonValue& oRoot, MatchCallback pCallback, void* pUserData) const
 	{
-		// Do nothing
+		size_t iMatchCount = 0;
+		if (m_bValid)
+			SelectRecursive(oRoot, 0, pCallback, pUserData, iMatchCount);
+		return iMatchCount;
 	}
 
-	size_t JsonDoc::MemoryUsage() const
+	void JsonPath::GetAll(const JsonValue& oRoot, const JsonPath* pPaths, size_t iPathCount, const JsonValue** pOutValues)
 	{
-		Block* pBlock = m_pLastBlock;
-		size_t iSize = 0;
-		while (pBlock != NULL)
+		// Values found by previous single path, from root
+		Internal::Buffer<const JsonValue*, 16> oNodes;
+		const JsonPath* pPrevious = NULL;
+
+		for (size_t iPath = 0; iPath < iPathCount; ++iPath)
 		{
-			iSize += (pBlock->m_iUsed > m_iBlockSize) ? pBlock->m_iUsed : m_iBlockSize;
-			pBlock = pBlock->m_pPrevious;
+			const JsonPath& oPath = pPaths[iPath];
+			if (oPath.m_bSingle == false)
+			{
+				const JsonValue& oValue = oPath.Get(oRoot);
+				pOutValues[iPath] = (&oValue != &JsonValue::INVALID) ? &oValue : NULL;
+				continue;
+			}
+
+			size_t iCommon = 0;
+			if (pPrevious != NULL)
+			{
+				while (iCommon + 1 < oNodes.Size() && iCommon < oPath.m_iSegmentCount && oPath.IsSameSegment(*pPrevious, iCommon))
+					++iCommon;
+			}
+
+			oNodes.Resize(iCommon + 1);
+			oNodes.Data()[0] = &oRoot;
+			const JsonValue* pValue = oNodes.Data()[iCommon];
+			for (size_t iSegment = iCommon; iSegment < oPath.m_iSegmentCount && pValue != NULL; ++iSegment)
+			{
+				pValue = oPath.FindChild(*pValue, oPath.m_pSegments[iSegment]);
+				if (pValue != NULL)
+					oNodes.Push(pValue);
+			}
+
+			pOutValues[iPath] = pValue;
+			pPrevious = &oPath;
 		}
-		return iSize;
+	}
+
+	bool JsonPath::IsSameSegment(const JsonPath& oOther, size_t iSegment) const
+	{
+		const Segment& oSegment = m_pSegments[iSegment];
+		const Segment& oOtherSegment = oOther.m_pSegments[iSegment];
+		return oSegment.m_eType == oOtherSegment.m_eType
+			&& oSegment.m_iHash == oOtherSegment.m_iHash
+			&& oSegment.m_iIndex == oOtherSegment.m_iIndex
+			&& (oSegment.m_eType != E_SEGMENT_MEMBER || strcmp(GetName(oSegment), oOther.GetName(oOtherSegment)) == 0);
 	}
 }
@@ -86,6 +86,11 @@ namespace JsonStthm
 				return m_iSize;
 			}
 
+			size_t Capacity() const
+			{
+				return m_iCapacity;
+			}
+
 			void Reserve(size_t iCapacity, bool bForceAlloc = false)
 			{
 				if (iCapacity != m_iCapacity)
@@ -116,6 +121,7 @@ namespace JsonStthm
 			}
 
 			const T* Data() const { return m_pData; }
+			T* Data() { return m_pData; }
 
 			T* Take(Allocator* pAllocator)
 			{
@@ -162,11 +168,64 @@ namespace JsonStthm
 		};
 
 		typedef Buffer<char> CharBuffer;
+
+		struct WriteContext;
+		struct WriteParts;
 	}
 
+	// Output format of JsonValue::Write, default options give same output as Write(sOutJson, 0, bCompact)
+	struct STTHM_API WriteOptions
+	{
+		enum ENewLine
+		{
+			E_NEWLINE_LF = 0,
+			E_NEWLINE_CRLF
+		};
+
+		enum EFloatFormat
+		{
+			E_FLOAT_SHORTEST = 0,	// Shortest digits read back to same double
+			E_FLOAT_SIGNIFICANT		// Shortest digits rounded to iFloatPrecision significant digits
+		};
+
+		bool				bCompact;
+		// Pretty print only
+		char				cIndentChar;
+		int					iIndentWidth;	// Chars by level
+		ENewLine			eNewLine;
+		// Members sorted by name (strcmp order) instead of insertion order
+		bool				bSortKeys;
+		EFloatFormat		eFloatFormat;
+		int					iFloatPrecision;
+		// Output buffer is reserved once with this size when not 0, like size of previous output of a similar value
+		// EstimateWriteSize() can give it but its walk of the tree costs more than growing the buffer while writing
+		size_t				iReserveSize;
+		// Childs of a root container with at least 1024 childs are written on iThreadCount threads (0 for all hardware threads)
+		// Output is the same, WriteFile writes parts of each thread one after the other without joining them
+		int					iThreadCount;
+
+		WriteOptions(bool bCompactOutput = false)
+			: bCompact(bCompactOutput)
+			, cIndentChar('\t')
+			, iIndentWidth(1)
+			, eNewLine(E_NEWLINE_LF)
+			, bSortKeys(false)
+			, eFloatFormat(E_FLOAT_SHORTEST)
+			, iFloatPrecision(17)
+			, iReserveSize(0)
+			, iThreadCount(1)
+		{
+		}
+	};
+
 	class STTHM_API JsonValue
 	{
 		friend class JsonDoc;
+		friend class JsonLinesDoc;
+		friend class CompactDoc;
+		friend class Reader;
+		friend class Writer;
+		friend class JsonPath;
 	public:
 		enum EType
 		{
@@ -196,11 +255,15 @@ namespace JsonStthm
 		};
 
 		static JsonValue	INVALID;
-	protected:
+
+		// Childs and strings are allocated with pAllocator, which should outlive the value
 							JsonValue(Allocator* pAllocator);
-	public:
 							JsonValue();
 							JsonValue(const JsonValue& oSource);
+#if defined(STTHM_USE_MOVE)
+							// Content of oSource is moved without copy, value use the allocator of oSource
+							JsonValue(JsonValue&& oSource);
+#endif //STTHM_USE_MOVE
 							JsonValue(bool bValue);
 #ifdef JsonStthmString
 							JsonValue(const JsonStthmString& sValue);
@@ -218,14 +281,32 @@ namespace JsonStthm
 		int					ReadFile(const char* pFilename);
 
 		void				Write(Internal::CharBuffer& sOutJson, size_t iIndent, bool bCompact) const;
+		void				Write(Internal::CharBuffer& sOutJson, const WriteOptions& oOptions) const;
 #ifdef JsonStthmString
 		void				WriteString(JsonStthmString& sOutJson, bool bCompact = false) const;
+		void				WriteString(JsonStthmString& sOutJson, const WriteOptions& oOptions) const;
 #endif //JsonStthmString
 		char*				WriteString(bool bCompact) const;
 		bool				WriteFile(const char* pFilename, bool bCompact = false) const;
+		bool				WriteFile(const char* pFilename, const WriteOptions& oOptions) const;
+		// Upper bound of output size, except for escaped chars of strings counted as one char
+		// Walk the whole tree, about a fifth of the time of writing a pretty printed document
+		size_t				EstimateWriteSize(const WriteOptions& oOptions) const;
+
+		// MessagePack encoding of one value, return 0 on success or offset + 1 of the invalid byte
+		// Binary and extension types are not supported, map keys must be strings
+		int					ReadMsgPack(const void* pData, size_t iSize);
+		void				WriteMsgPack(Internal::CharBuffer& oOut) const;
+#ifdef JsonStthmString
+		void				WriteMsgPack(JsonStthmString& sOut) const;
+#endif //JsonStthmString
 
 		int					GetMemberCount() const;
 
+		// Index childs of a large container for lookups by const operator[], see STTHM_OBJECT_INDEX_THRESHOLD and STTHM_ARRAY_INDEX_THRESHOLD
+		// Parsed containers are already indexed, other ones are indexed by a lookup with non-const operator[]
+		void				BuildIndex();
+
 		const char*			GetName() const { return m_pName; }
 		const JsonValue*	GetNext() const { return m_pNext; }
 
@@ -264,9 +345,24 @@ namespace JsonStthm
 		// Other types will just add values
 		bool				Combine(const JsonValue& oRight, bool bMergeSubMembers);
 
+		// Move content of oSource in this value, oSource become null
+		// Childs and strings are relinked when both values use same allocator, copied otherwise
+		// Return false and do nothing when this value is a descendant of oSource, childs of a container oSource are walked to check it
+		bool				MoveFrom(JsonValue& oSource);
+		// Remove a child and move its content in oOut
+		// Return false and keep the child when it is not found, or when oOut is this child or one of its descendants
+		bool				Detach(const char* pName, JsonValue& oOut);
+		bool				Detach(int iIndex, JsonValue& oOut);
+		// Move all childs of oSource at the end of this container, oSource stay an empty container of same type
+		// Childs are relinked when both values use same allocator, copied otherwise. Member names are not checked
+		// Return false and do nothing when this value is oSource or one of its descendants
+		bool				Splice(JsonValue& oSource);
+
 		bool				operator ==(const JsonValue& oRight) const;
 		bool				operator !=(const JsonValue& oRight) const;
 
+		// Const lookups only read, they can run on several threads (except on first access of a lazy container)
+		// Non-const ones create missing childs and index large containers
 		const JsonValue&	operator [](const char* pName) const;
 		JsonValue&			operator [](const char* pName);
 
@@ -277,6 +373,10 @@ namespace JsonStthm
 		JsonValue&			operator [](int iIndex);
 
 		JsonValue&			operator =(const JsonValue& oValue);
+#if defined(STTHM_USE_MOVE)
+		// Same as MoveFrom
+		JsonValue&			operator =(JsonValue&& oValue);
+#endif //STTHM_USE_MOVE
 #ifdef JsonStthmString
 		JsonValue&			operator =(const JsonStthmString& sValue);
 #endif //JsonStthmString
@@ -309,23 +409,84 @@ namespace JsonStthm
 		STTHM_CUSTOM_FUNCTIONS
 #endif // STTHM_CUSTOM_FUNCTIONS
 	protected:
+		enum EFlag
+		{
+			E_FLAG_LAZY			= 1 << 0,	// Childs of container are not parsed yet, m_oValue.Lazy hold the container content
+			E_FLAG_INDEXED		= 1 << 1,	// m_oValue.Childs.m_pIndex is used instead of m_oValue.Childs.m_pLast
+		};
+
+		enum EParseFlag
+		{
+			E_PARSE_FLAG_LAZY	= 1 << 0,	// Only record content of containers, childs are parsed on first access
+			E_PARSE_FLAG_INSITU	= 1 << 1,	// Strings are unescaped in the input and point into it, their closing quote is replaced by '\0'
+		};
+
 		void				SetStringValue(const char* pString, const char* pEnd = NULL);
 
+		// Parse childs of lazy container, const because it is called on first access
+		void				LoadLazyChilds() const
+		{
+			if (m_iFlags & E_FLAG_LAZY)
+				ParseLazyChilds();
+		}
+		void				ParseLazyChilds() const;
+
+		void				AppendChild(JsonValue* pChild);
+		// True when this value is one of the childs of oContainer or of their descendants, lazy childs are not parsed
+		bool				IsDescendantOf(const JsonValue& oContainer) const;
+		bool				DetachChild(JsonValue* pChild, JsonValue& oOut);
+		// Childs index is built again by next lookup with non-const operator[]
+		void				DropIndex();
+		// Index is never built by lookups, const access stay read only, iScanned is count of members compared
+		JsonValue*			FindMember(const char* pName, int* pScanned = NULL) const;
+		// Lookup in members hash index, iHash is Internal::HashString(pName)
+		JsonValue*			FindIndexedMember(const char* pName, uint32_t iHash) const;
+		JsonValue*			FindChild(int iIndex) const;
+		// Build index when iCount childs reach threshold, called once childs are read by parsers
+		void				IndexChilds(uint32_t iCount);
+		void				BuildMemberIndex(uint32_t iCount);
+		void				BuildChildTable(uint32_t iCount);
+		static bool			InsertIndexedMember(JsonValue** pSlots, uint32_t iCapacity, JsonValue* pMember);
+
 		Allocator*			m_pAllocator;
 
 		EType				m_eType;
+		uint8_t				m_iFlags;
 		char*				m_pName;
 		JsonValue*			m_pNext;
 
+		// Hash table of object members, created by parsers or BuildIndex when members count reach STTHM_OBJECT_INDEX_THRESHOLD
+		// Table of array childs in order, created by parsers or BuildIndex when childs count reach STTHM_ARRAY_INDEX_THRESHOLD
+		struct ChildIndex
+		{
+			JsonValue*		m_pLast;
+			uint32_t		m_iCount;
+			uint32_t		m_iCapacity;	// Power of 2 for objects
+
+			// m_iCapacity slots are allocated after the header
+			JsonValue**		Slots() { return (JsonValue**)(this + 1); }
+		};
+
 		struct JsonChilds
 		{
 			JsonValue*		m_pFirst;
-			JsonValue*		m_pLast;
+			union
+			{
+				JsonValue*	m_pLast;
+				ChildIndex*	m_pIndex;		// With E_FLAG_INDEXED
+			};
+		};
+
+		struct LazySpan
+		{
+			const char*		m_pBegin;		// After opening brace
+			const char*		m_pEnd;			// After closing brace
 		};
 
 		union ValueUnion
 		{
 			JsonChilds		Childs;
+			LazySpan		Lazy;
 			char*			String;
 			bool			Boolean;
 			int64_t			Integer;
@@ -334,14 +495,25 @@ namespace JsonStthm
 
 		ValueUnion			m_oValue;
 
-		bool				Parse(const char*& pString, const char* pEnd);
+		bool				Parse(const char*& pString, const char* pEnd, int iParseFlags = 0);
 
 		static inline int	ReadSpecialChar(const char*& pString, const char* pEnd, char* pOut);
-		static inline char*	ReadStringValue(const char*& pString, const char* pEnd, Allocator* pAllocator);
+		static inline char*	ReadStringValue(const char*& pString, const char* pEnd, Allocator* pAllocator, bool bInsitu = false);
 		static inline bool	ReadNumericValue(const char*& pString, const char* pEnd, JsonValue& oValue);
-		static inline bool	ReadObjectValue(const char*& pString, const char* pEnd, JsonValue& oValue);
-		static inline bool	ReadArrayValue(const char*& pString, const char* pEnd, JsonValue& oValue);
+		static inline bool	ReadObjectValue(const char*& pString, const char* pEnd, JsonValue& oValue, int iParseFlags);
+		static inline bool	ReadArrayValue(const char*& pString, const char* pEnd, JsonValue& oValue, int iParseFlags);
+		static inline bool	ReadLazyValue(const char*& pString, const char* pEnd, JsonValue& oValue, EType eType);
 		static void			WriteStringEscaped(Internal::CharBuffer& sOutJson, const char* pBuffer);
+		void				WriteValue(Internal::CharBuffer& sOutJson, const Internal::WriteContext& oContext, size_t iDepth) const;
+		// Separator, indentation and name of pChild before its value, this is the parent
+		void				WriteChild(Internal::CharBuffer& sOutJson, const Internal::WriteContext& oContext, const JsonValue* pChild, size_t iDepth, bool bFirst) const;
+		void				WriteSerial(Internal::CharBuffer& sOutJson, const Internal::WriteContext& oContext) const;
+		// Return false when value is not written in parallel, oParts are concatenated in order otherwise
+		bool				WriteParallel(Internal::WriteContext& oContext, Internal::WriteParts& oParts) const;
+		static void			WriteParallelChunks(size_t iWorker, size_t iWorkerCount, void* pUserData);
+		// iLongestString is the length of longest string or name, escaping needs temporary room
+		size_t				EstimateSize(const Internal::WriteContext& oContext, size_t iDepth, size_t& iLongestString) const;
+		bool				ParseMsgPack(const uint8_t*& pData, const uint8_t* pEnd);
 
 		static JsonValue*	DefaultAllocatorCreateJsonValue(Allocator* pAllocator, void* pUserData);
 		static void			DefaultAllocatorDeleteJsonValue(JsonValue* pValue, void* pUserData);
@@ -350,19 +522,151 @@ namespace JsonStthm
 		static Allocator	s_oDefaultAllocator;
 	};
 
+	// Allocator reusing freed JsonValue and strings, for trees built and modified a lot
+	// Memory is taken from pages of fixed size slots, one size class for JsonValue and some for short strings
+	// Should outlive values using it, not thread safe
+	class STTHM_API PoolAllocator
+	{
+	public:
+							PoolAllocator(size_t iPageSize = 16384);
+							~PoolAllocator();
+
+		// Use it with JsonValue(Allocator*)
+		Allocator*			GetAllocator()	{ return &m_oAllocator; }
+
+		// Pages and longer strings
+		size_t				MemoryUsage() const;
+	protected:
+		enum
+		{
+			c_iStringClassCount	= 5,	// 16, 32, 64, 128 and 256 bytes, with size class header
+			c_iClassCount		= c_iStringClassCount + 1,
+			c_iValueClass		= c_iStringClassCount,
+			c_iLargeString		= 0xFF	// Header of strings allocated with JsonStthmMalloc, after their size
+		};
+
+		struct FreeSlot
+		{
+			FreeSlot*		m_pNext;
+		};
+
+		struct Page
+		{
+			Page*			m_pPrevious;
+		};
+
+		struct SizeClass
+		{
+			size_t			m_iSlotSize;
+			FreeSlot*		m_pFreeSlots;
+			char*			m_pCursor;		// Never used slots of last page
+			char*			m_pEnd;
+		};
+
+		Allocator			m_oAllocator;
+		size_t				m_iPageSize;
+		SizeClass			m_pClasses[c_iClassCount];
+		Page*				m_pLastPage;
+		size_t				m_iPageCount;
+		size_t				m_iLargeStringsSize;
+
+		void*				AllocSlot(int iClass);
+		void				ReleaseSlot(int iClass, void* pSlot);
+
+		static JsonValue*	CreateJsonValue(Allocator* pAllocator, void* pUserData);
+		static void			DeleteJsonValue(JsonValue* pValue, void* pUserData);
+		static char*		AllocString(size_t iSize, void* pUserData);
+		static void			FreeString(char* pString, void* pUserData);
+
+	private:
+							PoolAllocator(const PoolAllocator&);
+		PoolAllocator&		operator=(const PoolAllocator&);
+	};
+
+	// Free blocks of JsonDoc, kept to be reused by next parsing instead of being freed
+	// Can be shared by documents with same block size, not thread safe (see GetThreadPool())
+	class STTHM_API BlockPool
+	{
+	public:
+							BlockPool(size_t iBlockSize = 4096, size_t iMaxSize = 16 * 1024 * 1024);
+							~BlockPool();
+
+		// Free all blocks
+		void				Clear();
+
+		size_t				GetBlockSize() const	{ return m_iBlockSize; }
+		// Blocks over this size are freed
+		void				SetMaxSize(size_t iMaxSize);
+		size_t				GetMaxSize() const		{ return m_iMaxSize; }
+		size_t				GetSize() const			{ return m_iBlockCount * m_iBlockSize; }
+
+		// Return NULL when empty
+		void*				Take();
+		// Return false when pool is full, pBlock should be freed by caller
+		bool				Release(void* pBlock);
+
+		// Pool of calling thread with default sizes, freed at thread exit
+		// Documents using it should be cleared on this thread before
+		static BlockPool&	GetThreadPool();
+	protected:
+		struct FreeBlock
+		{
+			FreeBlock*		m_pNext;
+		};
+
+		size_t				m_iBlockSize;
+		size_t				m_iMaxSize;
+		FreeBlock*			m_pFirstBlock;
+		size_t				m_iBlockCount;
+
+	private:
+							BlockPool(const BlockPool&);
+		BlockPool&			operator=(const BlockPool&);
+	};
+
 	// Quicker and use less memory than loading a Json with JsonValue, but read only
 	class STTHM_API JsonDoc
 	{
+		friend class JsonValue;
+		friend class JsonLinesDoc;
 	public:
+		enum EParseMode
+		{
+			E_PARSE_MODE_DEFAULT = 0,			// Recursive parser
+			E_PARSE_MODE_STRUCTURAL_INDEX,		// Index all structural chars with SIMD first, then build the tree from this index
+			E_PARSE_MODE_LAZY,					// Only check strings and matching braces, childs of containers are parsed on first access
+												// With ReadString, input string must be kept valid as long as the document is used
+												// Container with invalid content become null on access, see GetLazyError
+			E_PARSE_MODE_PARALLEL,				// Elements of a root array are parsed on several threads (STTHM_USE_THREADS)
+												// Other documents, or small ones, use the recursive parser
+		};
+
 							JsonDoc(size_t iBlockSize = 4096);
 							~JsonDoc();
 
 		const JsonValue&	GetRoot() { return m_oRoot; }
 
+		// Blocks are kept for next parsing (see SetRetainedSize/SetBlockPool) or freed
 		void				Clear();
 
-		int					ReadString(const char* pJson, const char* pJsonEnd = NULL);
-		int					ReadFile(const char* pFilename);
+		// Clear keep up to iMaxSize bytes of blocks instead of freeing them, 0 by default
+		void				SetRetainedSize(size_t iMaxSize);
+		// Blocks are taken from pPool and released to it instead of being kept by the document, NULL to stop
+		// Pool should have same block size and only be used on one thread
+		void				SetBlockPool(BlockPool* pPool);
+
+		int					ReadString(const char* pJson, const char* pJsonEnd = NULL, EParseMode eMode = E_PARSE_MODE_DEFAULT);
+		// Strings are unescaped in pJson and point into it instead of being copied (except with E_PARSE_MODE_LAZY)
+		// pJson is modified and must be kept valid as long as the document is used
+		int					ReadStringInsitu(char* pJson, char* pJsonEnd = NULL, EParseMode eMode = E_PARSE_MODE_DEFAULT);
+		// File content is kept as long as the document, strings are read in place (except with E_PARSE_MODE_LAZY)
+		int					ReadFile(const char* pFilename, EParseMode eMode = E_PARSE_MODE_DEFAULT);
+		// MessagePack, see JsonValue::ReadMsgPack, root can be written back with GetRoot().WriteMsgPack()
+		int					ReadMsgPack(const void* pData, size_t iSize);
+
+		// Line of first invalid content found while parsing childs of lazy containers, 0 if none
+		// ReadString only reports errors of containers bounds with E_PARSE_MODE_LAZY
+		int					GetLazyError() const;
 
 		size_t				MemoryUsage() const;
 	protected:
@@ -372,19 +676,765 @@ namespace JsonStthm
 		struct Block
 		{
 			size_t			m_iUsed;
+			size_t			m_iSize;		// m_iBlockSize, or more for big allocations
 			Block*			m_pPrevious;
 		};
 
 		size_t				m_iBlockSize;
 		Block*				m_pLastBlock;
+		BlockPool			m_oRetainedBlocks;
+		BlockPool*			m_pBlockPool;	// m_oRetainedBlocks or shared one
+
+		// File content kept while the document is used, for lazy parsing and strings read in place
+		char*				m_pFileContent;
+		size_t				m_iFileSize;
+		bool				m_bFileMapped;
+
+		// Input of E_PARSE_MODE_LAZY and first invalid content found in it
+		const char*			m_pLazyJson;
+		const char*			m_pLazyJsonEnd;
+		const char*			m_pLazyError;
+
+		// Arenas of workers with E_PARSE_MODE_PARALLEL, values they created keep using them
+		// Cleared with the document but kept with their retained blocks
+		Internal::Buffer<JsonDoc*, 16>	m_oWorkerDocs;
+
+		// Range of root array elements parsed by a worker
+		struct ParallelChunk
+		{
+			const char*		m_pBegin;
+			const char*		m_pEnd;			// After a comma, or end of input for last chunk
+			JsonValue*		m_pFirst;
+			JsonValue*		m_pLast;
+			const char*		m_pError;		// Set when parsing failed
+		};
+
+		struct ParallelContext
+		{
+			JsonDoc*		m_pDoc;
+			ParallelChunk*	m_pChunks;
+			size_t			m_iChunkCount;
+			int				m_iParseFlags;
+		};
+
+		int					Parse(const char* pJson, const char* pJsonEnd, EParseMode eMode, int iParseFlags);
+		bool				ParseStructuralIndex(const char* pJson, const char* pEnd, const uint32_t* pIndex, size_t iIndexCount, int iParseFlags, const char*& pError);
+		// Return false when document can't be split, pError is set when parsing failed
+		bool				ParseParallel(const char* pJson, const char* pEnd, int iParseFlags, const char*& pError);
+
+		static void			ParseParallelChunks(size_t iWorker, size_t iWorkerCount, void* pUserData);
 
 		static void*		Allocate(JsonDoc* pDoc, size_t iSize, size_t iAlign);
+		static void			SetLazyError(JsonDoc* pDoc, const char* pError);
 
 		static JsonValue*	CreateJsonValue(Allocator* pAllocator, void* pUserData);
 		static void			DeleteJsonValue(JsonValue* pValue, void* pUserData);
 		static char*		AllocString(size_t iSize, void* pUserData);
 		static void			FreeString(char* pString, void* pUserData);
 	};
+
+	// Read only JSON lines (one root value per line) parsed on several threads
+	// Input is split in chunks at line ends, each chunk is parsed by a worker in its own arena (JsonDoc)
+	// Values can't span several lines nor share one, chunks are parsed one after the other without STTHM_USE_THREADS
+	class STTHM_API JsonLinesDoc
+	{
+	public:
+		// iThreadCount 0 use all hardware threads
+							JsonLinesDoc(int iThreadCount = 0, size_t iBlockSize = 65536);
+							~JsonLinesDoc();
+
+		void				Clear();
+
+		// Return 0 on success, or line of first error
+		int					ReadString(const char* pJson, const char* pJsonEnd = NULL);
+		// File content is kept as long as the document, strings are read in place
+		int					ReadFile(const char* pFilename);
+
+		// Root values in input order, empty lines are skipped
+		size_t				GetCount() const	{ return m_iCount; }
+		const JsonValue&	GetValue(size_t iIndex) const;
+		const JsonValue&	operator[](size_t iIndex) const	{ return GetValue(iIndex); }
+
+		size_t				MemoryUsage() const;
+	protected:
+		struct Chunk
+		{
+							Chunk(size_t iBlockSize) : m_oDoc(iBlockSize), m_pError(NULL), m_iFirst(0) {}
+
+			JsonDoc			m_oDoc;
+			Internal::Buffer<JsonValue*, 16>	m_oValues;
+			const char*		m_pBegin;
+			const char*		m_pEnd;
+			const char*		m_pError;	// Set when parsing failed
+			size_t			m_iFirst;	// Index of first value in document
+		};
+
+		int					m_iThreadCount;
+		size_t				m_iBlockSize;
+		Internal::Buffer<Chunk*, 64>	m_oChunks;
+		size_t				m_iCount;
+		int					m_iParseFlags;	// Of current parsing
+
+		char*				m_pFileContent;
+		size_t				m_iFileSize;
+		bool				m_bFileMapped;
+
+		int					Parse(const char* pJson, const char* pJsonEnd, int iParseFlags);
+
+		static void			ParseChunks(size_t iWorker, size_t iWorkerCount, void* pUserData);
+		static void			ParseChunk(Chunk* pChunk, int iParseFlags);
+
+	private:
+							JsonLinesDoc(const JsonLinesDoc&);
+		JsonLinesDoc&		operator=(const JsonLinesDoc&);
+	};
+
+	class CompactValue;
+
+	// Read only document using 16 bytes nodes stored in pre-order in a single buffer (tape), strings are in a second buffer
+	// Nodes use 32 bits offsets, about 3 times less memory than JsonDoc
+	// Tape can be saved to a file and loaded later without parsing
+	class STTHM_API CompactDoc
+	{
+		friend class CompactValue;
+	public:
+							CompactDoc();
+							~CompactDoc();
+
+		CompactValue		GetRoot() const;
+
+		void				Clear();
+
+		int					ReadString(const char* pJson, const char* pJsonEnd = NULL);
+		int					ReadFile(const char* pFilename);
+
+		// Tape file is only valid on platforms with same endianness
+		bool				WriteTape(const char* pFilename) const;
+		// File is mapped in memory (or loaded) as long as the document, return -3 when file is not a valid tape
+		int					ReadTape(const char* pFilename);
+
+		size_t				MemoryUsage() const;
+	protected:
+		enum ENodeHeader
+		{
+			E_NODE_TYPE_MASK	= 0x7,		// JsonValue::EType
+			E_NODE_LAST			= 1 << 3,	// Last child of its container, or root
+		};
+
+		struct Node
+		{
+			uint32_t		m_iHeader;
+			uint32_t		m_iName;		// Offset in strings, c_iNoName for root and array elements
+			union
+			{
+				struct
+				{
+					uint32_t	m_iEnd;		// Index of node after last descendant
+					uint32_t	m_iCount;
+				} Container;
+				struct
+				{
+					uint32_t	m_iOffset;	// Offset in strings
+					uint32_t	m_iLength;
+				} String;
+				bool		Boolean;
+				int64_t		Integer;
+				double		Float;
+			} m_oValue;
+		};
+
+		struct TapeHeader
+		{
+			char			m_pMagic[4];	// c_pTapeMagic
+			uint32_t		m_iVersion;		// c_iTapeVersion, also check endianness
+			uint32_t		m_iNodeCount;
+			uint32_t		m_iStringsSize;
+		};
+
+		static const uint32_t c_iNoName = 0xFFFFFFFF;
+		static const char* const c_pTapeMagic;
+		static const uint32_t c_iTapeVersion = 1;
+
+		// Filled by ReadString
+		Internal::Buffer<Node, 16>	m_oNodes;
+		Internal::Buffer<char, 16>	m_oStrings;
+		Allocator			m_oStringAllocator;
+
+		// Content of m_oNodes/m_oStrings, or of tape file
+		const Node*			m_pNodes;
+		size_t				m_iNodeCount;
+		const char*			m_pStrings;
+		size_t				m_iStringsSize;
+
+		char*				m_pTape;
+		size_t				m_iTapeSize;
+		bool				m_bTapeMapped;
+
+		bool				ParseValue(const char*& pString, const char* pEnd, uint32_t iName);
+		bool				ReadStringValue(const char*& pString, const char* pEnd, uint32_t& iOffset, uint32_t& iLength);
+		const Node*			GetNextSibling(const Node* pNode) const;
+
+		static char*		AllocString(size_t iSize, void* pUserData);
+
+	private:
+							CompactDoc(const CompactDoc&);
+		CompactDoc&			operator=(const CompactDoc&);
+	};
+
+	// View on a node of CompactDoc, valid as long as the document is not cleared
+	class STTHM_API CompactValue
+	{
+		friend class CompactDoc;
+	public:
+		class STTHM_API Iterator
+		{
+			friend class CompactValue;
+		public:
+			bool			IsValid() const;
+			bool			operator!=(const Iterator& oIte) const;
+			void			operator++();
+			CompactValue	operator*() const;
+		protected:
+							Iterator(const CompactDoc* pDoc, const CompactDoc::Node* pNode);
+
+			const CompactDoc*		m_pDoc;
+			const CompactDoc::Node*	m_pNode;
+		};
+
+							CompactValue();
+
+		JsonValue::EType	GetType() const;
+
+		int					GetMemberCount() const;
+
+		const char*			GetName() const;
+		CompactValue		GetNext() const;
+
+		bool				IsValid() const		{ return m_pNode != NULL; }
+		bool				IsNull() const		{ return GetType() == JsonValue::E_TYPE_NULL; }
+		bool				IsObject() const	{ return GetType() == JsonValue::E_TYPE_OBJECT; }
+		bool				IsArray() const		{ return GetType() == JsonValue::E_TYPE_ARRAY; }
+		bool				IsString() const	{ return GetType() == JsonValue::E_TYPE_STRING; }
+		bool				IsBoolean() const	{ return GetType() == JsonValue::E_TYPE_BOOLEAN; }
+		bool				IsInteger() const	{ return GetType() == JsonValue::E_TYPE_INTEGER; }
+		bool				IsFloat() const		{ return GetType() == JsonValue::E_TYPE_FLOAT; }
+
+		bool				IsNumeric() const	{ return IsInteger() || IsFloat(); }
+		bool				IsContainer() const	{ return IsObject() || IsArray(); }
+
+		const char*			ToString() const;
+		size_t				GetStringLength() const;
+		bool				ToBoolean() const;
+		int64_t				ToInteger() const;
+		double				ToFloat() const;
+
+		// Copy value and its childs
+		void				ToJsonValue(JsonValue& oValue) const;
+
+		CompactValue		operator [](const char* pName) const;
+		CompactValue		operator [](int iIndex) const;
+
+		Iterator			begin() const;
+		Iterator			end() const;
+	protected:
+							CompactValue(const CompactDoc* pDoc, const CompactDoc::Node* pNode);
+
+		const CompactDoc*		m_pDoc;
+		const CompactDoc::Node*	m_pNode;
+	};
+
+	// Pull parser, read values one event at time without building them
+	// Input is read by chunks, memory usage only depends on chunk size, depth and longest string/number
+	// Several root values can follow each other (JSON lines)
+	class STTHM_API Reader
+	{
+	public:
+		enum EEvent
+		{
+			E_EVENT_NONE = 0,		// Next() not called yet
+			E_EVENT_START_OBJECT,
+			E_EVENT_END_OBJECT,
+			E_EVENT_START_ARRAY,
+			E_EVENT_END_ARRAY,
+			E_EVENT_KEY,			// GetString()
+			E_EVENT_STRING,			// GetString()
+			E_EVENT_INTEGER,		// GetInteger()
+			E_EVENT_FLOAT,			// GetFloat()
+			E_EVENT_BOOLEAN,		// GetBoolean()
+			E_EVENT_NULL,
+			E_EVENT_END,			// End of input
+			E_EVENT_ERROR,			// Invalid input, GetOffset() give error position
+			E_EVENT_NEED_INPUT		// Fed input ends before next event, call Feed() or EndFeed() then Next() again
+		};
+
+		// Fill pBuffer with up to iSize bytes, return 0 at end of input
+		typedef size_t		(*ReadCallback)(char* pBuffer, size_t iSize, void* pUserData);
+
+							Reader();
+							~Reader();
+
+		// pJson should be kept valid while reading
+		void				SetInput(const char* pJson, const char* pJsonEnd = NULL);
+		void				SetInput(ReadCallback pCallback, void* pUserData, size_t iChunkSize = 65536);
+		bool				OpenFile(const char* pFilename, size_t iChunkSize = 65536);
+		// Input is pushed with Feed() as it arrives, chunks can be split at any byte
+		// Incomplete tokens are kept and read again once completed, skipped containers are dropped as they are fed
+		// ReadValue() and ReadBinding() should only be called once the whole value is fed
+		void				SetFeedInput();
+		// pData is copied
+		void				Feed(const char* pData, size_t iSize);
+		// No more input, Next() then return E_EVENT_END or E_EVENT_ERROR instead of E_EVENT_NEED_INPUT
+		void				EndFeed();
+		void				Close();
+
+		EEvent				Next();
+		// Skip next value, containers are skipped without reading their content
+		// Return the event of the skipped value (E_EVENT_START_OBJECT for a whole object)
+		// With fed input, E_EVENT_NEED_INPUT within a container (GetDepth() increased) means next Next() finish to skip it
+		// and return the same start event, SkipValue() should be called again otherwise
+		// GetEvent() give end event of a skipped container, resumed or not
+		EEvent				SkipValue();
+		// Skip remaining content of current container, current event become its end event
+		// With fed input, false and E_EVENT_NEED_INPUT when it is not fed yet, next Next() resume skip and return end event
+		bool				SkipContainer();
+		// Read next value in oValue, should not be called where a key is expected
+		// Return false on error or when current container end instead (GetEvent() give which one)
+		bool				ReadValue(JsonValue& oValue);
+
+		EEvent				GetEvent() const	{ return m_eEvent; }
+		int					GetDepth() const	{ return (int)m_oStack.Size(); }
+		size_t				GetOffset() const	{ return m_iBaseOffset + (m_pCursor - m_pBase); }
+
+		// Valid until next call to Next()
+		const char*			GetString() const	{ return m_oString.Data(); }
+		size_t				GetStringLength() const	{ return m_iStringLength; }
+		int64_t				GetInteger() const	{ return m_oScalar.m_oValue.Integer; }
+		double				GetFloat() const	{ return m_oScalar.m_oValue.Float; }
+		bool				GetBoolean() const	{ return m_oScalar.m_oValue.Boolean; }
+	protected:
+		enum EState
+		{
+			E_STATE_ROOT,			// Root value or end of input
+			E_STATE_VALUE,			// After ':' or ',' in array
+			E_STATE_FIRST_MEMBER,	// After '{'
+			E_STATE_MEMBER,			// After ',' in object
+			E_STATE_COLON,			// After key
+			E_STATE_FIRST_ELEMENT,	// After '['
+			E_STATE_SEPARATOR		// After value in container
+		};
+
+		const char*			m_pBase;		// Start of m_oBuffer or of input string
+		const char*			m_pCursor;
+		const char*			m_pEnd;
+		size_t				m_iBaseOffset;	// Input offset of m_pBase
+
+		ReadCallback		m_pReadCallback;
+		void*				m_pReadUserData;
+		size_t				m_iChunkSize;
+		bool				m_bEndOfInput;
+		void*				m_pFile;		// FILE* opened by OpenFile
+		bool				m_bFeed;		// Input given by Feed()
+		bool				m_bNeedInput;	// Fed input exhausted during current call
+		size_t				m_iResumeScan;	// Bytes of pending string already scanned
+		int					m_iSkipDepth;	// Containers left to close in pending SkipContainer()
+		bool				m_bSkipInString;
+		EEvent				m_eSkipValueEvent;	// Start event returned when a skip of SkipValue() is resumed, E_EVENT_NONE for SkipContainer()
+
+		EEvent				m_eEvent;
+		EState				m_eState;
+		Internal::Buffer<char, 64>	m_oStack;	// '{' or '[' of opened containers
+		Internal::CharBuffer	m_oBuffer;
+		Internal::CharBuffer	m_oString;
+		size_t				m_iStringLength;
+		JsonValue			m_oScalar;
+		Allocator			m_oStringAllocator;
+
+		void				Reset();
+		EEvent				ReadNext();
+		bool				Refill();
+		bool				SkipSpaces();
+		bool				EnsureAvailable(size_t iCount);
+		bool				ReadString();
+		// After opening quote
+		bool				SkipStringBody();
+		EEvent				ReadValueEvent(char cChar);
+		EEvent				ReadContainerEnd(char cChar);
+		EEvent				SetError();
+
+		static size_t		ReadFileCallback(char* pBuffer, size_t iSize, void* pUserData);
+		static char*		AllocString(size_t iSize, void* pUserData);
+		static void			FreeString(char* pString, void* pUserData);
+
+	private:
+							Reader(const Reader&);
+		Reader&				operator=(const Reader&);
+	};
+
+	// Write values one at time without building them, output is the same as JsonValue::Write
+	// Output is staged in a buffer flushed every iFlushSize bytes, memory usage doesn't depend on output size
+	// Several root values are separated by a new line (JSON lines)
+	class STTHM_API Writer
+	{
+	public:
+		// Write iSize bytes of pData, return false on failure
+		typedef bool		(*WriteCallback)(const char* pData, size_t iSize, void* pUserData);
+
+							Writer(bool bCompact = false, size_t iFlushSize = 65536);
+							~Writer();
+
+		bool				OpenFile(const char* pFilename);
+		void				SetOutput(WriteCallback pCallback, void* pUserData);
+		// Fixed size memory, writing fail once full
+		void				SetOutput(char* pBuffer, size_t iSize);
+		// Flush and close file, return false if something failed
+		bool				Close();
+		bool				Flush();
+
+		void				BeginObject();
+		void				EndObject();
+		void				BeginArray();
+		void				EndArray();
+		void				Key(const char* pName);
+
+		void				Value(const char* pValue);
+		void				Value(bool bValue);
+		void				Value(int iValue)	{ Value((int64_t)iValue); }
+		void				Value(int64_t iValue);
+		void				Value(double fValue);
+		void				Value(const JsonValue& oValue);
+		void				Null();
+
+		bool				IsValid() const		{ return m_bFailed == false; }
+		int					GetDepth() const	{ return (int)m_oStack.Size(); }
+		// Bytes sent to output, without staged ones
+		size_t				GetWrittenSize() const { return m_iWrittenSize; }
+	protected:
+		bool				m_bCompact;
+		size_t				m_iFlushSize;
+		Internal::CharBuffer	m_oBuffer;
+		Internal::Buffer<char, 64>	m_oStack;	// '{' or '[' of opened containers
+		bool				m_bFirst;		// No value written in current container yet
+		bool				m_bAfterKey;
+		bool				m_bFailed;
+		size_t				m_iWrittenSize;
+
+		WriteCallback		m_pWriteCallback;
+		void*				m_pWriteUserData;
+		void*				m_pFile;		// FILE* opened by OpenFile
+		char*				m_pOutput;		// Fixed size output
+		size_t				m_iOutputSize;
+
+		void				BeginValue();
+		void				EndValue();
+
+		static bool			WriteFileCallback(const char* pData, size_t iSize, void* pUserData);
+		static bool			WriteMemoryCallback(const char* pData, size_t iSize, void* pUserData);
+
+	private:
+							Writer(const Writer&);
+		Writer&				operator=(const Writer&);
+	};
+
+	// Path compiled once then evaluated on any number of trees (JsonDoc::GetRoot() for documents)
+	// JSON Pointer (RFC 6901) : "", "/a/b/3/c", "/a~1b" ('~1' is '/' and '~0' is '~')
+	// Path expression : "$.a.b[3].c", "$['a b']", "$.a[*].c", "$.a.*", "$.a[-1]", "$.a[1:10:2]" (slice bounds can be negative or omitted)
+	class STTHM_API JsonPath
+	{
+	public:
+		// Return false to stop
+		typedef bool		(*MatchCallback)(const JsonValue& oValue, void* pUserData);
+
+							JsonPath();
+							JsonPath(const char* pPath);
+							~JsonPath();
+
+		// Return false on syntax error, path then matches nothing
+		bool				Compile(const char* pPath);
+		bool				IsValid() const { return m_bValid; }
+		// Without wildcard nor slice, match at most one value
+		bool				IsSingle() const { return m_bSingle; }
+		size_t				GetSegmentCount() const { return m_iSegmentCount; }
+
+		// First matching value in document order, JsonValue::INVALID if none
+		const JsonValue&	Get(const JsonValue& oRoot) const;
+		JsonValue&			Get(JsonValue& oRoot) const;
+		// Call pCallback for each matching value in document order, return match count
+		size_t				Select(const JsonValue& oRoot, MatchCallback pCallback = NULL, void* pUserData = NULL) const;
+
+		// Evaluate iPathCount paths, pOutValues[i] is the first match of pPaths[i] or NULL
+		// Segments in common with previous path are not looked up again, sort paths by prefix to share most lookups
+		static void			GetAll(const JsonValue& oRoot, const JsonPath* pPaths, size_t iPathCount, const JsonValue** pOutValues);
+	protected:
+		enum ESegmentType
+		{
+			E_SEGMENT_MEMBER,		// Pointer tokens like "3" are also array indexes
+			E_SEGMENT_INDEX,
+			E_SEGMENT_WILDCARD,
+			E_SEGMENT_SLICE
+		};
+
+		enum ESliceFlag
+		{
+			E_SLICE_START	= 1,
+			E_SLICE_END		= 2
+		};
+
+		struct Segment
+		{
+			ESegmentType	m_eType;
+			uint32_t		m_iName;		// Offset in names
+			uint32_t		m_iHash;
+			int				m_iIndex;		// Array index (-1 for none with members) or slice start, negative from end
+			int				m_iEnd;			// Slice end
+			int				m_iStep;
+			int				m_iSliceFlags;
+		};
+
+		typedef Internal::Buffer<Segment, 16>	SegmentBuffer;
+		typedef Internal::Buffer<char, 256>		NameBuffer;
+
+		// Segments followed by their names in one allocation
+		Segment*			m_pSegments;
+		size_t				m_iSegmentCount;
+		bool				m_bValid;
+		bool				m_bSingle;
+
+		void				Clear();
+		static bool			CompilePointer(const char* pPath, SegmentBuffer& oSegments, NameBuffer& oNames);
+		static bool			CompileExpression(const char* pPath, SegmentBuffer& oSegments, NameBuffer& oNames);
+		static void			PushSegment(SegmentBuffer& oSegments, ESegmentType eType, int iIndex = -1, int iEnd = 0, int iStep = 1, int iSliceFlags = 0);
+		// Name starts at iName in oNames
+		static void			PushMember(SegmentBuffer& oSegments, NameBuffer& oNames, size_t iName, bool bPointerToken);
+
+		const char*			GetName(const Segment& oSegment) const { return (const char*)(m_pSegments + m_iSegmentCount) + oSegment.m_iName; }
+		const JsonValue*	FindChild(const JsonValue& oNode, const Segment& oSegment) const;
+		// Follow segments from iSegment, path must be single
+		const JsonValue*	FindSingle(const JsonValue& oNode, size_t iSegment) const;
+		bool				MatchChild(const JsonValue& oParent, const JsonValue& oChild, int iPosition, int iCount, const Segment& oSegment) const;
+		// Segment has negative index or slice bounds, relative to childs count
+		static bool			NeedCount(const Segment& oSegment);
+		static void			GetSliceBounds(const Segment& oSegment, int iCount, int& iStart, int& iEnd);
+		static bool			ParseIndex(const char*& pString, int& iIndex);
+		bool				SelectRecursive(const JsonValue& oNode, size_t iSegment, MatchCallback pCallback, void* pUserData, size_t& iMatchCount) const;
+		bool				IsSameSegment(const JsonPath& oOther, size_t iSegment) const;
+
+		static bool			GetFirstCallback(const JsonValue& oValue, void* pUserData);
+
+	private:
+							JsonPath(const JsonPath&);
+		JsonPath&			operator=(const JsonPath&);
+	};
+
+	// Typed binding, JSON is read straight into C++ values with a Reader, without building a JsonValue tree
+	// Binding<T> should define Read(oReader, eEvent, oOut), eEvent being the first event of the value, and Write(oWriter, oValue)
+	// Structs are bound with STTHM_BINDING_BEGIN/STTHM_BINDING_MEMBER/STTHM_BINDING_END, specialize Binding for other types
+	template <typename T>
+	struct Binding;
+
+	namespace Internal
+	{
+		struct BindingAnyStruct {};
+	}
+
+	struct BindingMember
+	{
+		// Pointer to member of the bound struct, cast back to its type by Read and Write
+		typedef char Internal::BindingAnyStruct::*	MemberPointer;
+
+		const char*			pName;
+		MemberPointer		pMember;
+		bool				(*Read)(Reader& oReader, Reader::EEvent eEvent, void* pStruct, MemberPointer pMember);
+		void				(*Write)(Writer& oWriter, const void* pStruct, MemberPointer pMember);
+	};
+
+	namespace Internal
+	{
+		template <typename S, typename T>
+		bool ReadBindingMember(Reader& oReader, Reader::EEvent eEvent, void* pStruct, BindingMember::MemberPointer pMember)
+		{
+			return Binding<T>::Read(oReader, eEvent, ((S*)pStruct)->*reinterpret_cast<T S::*>(pMember));
+		}
+
+		template <typename S, typename T>
+		void WriteBindingMember(Writer& oWriter, const void* pStruct, BindingMember::MemberPointer pMember)
+		{
+			Binding<T>::Write(oWriter, ((const S*)pStruct)->*reinterpret_cast<T S::*>(pMember));
+		}
+
+		// S is the bound struct, pMember can be declared in one of its bases
+		template <typename S, typename T, typename B>
+		BindingMember MakeBindingMember(const char* pName, T B::* pMember)
+		{
+			T S::* pStructMember = pMember;
+			BindingMember oMember = { pName, reinterpret_cast<BindingMember::MemberPointer>(pStructMember), &ReadBindingMember<S, T>, &WriteBindingMember<S, T> };
+			return oMember;
+		}
+
+		// Unknown members are skipped, missing ones and null values keep their current value
+		bool ReadBindingStruct(Reader& oReader, Reader::EEvent eEvent, void* pOut, const BindingMember* pMembers, size_t iMemberCount);
+		void WriteBindingStruct(Writer& oWriter, const void* pValue, const BindingMember* pMembers, size_t iMemberCount);
+		// Skip rest of a value when eEvent is the start of a container, its content is checked as any read value
+		bool SkipBindingValue(Reader& oReader, Reader::EEvent eEvent);
+
+		template <typename T>
+		struct BindingInteger
+		{
+			static bool Read(Reader& oReader, Reader::EEvent eEvent, T& oOut)
+			{
+				if (eEvent != Reader::E_EVENT_INTEGER)
+					return false;
+				const int64_t iValue = oReader.GetInteger();
+				if ((int64_t)(T)iValue != iValue)
+					return false;
+				oOut = (T)iValue;
+				return true;
+			}
+			static void Write(Writer& oWriter, const T& oValue) { oWriter.Value((int64_t)oValue); }
+		};
+
+		template <typename T>
+		struct BindingFloat
+		{
+			static bool Read(Reader& oReader, Reader::EEvent eEvent, T& oOut)
+			{
+				if (eEvent == Reader::E_EVENT_FLOAT)
+					oOut = (T)oReader.GetFloat();
+				else if (eEvent == Reader::E_EVENT_INTEGER)
+					oOut = (T)oReader.GetInteger();
+				else
+					return false;
+				return true;
+			}
+			static void Write(Writer& oWriter, const T& oValue) { oWriter.Value((double)oValue); }
+		};
+	}
+
+	template <> struct Binding<int> : Internal::BindingInteger<int> {};
+	template <> struct Binding<unsigned int> : Internal::BindingInteger<unsigned int> {};
+	template <> struct Binding<int64_t> : Internal::BindingInteger<int64_t> {};
+	template <> struct Binding<float> : Internal::BindingFloat<float> {};
+	template <> struct Binding<double> : Internal::BindingFloat<double> {};
+
+	template <>
+	struct Binding<bool>
+	{
+		static bool Read(Reader& oReader, Reader::EEvent eEvent, bool& bOut)
+		{
+			if (eEvent != Reader::E_EVENT_BOOLEAN)
+				return false;
+			bOut = oReader.GetBoolean();
+			return true;
+		}
+		static void Write(Writer& oWriter, const bool& bValue) { oWriter.Value(bValue); }
+	};
+
+#ifdef JsonStthmString
+	// Capacity of sOut is reused
+	template <>
+	struct Binding<JsonStthmString>
+	{
+		static bool Read(Reader& oReader, Reader::EEvent eEvent, JsonStthmString& sOut)
+		{
+			if (eEvent != Reader::E_EVENT_STRING)
+				return false;
+			sOut.assign(oReader.GetString(), oReader.GetStringLength());
+			return true;
+		}
+		static void Write(Writer& oWriter, const JsonStthmString& sValue) { oWriter.Value(sValue.c_str()); }
+	};
+#endif //JsonStthmString
+
+	// Fixed size arrays, extra elements are skipped and missing ones keep their value
+	template <typename T, size_t Size>
+	struct Binding<T[Size]>
+	{
+		static bool Read(Reader& oReader, Reader::EEvent eEvent, T (&pOut)[Size])
+		{
+			if (eEvent != Reader::E_EVENT_START_ARRAY)
+				return false;
+			for (size_t iIndex = 0; ; ++iIndex)
+			{
+				eEvent = oReader.Next();
+				if (eEvent == Reader::E_EVENT_END_ARRAY)
+					return true;
+				if (iIndex >= Size || eEvent == Reader::E_EVENT_NULL)
+				{
+					if (Internal::SkipBindingValue(oReader, eEvent) == false)
+						return false;
+				}
+				else if (Binding<T>::Read(oReader, eEvent, pOut[iIndex]) == false)
+				{
+					return false;
+				}
+			}
+		}
+		static void Write(Writer& oWriter, const T (&pValue)[Size])
+		{
+			oWriter.BeginArray();
+			for (size_t iIndex = 0; iIndex < Size; ++iIndex)
+				Binding<T>::Write(oWriter, pValue[iIndex]);
+			oWriter.EndArray();
+		}
+	};
+
+	// Read next value of oReader in oOut, return false on invalid JSON or type mismatch (GetOffset() is after the faulty value)
+	template <typename T>
+	bool ReadBinding(Reader& oReader, T& oOut)
+	{
+		return Binding<T>::Read(oReader, oReader.Next(), oOut);
+	}
+
+	template <typename T>
+	bool ReadBinding(const char* pJson, const char* pJsonEnd, T& oOut)
+	{
+		Reader oReader;
+		oReader.SetInput(pJson, pJsonEnd);
+		return ReadBinding(oReader, oOut) && oReader.Next() == Reader::E_EVENT_END;
+	}
+
+	template <typename T>
+	void WriteBinding(Writer& oWriter, const T& oValue)
+	{
+		Binding<T>::Write(oWriter, oValue);
+	}
 }
 
+// Bind members of a struct, at global scope after its declaration :
+// STTHM_BINDING_BEGIN(MyConfig)
+//	STTHM_BINDING_MEMBER("port", iPort)
+//	STTHM_BINDING_MEMBER("servers", oServers)	// Any bound type
+// STTHM_BINDING_END()
+#define STTHM_BINDING_BEGIN(Type) \
+	namespace JsonStthm { \
+	template <> \
+	struct Binding<Type> \
+	{ \
+		typedef Type BoundType; \
+		static const BindingMember* GetMembers(size_t& iCount) \
+		{ \
+			static const BindingMember s_pMembers[] = {
+
+#define STTHM_BINDING_MEMBER(Name, Member) \
+				Internal::MakeBindingMember<BoundType>(Name, &BoundType::Member),
+
+#define STTHM_BINDING_END() \
+			}; \
+			iCount = sizeof(s_pMembers) / sizeof(s_pMembers[0]); \
+			return s_pMembers; \
+		} \
+		static bool Read(Reader& oReader, Reader::EEvent eEvent, BoundType& oOut) \
+		{ \
+			size_t iCount; \
+			const BindingMember* pMembers = GetMembers(iCount); \
+			return Internal::ReadBindingStruct(oReader, eEvent, &oOut, pMembers, iCount); \
+		} \
+		static void Write(Writer& oWriter, const BoundType& oValue) \
+		{ \
+			size_t iCount; \
+			const BindingMember* pMembers = GetMembers(iCount); \
+			Internal::WriteBindingStruct(oWriter, &oValue, pMembers, iCount); \
+		} \
+	}; \
+	}
+
 #endif // __JSON_STTHM_H__
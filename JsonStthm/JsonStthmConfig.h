@@ -25,6 +25,68 @@
 
 //#define STTHM_ENABLE_IMPLICIT_CAST
 
+/*
+* Objects with at least this members count get a hash index when parsed or on a lookup with non-const operator[]
+* Set to 0 to disable
+*/
+#ifndef STTHM_OBJECT_INDEX_THRESHOLD
+#define STTHM_OBJECT_INDEX_THRESHOLD 16
+#endif
+
+/*
+* Arrays with at least this childs count get a table of childs when parsed or on an access with non-const operator[]
+* Set to 0 to disable
+*/
+#ifndef STTHM_ARRAY_INDEX_THRESHOLD
+#define STTHM_ARRAY_INDEX_THRESHOLD 16
+#endif
+
+/*
+* SIMD instructions used by the parser to skip spaces, string bodies and digits
+* Selected from compiler flags, define STTHM_DISABLE_SIMD to only use scalar code
+*/
+//#define STTHM_DISABLE_SIMD
+
+#ifndef STTHM_DISABLE_SIMD
+#	if defined(__AVX2__)
+#		define STTHM_USE_AVX2
+#	endif
+#	if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define STTHM_USE_SSE2
+#	endif
+#endif //STTHM_DISABLE_SIMD
+
+/*
+* ReadFile maps files in memory (mmap, POSIX only) instead of reading them in a buffer
+* Define STTHM_DISABLE_MMAP to always use fread
+*/
+//#define STTHM_DISABLE_MMAP
+
+#ifndef STTHM_DISABLE_MMAP
+#	if defined(__unix__) || defined(__APPLE__)
+#		define STTHM_USE_MMAP
+#	endif
+#endif //STTHM_DISABLE_MMAP
+
+/*
+* JsonLinesDoc parse chunks of its input on several threads (std::thread, C++11)
+* Define STTHM_DISABLE_THREADS to parse them one after the other on calling thread
+*/
+//#define STTHM_DISABLE_THREADS
+
+#ifndef STTHM_DISABLE_THREADS
+#	if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#		define STTHM_USE_THREADS
+#	endif
+#endif //STTHM_DISABLE_THREADS
+
+/*
+* Move constructor and assignment of JsonValue, with C++11 compilers
+*/
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#	define STTHM_USE_MOVE
+#endif
+
 /*
 * Allow to define custom functions to JsonValue
 * Usefull to declare implicit cast operator
@@ -0,0 +1,1465 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCHMARKER_USE_MACROS
+#include "../Benchmarker/Benchmarker.h"
+
+#include "JsonStthm.h"
+
+#if defined(STTHM_USE_AVX2)
+static const char* const c_pSimdName = "AVX2";
+#elif defined(STTHM_USE_SSE2)
+static const char* const c_pSimdName = "SSE2";
+#else
+static const char* const c_pSimdName = "Scalar";
+#endif
+
+const char* const c_pWords[] = {
+	"Lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit",
+	"Curabitur", "mattis", "magna", "id", "mauris", "fermentum", "vehicula", "Duis"
+};
+
+// Pretty printed document looking like a telemetry dump
+void GenerateDocument(JsonStthm::JsonValue& oRoot, int iHostCount)
+{
+	const int iWordCount = sizeof(c_pWords) / sizeof(c_pWords[0]);
+	char pName[64];
+	for (int iHost = 0; iHost < iHostCount; ++iHost)
+	{
+		snprintf(pName, 64, "host-%d", iHost);
+		JsonStthm::JsonValue& oHost = oRoot[pName];
+		oHost["name"] = pName;
+		oHost["description"] = c_pWords[iHost % iWordCount];
+		oHost["enabled"] = (iHost % 3) != 0;
+		oHost["uptime"] = (int64_t)iHost * 123456789;
+		oHost["load"] = (iHost + 0.5) / 7.0;
+
+		JsonStthm::JsonValue& oSamples = oHost["samples"];
+		for (int iSample = 0; iSample < 16; ++iSample)
+		{
+			JsonStthm::JsonValue& oSample = oSamples.Append();
+			oSample["timestamp"] = (int64_t)1500000000 + iSample;
+			oSample["value"] = (iHost * iSample + 0.5) / 3.0;
+			oSample["tag"] = c_pWords[(iHost + iSample) % iWordCount];
+		}
+	}
+}
+
+// Same layout as hosts of GenerateDocument
+struct HostSample
+{
+	int64_t				iTimestamp;
+	double				fValue;
+	JsonStthmString		sTag;
+};
+
+struct Host
+{
+	JsonStthmString		sName;
+	JsonStthmString		sDescription;
+	bool				bEnabled;
+	int64_t				iUptime;
+	double				fLoad;
+	HostSample			pSamples[16];
+};
+
+STTHM_BINDING_BEGIN(HostSample)
+	STTHM_BINDING_MEMBER("timestamp", iTimestamp)
+	STTHM_BINDING_MEMBER("value", fValue)
+	STTHM_BINDING_MEMBER("tag", sTag)
+STTHM_BINDING_END()
+
+STTHM_BINDING_BEGIN(Host)
+	STTHM_BINDING_MEMBER("name", sName)
+	STTHM_BINDING_MEMBER("description", sDescription)
+	STTHM_BINDING_MEMBER("enabled", bEnabled)
+	STTHM_BINDING_MEMBER("uptime", iUptime)
+	STTHM_BINDING_MEMBER("load", fLoad)
+	STTHM_BINDING_MEMBER("samples", pSamples)
+STTHM_BINDING_END()
+
+// Member declared in a base, in a struct which is not standard layout
+struct NamedBase
+{
+	JsonStthmString		sName;
+};
+
+struct NamedCounter : NamedBase
+{
+	virtual ~NamedCounter() {}
+	int					iCount;
+};
+
+STTHM_BINDING_BEGIN(NamedCounter)
+	STTHM_BINDING_MEMBER("name", sName)
+	STTHM_BINDING_MEMBER("count", iCount)
+STTHM_BINDING_END()
+
+// What binding replaces
+void CopyHost(const JsonStthm::JsonValue& oHost, Host& oOut)
+{
+	oOut.sName = oHost["name"].ToString();
+	oOut.sDescription = oHost["description"].ToString();
+	oOut.bEnabled = oHost["enabled"].ToBoolean();
+	oOut.iUptime = oHost["uptime"].ToInteger();
+	oOut.fLoad = oHost["load"].ToFloat();
+	const JsonStthm::JsonValue& oSamples = oHost["samples"];
+	int iSample = 0;
+	for (JsonStthm::JsonValue::Iterator it = oSamples.begin(); it != oSamples.end() && iSample < 16; ++it, ++iSample)
+	{
+		oOut.pSamples[iSample].iTimestamp = (*it)["timestamp"].ToInteger();
+		oOut.pSamples[iSample].fValue = (*it)["value"].ToFloat();
+		oOut.pSamples[iSample].sTag = (*it)["tag"].ToString();
+	}
+}
+
+bool CountBytes(const char* /*pData*/, size_t iSize, void* pUserData)
+{
+	*(size_t*)pUserData += iSize;
+	return true;
+}
+
+// Events of sJson fed by chunks of iChunkSize bytes should be the same as when reading it at once
+bool CheckFedEvents(const JsonStthmString& sJson, size_t iChunkSize)
+{
+	JsonStthm::Reader oWhole, oFed;
+	oWhole.SetInput(sJson.c_str(), sJson.c_str() + sJson.size());
+	oFed.SetFeedInput();
+	size_t iFed = 0;
+	while (true)
+	{
+		const JsonStthm::Reader::EEvent eEvent = oFed.Next();
+		if (eEvent == JsonStthm::Reader::E_EVENT_NEED_INPUT)
+		{
+			const size_t iSize = (sJson.size() - iFed < iChunkSize) ? sJson.size() - iFed : iChunkSize;
+			if (iSize == 0)
+				oFed.EndFeed();
+			else
+				oFed.Feed(sJson.c_str() + iFed, iSize);
+			iFed += iSize;
+			continue;
+		}
+
+		if (eEvent != oWhole.Next())
+			return false;
+		if ((eEvent == JsonStthm::Reader::E_EVENT_KEY || eEvent == JsonStthm::Reader::E_EVENT_STRING) && strcmp(oFed.GetString(), oWhole.GetString()) != 0)
+			return false;
+		if (eEvent == JsonStthm::Reader::E_EVENT_INTEGER && oFed.GetInteger() != oWhole.GetInteger())
+			return false;
+		if (eEvent == JsonStthm::Reader::E_EVENT_FLOAT && oFed.GetFloat() != oWhole.GetFloat())
+			return false;
+		if (eEvent == JsonStthm::Reader::E_EVENT_END || eEvent == JsonStthm::Reader::E_EVENT_ERROR)
+			return eEvent == JsonStthm::Reader::E_EVENT_END && oFed.GetOffset() == oWhole.GetOffset();
+	}
+}
+
+struct MemoryInput
+{
+	const char*	pData;
+	size_t		iRemaining;
+};
+
+size_t ReadMemory(char* pBuffer, size_t iSize, void* pUserData)
+{
+	MemoryInput* pInput = (MemoryInput*)pUserData;
+	if (iSize > pInput->iRemaining)
+		iSize = pInput->iRemaining;
+	memcpy(pBuffer, pInput->pData, iSize);
+	pInput->pData += iSize;
+	pInput->iRemaining -= iSize;
+	return iSize;
+}
+
+// Feed pInput one byte at a time until next event, or until next value is skipped when bSkip
+JsonStthm::Reader::EEvent FeedBytesUntilEvent(JsonStthm::Reader& oReader, const char*& pInput, bool bSkip)
+{
+	const int iDepth = oReader.GetDepth();
+	while (true)
+	{
+		// Skip of a container started is resumed by Next(), otherwise SkipValue() is called again
+		const JsonStthm::Reader::EEvent eEvent = (bSkip && oReader.GetDepth() == iDepth) ? oReader.SkipValue() : oReader.Next();
+		if (eEvent != JsonStthm::Reader::E_EVENT_NEED_INPUT)
+			return eEvent;
+		if (*pInput == 0)
+			oReader.EndFeed();
+		else
+			oReader.Feed(pInput++, 1);
+	}
+}
+
+bool AppendString(const char* pData, size_t iSize, void* pUserData)
+{
+	((JsonStthmString*)pUserData)->append(pData, iSize);
+	return true;
+}
+
+// Allocator of user code, counting strings still allocated
+JsonStthm::JsonValue* CountingCreateJsonValue(JsonStthm::Allocator* pAllocator, void* /*pUserData*/)
+{
+	return new JsonStthm::JsonValue(pAllocator);
+}
+
+void CountingDeleteJsonValue(JsonStthm::JsonValue* pValue, void* /*pUserData*/)
+{
+	delete pValue;
+}
+
+char* CountingAllocString(size_t iSize, void* pUserData)
+{
+	++*(int*)pUserData;
+	return (char*)malloc(iSize);
+}
+
+void CountingFreeString(char* pString, void* pUserData)
+{
+	--*(int*)pUserData;
+	free(pString);
+}
+
+bool GetFirstMatch(const JsonStthm::JsonValue& /*oValue*/, void* /*pUserData*/)
+{
+	return false;
+}
+
+bool AppendMatch(const JsonStthm::JsonValue& oValue, void* pUserData)
+{
+	((JsonStthm::JsonValue*)pUserData)->Append() = oValue;
+	return true;
+}
+
+// Values selected by pPath compared with the JSON array pExpected
+bool CheckPathMatches(const JsonStthm::JsonValue& oRoot, const char* pPath, const char* pExpected)
+{
+	JsonStthm::JsonPath oPath;
+	JsonStthm::JsonValue oExpected;
+	if (oPath.Compile(pPath) == false || oExpected.ReadString(pExpected) != 0)
+		return false;
+
+	JsonStthm::JsonValue oMatches;
+	oMatches.InitType(JsonStthm::JsonValue::E_TYPE_ARRAY);
+	return oPath.Select(oRoot, AppendMatch, &oMatches) == (size_t)oExpected.GetMemberCount() && oMatches == oExpected;
+}
+
+int main()
+{
+	JsonStthm::JsonValue oSource;
+	GenerateDocument(oSource, 10000);
+	JsonStthmString sJson;
+	oSource.WriteString(sJson, false);
+
+	printf("Parser : %s, document : %d bytes\n", c_pSimdName, (int)sJson.size());
+
+	BEGIN_TEST_SUITE("JsonStthm")
+		JsonStthm::JsonValue oValue;
+		CHECK(oValue.ReadString(sJson.c_str()) == 0)
+		CHECK(oValue == oSource)
+
+		JsonStthm::JsonDoc oDoc;
+		CHECK(oDoc.ReadString(sJson.c_str()) == 0)
+		CHECK(oDoc.GetRoot() == oSource)
+
+		// Index of large containers is built by parser, const lookups only read
+		const size_t iDocUsage = oDoc.MemoryUsage();
+		CHECK(oDoc.GetRoot()["host-9999"]["name"] == oSource["host-9999"]["name"])
+		CHECK(oDoc.MemoryUsage() == iDocUsage)
+
+		int iCountingStrings = 0;
+		JsonStthm::Allocator oCountingAllocator;
+		oCountingAllocator.CreateJsonValue = &CountingCreateJsonValue;
+		oCountingAllocator.DeleteJsonValue = &CountingDeleteJsonValue;
+		oCountingAllocator.AllocString = &CountingAllocString;
+		oCountingAllocator.FreeString = &CountingFreeString;
+		oCountingAllocator.pUserData = &iCountingStrings;
+		{
+			JsonStthm::JsonValue oCountingValue(&oCountingAllocator);
+			CHECK(oCountingValue.ReadString(sJson.c_str()) == 0)
+			for (int iHost = 0; iHost < 64; ++iHost)
+				oCountingValue["host-42"][JsonStthmString(1, (char)('a' + iHost % 26)).append(iHost / 26 + 1, '_').c_str()] = (int64_t)iHost;
+			CHECK(oCountingValue["host-42"]["l_"].ToInteger() == 11)
+		}
+		CHECK(iCountingStrings == 0)
+
+		// Containers are indexed by parser from threshold count, index is the only string of an array of numbers
+#if STTHM_ARRAY_INDEX_THRESHOLD > 0 && STTHM_OBJECT_INDEX_THRESHOLD > 0
+		for (int iExtra = -1; iExtra <= 0; ++iExtra)
+		{
+			JsonStthmString sSmallArray = "[", sSmallObject = "{";
+			for (int iChild = 0; iChild < STTHM_ARRAY_INDEX_THRESHOLD + iExtra; ++iChild)
+				sSmallArray += (iChild > 0 ? ",1" : "1");
+			for (int iChild = 0; iChild < STTHM_OBJECT_INDEX_THRESHOLD + iExtra; ++iChild)
+				sSmallObject += (iChild > 0 ? ",\"k" : "\"k") + JsonStthmString(1, (char)('a' + iChild % 26)) + JsonStthmString(iChild / 26 + 1, '_') + "\":1";
+			sSmallArray += "]";
+			sSmallObject += "}";
+			JsonStthm::JsonValue oSmall(&oCountingAllocator);
+			CHECK(oSmall.ReadString(sSmallArray.c_str()) == 0 && iCountingStrings == (iExtra == 0 ? 1 : 0))
+			CHECK(oSmall.ReadString(sSmallObject.c_str()) == 0 && iCountingStrings == STTHM_OBJECT_INDEX_THRESHOLD + iExtra + (iExtra == 0 ? 1 : 0))
+		}
+		CHECK(iCountingStrings == 0)
+#endif
+
+		JsonStthm::JsonDoc oIndexedDoc;
+		CHECK(oIndexedDoc.ReadString(sJson.c_str(), NULL, JsonStthm::JsonDoc::E_PARSE_MODE_STRUCTURAL_INDEX) == 0)
+		CHECK(oIndexedDoc.GetRoot() == oSource)
+
+		JsonStthm::JsonDoc oLazyDoc;
+		CHECK(oLazyDoc.ReadString(sJson.c_str(), NULL, JsonStthm::JsonDoc::E_PARSE_MODE_LAZY) == 0)
+		CHECK(oLazyDoc.GetRoot() == oSource)
+		CHECK(oLazyDoc.GetLazyError() == 0)
+		// Mismatched braces are found by first pass, other errors on access
+		CHECK(oLazyDoc.ReadString("[{]}", NULL, JsonStthm::JsonDoc::E_PARSE_MODE_LAZY) != 0)
+		CHECK(oLazyDoc.ReadString("{\"a\":[1,2]]}", NULL, JsonStthm::JsonDoc::E_PARSE_MODE_LAZY) != 0)
+		CHECK(oLazyDoc.ReadString("[[1 2]]", NULL, JsonStthm::JsonDoc::E_PARSE_MODE_LAZY) == 0)
+		CHECK(oLazyDoc.GetRoot()[0][0].IsNull() && oLazyDoc.GetRoot()[0].IsNull() && oLazyDoc.GetLazyError() == 1)
+		CHECK(oLazyDoc.ReadString("{\"a\":\n[1,,2]}", NULL, JsonStthm::JsonDoc::E_PARSE_MODE_LAZY) == 0)
+		CHECK(oLazyDoc.GetLazyError() == 0)
+		CHECK(oLazyDoc.GetRoot()["a"][1].IsNull() && oLazyDoc.GetRoot()["a"].IsNull() && oLazyDoc.GetLazyError() == 2)
+
+		JsonStthmString sInsitu = sJson;
+		JsonStthm::JsonDoc oInsituDoc;
+		CHECK(oInsituDoc.ReadStringInsitu(&sInsitu[0], &sInsitu[0] + sInsitu.size()) == 0)
+		CHECK(oInsituDoc.GetRoot() == oSource)
+		CHECK(oInsituDoc.MemoryUsage() < oDoc.MemoryUsage())
+		printf("JsonDoc memory usage : %d bytes, insitu : %d bytes\n", (int)oDoc.MemoryUsage(), (int)oInsituDoc.MemoryUsage());
+
+		JsonStthm::CompactDoc oCompactDoc;
+		CHECK(oCompactDoc.ReadString(sJson.c_str(), sJson.c_str() + sJson.size()) == 0)
+		JsonStthm::JsonValue oCompactCopy;
+		oCompactDoc.GetRoot().ToJsonValue(oCompactCopy);
+		CHECK(oCompactCopy == oSource)
+		CHECK(oCompactDoc.GetRoot()["host-42"]["samples"][3]["tag"].ToString() != NULL)
+		printf("CompactDoc memory usage : %d bytes\n", (int)oCompactDoc.MemoryUsage());
+
+		CHECK(oCompactDoc.WriteTape("JsonStthmTest.tape"))
+		JsonStthm::CompactDoc oTapeDoc;
+		CHECK(oTapeDoc.ReadTape("JsonStthmTest.tape") == 0)
+		JsonStthm::JsonValue oTapeCopy;
+		oTapeDoc.GetRoot().ToJsonValue(oTapeCopy);
+		CHECK(oTapeCopy == oSource)
+		remove("JsonStthmTest.tape");
+
+		CHECK(oSource.WriteFile("JsonStthmTest.json", false))
+		JsonStthm::JsonDoc oFileDoc;
+		CHECK(oFileDoc.ReadFile("JsonStthmTest.json") == 0)
+		CHECK(oFileDoc.GetRoot() == oSource)
+		remove("JsonStthmTest.json");
+
+		JsonStthm::JsonValue oNumber;
+		CHECK(oNumber.ReadString("[0.1, 1e23, -2.2250738585072011e-308, 9007199254740993, 9223372036854775808]") == 0)
+		CHECK(oNumber[0].ToFloat() == 0.1)
+		CHECK(oNumber[1].ToFloat() == 1e23)
+		CHECK(oNumber[2].ToFloat() == -2.2250738585072011e-308)
+		CHECK(oNumber[3].ToInteger() == 9007199254740993LL)
+		CHECK(oNumber[4].IsFloat())
+	END_TEST_SUITE()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Parse pretty printed document", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonValue")
+			JsonStthm::JsonValue oValue;
+			CHECK(oValue.ReadString(sJson.c_str(), sJson.c_str() + sJson.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc")
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadString(sJson.c_str(), sJson.c_str() + sJson.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc structural index")
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadString(sJson.c_str(), sJson.c_str() + sJson.size(), JsonStthm::JsonDoc::E_PARSE_MODE_STRUCTURAL_INDEX) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		// Include copy of input
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc insitu")
+			JsonStthmString sInsitu = sJson;
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadStringInsitu(&sInsitu[0], &sInsitu[0] + sInsitu.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("CompactDoc")
+			JsonStthm::CompactDoc oDoc;
+			CHECK(oDoc.ReadString(sJson.c_str(), sJson.c_str() + sJson.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Reader")
+			JsonStthm::Reader oReader;
+			oReader.SetInput(sJson.c_str(), sJson.c_str() + sJson.size());
+			JsonStthm::Reader::EEvent eEvent;
+			do
+			{
+				eEvent = oReader.Next();
+			}
+			while (eEvent != JsonStthm::Reader::E_EVENT_END && eEvent != JsonStthm::Reader::E_EVENT_ERROR);
+			CHECK(eEvent == JsonStthm::Reader::E_EVENT_END)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	const char* const pFilename = "JsonStthmBenchmark.json";
+	oSource.WriteFile(pFilename, false);
+
+	const char* const pTapeFilename = "JsonStthmBenchmark.tape";
+	{
+		JsonStthm::CompactDoc oCompactDoc;
+		oCompactDoc.ReadString(sJson.c_str(), sJson.c_str() + sJson.size());
+		oCompactDoc.WriteTape(pTapeFilename);
+	}
+
+	BEGIN_BENCHMARK_VERSUS_EX("Read file", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonValue")
+			JsonStthm::JsonValue oValue;
+			CHECK(oValue.ReadFile(pFilename) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc")
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadFile(pFilename) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc structural index")
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadFile(pFilename, JsonStthm::JsonDoc::E_PARSE_MODE_STRUCTURAL_INDEX) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("CompactDoc")
+			JsonStthm::CompactDoc oDoc;
+			CHECK(oDoc.ReadFile(pFilename) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("CompactDoc tape")
+			JsonStthm::CompactDoc oDoc;
+			CHECK(oDoc.ReadTape(pTapeFilename) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	remove(pFilename);
+	remove(pTapeFilename);
+
+	// One host per line, 4 times to get more lines, and same hosts in a root array
+	JsonStthmString sJsonLines;
+	JsonStthmString sJsonArray = "[";
+	for (int iRepeat = 0; iRepeat < 4; ++iRepeat)
+	{
+		for (JsonStthm::JsonValue::Iterator itHost = oSource.begin(); itHost != oSource.end(); ++itHost)
+		{
+			JsonStthmString sLine;
+			(*itHost).WriteString(sLine, true);
+			sJsonLines += sLine;
+			sJsonLines += '\n';
+			if (sJsonArray.size() > 1)
+				sJsonArray += ",\n";
+			sJsonArray += sLine;
+		}
+	}
+	sJsonArray += "]";
+
+	BEGIN_TEST_SUITE("JsonLinesDoc")
+		JsonStthm::JsonLinesDoc oLines;
+		CHECK(oLines.ReadString(sJsonLines.c_str(), sJsonLines.c_str() + sJsonLines.size()) == 0)
+		CHECK(oLines.GetCount() == 4 * 10000)
+		CHECK(oLines[10042] == oSource["host-42"])
+		CHECK(oLines.ReadString("{\"a\":1}\n\n[1,2}\n") == 3)
+
+		// Same result with any chunks : one value per line, spaces around it
+		JsonStthmString sMultiLineValues, sOneLineValues;
+		for (int iValue = 0; iValue < 40000; ++iValue)
+		{
+			sMultiLineValues += "[1,\n2,\n3]\n";
+			sOneLineValues += " [1, 2,\t3] \r\n";
+		}
+		const int pThreadCounts[] = { 1, 8 };
+		for (int iThreads = 0; iThreads < 2; ++iThreads)
+		{
+			JsonStthm::JsonLinesDoc oThreadLines(pThreadCounts[iThreads]);
+			CHECK(oThreadLines.ReadString(sMultiLineValues.c_str(), sMultiLineValues.c_str() + sMultiLineValues.size()) == 1 && oThreadLines.GetCount() == 0)
+			CHECK(oThreadLines.ReadString(sOneLineValues.c_str(), sOneLineValues.c_str() + sOneLineValues.size()) == 0 && oThreadLines.GetCount() == 40000)
+			CHECK(oThreadLines[39999][2].ToInteger() == 3)
+			CHECK(oThreadLines.ReadString("1 2 3\n{\"a\":1}{\"b\":2}\n") == 1)
+			CHECK(oThreadLines.ReadString("{\"a\":1}\n{\"a\":1}{\"b\":2}\n") == 2)
+			CHECK(oThreadLines.ReadString("1\n2") == 0 && oThreadLines.GetCount() == 2)
+		}
+	END_TEST_SUITE()
+
+	BEGIN_TEST_SUITE("JsonDoc parallel")
+		JsonStthm::JsonDoc oArrayDoc;
+		CHECK(oArrayDoc.ReadString(sJsonArray.c_str(), sJsonArray.c_str() + sJsonArray.size(), JsonStthm::JsonDoc::E_PARSE_MODE_PARALLEL) == 0)
+		CHECK(oArrayDoc.GetRoot().GetMemberCount() == 4 * 10000)
+		// Table of root array is built by parser, const accesses only read
+		const size_t iArrayUsage = oArrayDoc.MemoryUsage();
+		CHECK(oArrayDoc.GetRoot()[10042] == oSource["host-42"])
+		CHECK(oArrayDoc.MemoryUsage() == iArrayUsage)
+		JsonStthmString sInvalidArray = sJsonArray;
+		sInvalidArray[sInvalidArray.size() / 2] = '}';
+		CHECK(oArrayDoc.ReadString(sInvalidArray.c_str(), sInvalidArray.c_str() + sInvalidArray.size(), JsonStthm::JsonDoc::E_PARSE_MODE_PARALLEL) > 0)
+	END_TEST_SUITE()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Parse root array", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc")
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadString(sJsonArray.c_str(), sJsonArray.c_str() + sJsonArray.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc parallel")
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadString(sJsonArray.c_str(), sJsonArray.c_str() + sJsonArray.size(), JsonStthm::JsonDoc::E_PARSE_MODE_PARALLEL) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Parse JSON lines", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Reader")
+			JsonStthm::Reader oReader;
+			oReader.SetInput(sJsonLines.c_str(), sJsonLines.c_str() + sJsonLines.size());
+			JsonStthm::JsonValue oLine;
+			size_t iCount = 0;
+			while (oReader.ReadValue(oLine))
+				++iCount;
+			CHECK(iCount == 4 * 10000)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonLinesDoc 1 thread")
+			JsonStthm::JsonLinesDoc oLines(1);
+			CHECK(oLines.ReadString(sJsonLines.c_str(), sJsonLines.c_str() + sJsonLines.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonLinesDoc")
+			JsonStthm::JsonLinesDoc oLines;
+			CHECK(oLines.ReadString(sJsonLines.c_str(), sJsonLines.c_str() + sJsonLines.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	BEGIN_TEST_SUITE("Write options")
+		JsonStthm::WriteOptions oPretty;
+		CHECK(oSource.EstimateWriteSize(oPretty) >= sJson.size())
+		JsonStthmString sOut;
+		oSource.WriteString(sOut, true);
+		CHECK(oSource.EstimateWriteSize(JsonStthm::WriteOptions(true)) >= sOut.size())
+		oPretty.iReserveSize = sJson.size() / 2;
+		oSource.WriteString(sOut, oPretty);
+		CHECK(sOut == sJson)
+
+		JsonStthm::JsonValue oValue;
+		CHECK(oValue.ReadString("{\"b\":[1,{\"e\":true}],\"a\":{\"d\":2,\"c\":null}}") == 0)
+		JsonStthm::WriteOptions oSorted(true);
+		oSorted.bSortKeys = true;
+		oValue.WriteString(sOut, oSorted);
+		CHECK(sOut == "{\"a\":{\"c\":null,\"d\":2},\"b\":[1,{\"e\":true}]}")
+
+		JsonStthm::WriteOptions oSpaces;
+		oSpaces.cIndentChar = ' ';
+		oSpaces.iIndentWidth = 2;
+		oSpaces.eNewLine = JsonStthm::WriteOptions::E_NEWLINE_CRLF;
+		oValue["b"].WriteString(sOut, oSpaces);
+		CHECK(sOut == "[\r\n  1,\r\n  {\r\n    \"e\": true\r\n  }\r\n]")
+		CHECK(oValue["b"].EstimateWriteSize(oSpaces) == sOut.size())
+
+		JsonStthm::WriteOptions oDigits(true);
+		oDigits.eFloatFormat = JsonStthm::WriteOptions::E_FLOAT_SIGNIFICANT;
+		oDigits.iFloatPrecision = 3;
+		CHECK(oValue.ReadString("[3.14159265, 9.9996, 0.000123456, 1e300, -2.5, 1234567.0]") == 0)
+		oValue.WriteString(sOut, oDigits);
+		CHECK(sOut == "[3.14,10.0,0.000123,1e300,-2.5,1230000.0]")
+
+		// Deeper than indentation table
+		JsonStthm::JsonValue oDeep;
+		JsonStthm::JsonValue* pLevel = &oDeep;
+		for (int iLevel = 0; iLevel < 40; ++iLevel)
+			pLevel = &pLevel->Append();
+		*pLevel = (int64_t)1;
+		oDeep.WriteString(sOut, false);
+		CHECK(sOut.find("\n" + JsonStthmString(40, '\t') + "1\n") != JsonStthmString::npos)
+	END_TEST_SUITE()
+
+	BEGIN_TEST_SUITE("Writer")
+		JsonStthm::JsonValue oValue;
+		CHECK(oValue.ReadString("{\"s\":\"a\\\"b\\\\c\\n\\t\\u0001\xC3\xA9/\",\"e\":{},\"a\":[[],{},[[]]],\"n\":[1,-2,0.5,true,false,null],\"o\":{\"x\":{\"y\":[]}}}") == 0)
+		for (int iCompact = 0; iCompact < 2; ++iCompact)
+		{
+			JsonStthmString sExpected;
+			oValue.WriteString(sExpected, iCompact != 0);
+
+			// Same events as oValue, small flush size to write in several parts
+			JsonStthmString sEvents;
+			JsonStthm::Writer oWriter(iCompact != 0, 16);
+			oWriter.SetOutput(AppendString, &sEvents);
+			oWriter.BeginObject();
+			oWriter.Key("s");
+			oWriter.Value("a\"b\\c\n\t\x01\xC3\xA9/");
+			oWriter.Key("e");
+			oWriter.BeginObject();
+			oWriter.EndObject();
+			oWriter.Key("a");
+			oWriter.BeginArray();
+			oWriter.BeginArray();
+			oWriter.EndArray();
+			oWriter.BeginObject();
+			oWriter.EndObject();
+			oWriter.BeginArray();
+			oWriter.BeginArray();
+			oWriter.EndArray();
+			oWriter.EndArray();
+			oWriter.EndArray();
+			oWriter.Key("n");
+			oWriter.BeginArray();
+			oWriter.Value(1);
+			oWriter.Value((int64_t)-2);
+			oWriter.Value(0.5);
+			oWriter.Value(true);
+			oWriter.Value(false);
+			oWriter.Null();
+			oWriter.EndArray();
+			oWriter.Key("o");
+			oWriter.BeginObject();
+			oWriter.Key("x");
+			oWriter.Value(oValue["o"]["x"]);
+			oWriter.EndObject();
+			oWriter.EndObject();
+			CHECK(oWriter.Close())
+			CHECK(sEvents == sExpected)
+
+			JsonStthmString sTree;
+			JsonStthm::Writer oTreeWriter(iCompact != 0);
+			oTreeWriter.SetOutput(AppendString, &sTree);
+			oTreeWriter.Value(oValue);
+			CHECK(oTreeWriter.Close() && sTree == sExpected)
+
+			// Fixed size memory output, exact size then one byte short
+			JsonStthm::Internal::Buffer<char> oMemory(sExpected.size(), 0);
+			JsonStthm::Writer oMemoryWriter(iCompact != 0, 16);
+			oMemoryWriter.SetOutput(oMemory.Data(), sExpected.size());
+			oMemoryWriter.Value(oValue);
+			CHECK(oMemoryWriter.Close() && memcmp(oMemory.Data(), sExpected.c_str(), sExpected.size()) == 0)
+
+			JsonStthm::Writer oFullWriter(iCompact != 0, 16);
+			oFullWriter.SetOutput(oMemory.Data(), sExpected.size() - 1);
+			oFullWriter.Value(oValue);
+			// Last staged bytes fail on Close
+			CHECK(oFullWriter.Close() == false && oFullWriter.IsValid() == false)
+			CHECK(oFullWriter.GetWrittenSize() < sExpected.size())
+		}
+	END_TEST_SUITE()
+
+	BEGIN_TEST_SUITE("Write parallel")
+		JsonStthm::WriteOptions oParallel;
+		oParallel.iThreadCount = 0;
+		JsonStthmString sOut;
+		oSource.WriteString(sOut, oParallel);
+		CHECK(sOut == sJson)
+
+		JsonStthmString sSerialOut;
+		JsonStthm::WriteOptions oSorted(true);
+		oSorted.bSortKeys = true;
+		oSource.WriteString(sSerialOut, oSorted);
+		oSorted.iThreadCount = 3;
+		oSource.WriteString(sOut, oSorted);
+		CHECK(sOut == sSerialOut)
+
+		// Lazy containers are loaded by writing threads
+		JsonStthm::JsonDoc oLazyDoc;
+		CHECK(oLazyDoc.ReadString(sJsonArray.c_str(), sJsonArray.c_str() + sJsonArray.size(), JsonStthm::JsonDoc::E_PARSE_MODE_LAZY) == 0)
+		oLazyDoc.GetRoot().WriteString(sOut, oParallel);
+		JsonStthm::JsonDoc oArrayDoc;
+		CHECK(oArrayDoc.ReadString(sJsonArray.c_str(), sJsonArray.c_str() + sJsonArray.size()) == 0)
+		oArrayDoc.GetRoot().WriteString(sSerialOut, false);
+		CHECK(sOut == sSerialOut)
+
+		oParallel.iThreadCount = 0;
+		CHECK(oSource.WriteFile("JsonStthmTest.json", oParallel))
+		JsonStthm::JsonDoc oFileDoc;
+		CHECK(oFileDoc.ReadFile("JsonStthmTest.json") == 0)
+		CHECK(oFileDoc.GetRoot() == oSource)
+		remove("JsonStthmTest.json");
+	END_TEST_SUITE()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Write document", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Compact")
+			JsonStthmString sOut;
+			oSource.WriteString(sOut, true);
+			CHECK(sOut.size() > 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Pretty")
+			JsonStthmString sOut;
+			oSource.WriteString(sOut, false);
+			CHECK(sOut.size() == sJson.size())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Pretty parallel")
+			JsonStthm::WriteOptions oOptions;
+			oOptions.iThreadCount = 0;
+			JsonStthmString sOut;
+			oSource.WriteString(sOut, oOptions);
+			CHECK(sOut.size() == sJson.size())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		// Size of previous output
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Pretty reserved")
+			JsonStthm::WriteOptions oOptions;
+			oOptions.iReserveSize = sJson.size();
+			JsonStthmString sOut;
+			oSource.WriteString(sOut, oOptions);
+			CHECK(sOut.size() == sJson.size())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Pretty reserved with estimate")
+			JsonStthm::WriteOptions oOptions;
+			oOptions.iReserveSize = oSource.EstimateWriteSize(oOptions);
+			JsonStthmString sOut;
+			oSource.WriteString(sOut, oOptions);
+			CHECK(sOut.size() == sJson.size())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Pretty 4 spaces sorted")
+			JsonStthm::WriteOptions oOptions;
+			oOptions.cIndentChar = ' ';
+			oOptions.iIndentWidth = 4;
+			oOptions.bSortKeys = true;
+			JsonStthmString sOut;
+			oSource.WriteString(sOut, oOptions);
+			CHECK(sOut.size() > sJson.size())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Writer pretty")
+			size_t iSize = 0;
+			JsonStthm::Writer oWriter(false);
+			oWriter.SetOutput(CountBytes, &iSize);
+			oWriter.Value(oSource);
+			CHECK(oWriter.Close() && iSize == sJson.size())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	JsonStthmString sMsgPack;
+	oSource.WriteMsgPack(sMsgPack);
+	JsonStthmString sCompactJson;
+	oSource.WriteString(sCompactJson, true);
+
+	BEGIN_TEST_SUITE("MessagePack")
+		JsonStthm::JsonValue oValue;
+		CHECK(oValue.ReadMsgPack(sMsgPack.data(), sMsgPack.size()) == 0)
+		CHECK(oValue == oSource)
+
+		JsonStthm::JsonDoc oMsgPackDoc;
+		CHECK(oMsgPackDoc.ReadMsgPack(sMsgPack.data(), sMsgPack.size()) == 0)
+		CHECK(oMsgPackDoc.GetRoot() == oSource)
+
+		JsonStthm::JsonValue oLimits;
+		CHECK(oLimits.ReadString("[0, -1, -32, -33, 127, 128, 255, 256, 65535, 65536, 4294967295, 4294967296, -128, -129, -32768, -32769, -2147483648, -2147483649, 9223372036854775807, -9223372036854775808, 0.5, \"\", null, true, {}, []]") == 0)
+		JsonStthmString sLimits;
+		oLimits.WriteMsgPack(sLimits);
+		JsonStthm::JsonValue oLimitsCopy;
+		CHECK(oLimitsCopy.ReadMsgPack(sLimits.data(), sLimits.size()) == 0)
+		CHECK(oLimitsCopy == oLimits)
+
+		// uint 64 too large for int64_t, float 32, truncated input, trailing byte and binary type
+		const uint8_t pUInt64[] = { 0xCF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+		CHECK(oValue.ReadMsgPack(pUInt64, sizeof(pUInt64)) == 0 && oValue.IsFloat())
+		const uint8_t pFloat32[] = { 0xCA, 0x3F, 0xC0, 0x00, 0x00 };
+		CHECK(oValue.ReadMsgPack(pFloat32, sizeof(pFloat32)) == 0 && oValue.ToFloat() == 1.5)
+		CHECK(oValue.ReadMsgPack(sMsgPack.data(), sMsgPack.size() - 1) > 0)
+		const uint8_t pTrailing[] = { 0xC0, 0xC0 };
+		CHECK(oValue.ReadMsgPack(pTrailing, sizeof(pTrailing)) == 2)
+		const uint8_t pBinary[] = { 0x91, 0xC4, 0x01, 0x00 };
+		CHECK(oValue.ReadMsgPack(pBinary, sizeof(pBinary)) == 2)
+	END_TEST_SUITE()
+
+	printf("MessagePack : %d bytes, compact JSON : %d bytes\n", (int)sMsgPack.size(), (int)sCompactJson.size());
+
+	BEGIN_BENCHMARK_VERSUS_EX("Encode document", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JSON compact")
+			JsonStthmString sOut;
+			oSource.WriteString(sOut, true);
+			CHECK(sOut.size() == sCompactJson.size())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("MessagePack")
+			JsonStthmString sOut;
+			oSource.WriteMsgPack(sOut);
+			CHECK(sOut.size() == sMsgPack.size())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Decode document", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonValue JSON compact")
+			JsonStthm::JsonValue oValue;
+			CHECK(oValue.ReadString(sCompactJson.c_str(), sCompactJson.c_str() + sCompactJson.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonValue MessagePack")
+			JsonStthm::JsonValue oValue;
+			CHECK(oValue.ReadMsgPack(sMsgPack.data(), sMsgPack.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc JSON compact")
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadString(sCompactJson.c_str(), sCompactJson.c_str() + sCompactJson.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc MessagePack")
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadMsgPack(sMsgPack.data(), sMsgPack.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	// 10000 strings of 128 bytes each
+	const char* const pAscii = "Lorem ipsum dolor sit amet, consectetur adipiscing elit. ";
+	const char* const pUtf8 = "\xC3\xA9t\xC3\xA9 \xE2\x82\xAC \xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x98\x80 ";
+	const char* const pEscapes = "\"a\"\t\\b\n\r";
+	JsonStthm::JsonValue oAsciiStrings, oUtf8Strings, oEscapeStrings;
+	{
+		JsonStthmString sAscii, sUtf8, sEscapes;
+		while (sAscii.size() < 128)
+			sAscii += pAscii;
+		while (sUtf8.size() < 128)
+			sUtf8 += pUtf8;
+		while (sEscapes.size() < 128)
+			sEscapes += pEscapes;
+		sAscii.resize(128);
+		sEscapes.resize(128);
+		for (int iIndex = 0; iIndex < 10000; ++iIndex)
+		{
+			oAsciiStrings.Append() = sAscii.c_str();
+			oUtf8Strings.Append() = sUtf8.c_str();
+			oEscapeStrings.Append() = sEscapes.c_str();
+		}
+	}
+
+	BEGIN_BENCHMARK_VERSUS_EX("Write strings", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("ASCII")
+			JsonStthmString sOut;
+			oAsciiStrings.WriteString(sOut, true);
+			CHECK(sOut.size() > 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("UTF-8")
+			JsonStthmString sOut;
+			oUtf8Strings.WriteString(sOut, true);
+			CHECK(sOut.size() > 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Escape dense")
+			JsonStthmString sOut;
+			oEscapeStrings.WriteString(sOut, true);
+			CHECK(sOut.size() > 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	JsonStthm::JsonDoc oDoc;
+	oDoc.ReadString(sJson.c_str(), sJson.c_str() + sJson.size());
+
+	JsonStthm::CompactDoc oCompactDoc;
+	oCompactDoc.ReadString(sJson.c_str(), sJson.c_str() + sJson.size());
+
+	BEGIN_BENCHMARK_VERSUS_EX("Walk document", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc")
+			double fSum = 0.0;
+			for (JsonStthm::JsonValue::Iterator itHost = oDoc.GetRoot().begin(); itHost != oDoc.GetRoot().end(); ++itHost)
+			{
+				const JsonStthm::JsonValue& oSamples = (*itHost)["samples"];
+				for (JsonStthm::JsonValue::Iterator itSample = oSamples.begin(); itSample != oSamples.end(); ++itSample)
+					fSum += (*itSample)["value"].ToFloat();
+			}
+			CHECK(fSum > 0.0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("CompactDoc")
+			double fSum = 0.0;
+			JsonStthm::CompactValue oRoot = oCompactDoc.GetRoot();
+			for (JsonStthm::CompactValue::Iterator itHost = oRoot.begin(); itHost != oRoot.end(); ++itHost)
+			{
+				JsonStthm::CompactValue oSamples = (*itHost)["samples"];
+				for (JsonStthm::CompactValue::Iterator itSample = oSamples.begin(); itSample != oSamples.end(); ++itSample)
+					fSum += (*itSample)["value"].ToFloat();
+			}
+			CHECK(fSum > 0.0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Lookup members by name", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonValue")
+			char pName[64];
+			bool bFound = true;
+			for (int iHost = 0; iHost < 10000; ++iHost)
+			{
+				snprintf(pName, 64, "host-%d", iHost);
+				bFound &= oSource[pName]["uptime"].ToInteger() == (int64_t)iHost * 123456789;
+			}
+			CHECK(bFound)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc")
+			const JsonStthm::JsonValue& oRoot = oDoc.GetRoot();
+			char pName[64];
+			bool bFound = true;
+			for (int iHost = 0; iHost < 10000; ++iHost)
+			{
+				snprintf(pName, 64, "host-%d", iHost);
+				bFound &= oRoot[pName]["uptime"].ToInteger() == (int64_t)iHost * 123456789;
+			}
+			CHECK(bFound)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	// Settings document, 15 members by object
+	JsonStthm::JsonValue oSettings;
+	char pSectionNames[15][16], pGroupNames[15][16], pOptionNames[15][16];
+	for (int iName = 0; iName < 15; ++iName)
+	{
+		snprintf(pSectionNames[iName], 16, "section-%d", iName);
+		snprintf(pGroupNames[iName], 16, "group-%d", iName);
+		snprintf(pOptionNames[iName], 16, "option-%d", iName);
+	}
+
+	BEGIN_TEST_SUITE("JsonPath")
+		JsonStthm::JsonValue oRoot;
+		CHECK(oRoot.ReadString("{\"a\":{\"b\":[10,11,12,13,14],\"c d\":1,\"e'f\":2},\"x/y\":3,\"m~n\":4,\"k~1\":5,\"\":6,\"01\":7,"
+			"\"arr\":[{\"v\":1},{\"v\":2},{\"w\":3}]}") == 0)
+		const JsonStthm::JsonValue& oInvalid = JsonStthm::JsonValue::INVALID;
+
+		// JSON Pointer, "" is the root and "/" the member with empty name
+		JsonStthm::JsonPath oEmpty("");
+		CHECK(oEmpty.IsValid() && oEmpty.IsSingle() && oEmpty.GetSegmentCount() == 0 && &oEmpty.Get(oRoot) == &oRoot)
+		JsonStthm::JsonPath oSlash("/");
+		CHECK(oSlash.IsValid() && oSlash.GetSegmentCount() == 1 && oSlash.Get(oRoot).ToInteger() == 6)
+		CHECK(JsonStthm::JsonPath("/a/b/0").Get(oRoot).ToInteger() == 10)
+		CHECK(JsonStthm::JsonPath("/arr/1/v").Get(oRoot).ToInteger() == 2)
+
+		// '~1' is '/', '~0' is '~', "~01" is "~1" and not "~/"
+		CHECK(JsonStthm::JsonPath("/x~1y").Get(oRoot).ToInteger() == 3)
+		CHECK(JsonStthm::JsonPath("/m~0n").Get(oRoot).ToInteger() == 4)
+		CHECK(JsonStthm::JsonPath("/k~01").Get(oRoot).ToInteger() == 5)
+		CHECK(JsonStthm::JsonPath("/x/y").Get(oRoot).IsValid() == false)
+		CHECK(JsonStthm::JsonPath("/a~2").IsValid() == false && JsonStthm::JsonPath("/a~").IsValid() == false)
+
+		// Array tokens are digits without leading zero, "-" is past the last item
+		CHECK(JsonStthm::JsonPath("/a/b/4").Get(oRoot).ToInteger() == 14)
+		CHECK(&JsonStthm::JsonPath("/a/b/5").Get(oRoot) == &oInvalid)
+		CHECK(&JsonStthm::JsonPath("/a/b/01").Get(oRoot) == &oInvalid)
+		CHECK(&JsonStthm::JsonPath("/a/b/-").Get(oRoot) == &oInvalid)
+		CHECK(&JsonStthm::JsonPath("/a/b/-1").Get(oRoot) == &oInvalid)
+		CHECK(JsonStthm::JsonPath("/01").Get(oRoot).ToInteger() == 7)
+
+		// Path expressions, members with or without '$', quoted names
+		CHECK(&JsonStthm::JsonPath("$").Get(oRoot) == &oRoot)
+		CHECK(JsonStthm::JsonPath("$.a.b[1]").Get(oRoot).ToInteger() == 11)
+		CHECK(JsonStthm::JsonPath("a.b[1]").Get(oRoot).ToInteger() == 11)
+		CHECK(JsonStthm::JsonPath("$['a']['c d']").Get(oRoot).ToInteger() == 1)
+		CHECK(JsonStthm::JsonPath("$[\"a\"][\"e'f\"]").Get(oRoot).ToInteger() == 2)
+		CHECK(JsonStthm::JsonPath("$['a']['e\\'f']").Get(oRoot).ToInteger() == 2)
+		CHECK(JsonStthm::JsonPath("$['x/y']").Get(oRoot).ToInteger() == 3)
+		CHECK(JsonStthm::JsonPath("$['']").Get(oRoot).ToInteger() == 6)
+		CHECK(&JsonStthm::JsonPath("$.a.missing").Get(oRoot) == &oInvalid)
+		CHECK(&JsonStthm::JsonPath("$.a.b.c").Get(oRoot) == &oInvalid)
+
+		// Negative indexes from end
+		CHECK(JsonStthm::JsonPath("$.a.b[-1]").Get(oRoot).ToInteger() == 14)
+		CHECK(JsonStthm::JsonPath("$.a.b[-5]").Get(oRoot).ToInteger() == 10)
+		CHECK(&JsonStthm::JsonPath("$.a.b[-6]").Get(oRoot) == &oInvalid)
+		CHECK(&JsonStthm::JsonPath("$.a[0]").Get(oRoot) == &oInvalid)
+
+		// Wildcards match in document order, Get returns first match
+		CHECK(CheckPathMatches(oRoot, "$.arr[*].v", "[1,2]"))
+		CHECK(CheckPathMatches(oRoot, "$.arr.*.w", "[3]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.*", "[[10,11,12,13,14],1,2]"))
+		CHECK(CheckPathMatches(oRoot, "$.a[*][*]", "[10,11,12,13,14]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[*].x", "[]"))
+		CHECK(JsonStthm::JsonPath("$.arr[*].w").Get(oRoot).ToInteger() == 3)
+		CHECK(JsonStthm::JsonPath("$.*").Select(oRoot) == 7)
+		CHECK(JsonStthm::JsonPath("$.*.*").Select(oRoot, GetFirstMatch, NULL) == 1)
+
+		// Slices with omitted and negative bounds
+		CHECK(CheckPathMatches(oRoot, "$.a.b[1:3]", "[11,12]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[:2]", "[10,11]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[3:]", "[13,14]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[:]", "[10,11,12,13,14]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[::2]", "[10,12,14]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[1::3]", "[11,14]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[-2:]", "[13,14]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[:-3]", "[10,11]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[-4:-1:2]", "[11,13]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[-10:2]", "[10,11]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[3:100]", "[13,14]"))
+		CHECK(CheckPathMatches(oRoot, "$.a.b[4:1]", "[]"))
+		CHECK(CheckPathMatches(oRoot, "$.arr[1:].v", "[2]"))
+		CHECK(CheckPathMatches(oRoot, "$.a[0:1]", "[]"))
+
+		JsonStthm::JsonPath oSingle("$.a.b[-1]");
+		JsonStthm::JsonPath oWildcard("$.a[*]");
+		JsonStthm::JsonPath oSlice("$.a.b[0:1]");
+		CHECK(oSingle.IsSingle() && oWildcard.IsSingle() == false && oSlice.IsSingle() == false)
+		CHECK(oSingle.GetSegmentCount() == 3 && oSlice.GetSegmentCount() == 3)
+
+		// Invalid syntax matches nothing
+		const char* const pInvalidPaths[] = { "$.", "$..a", "$a", "$.a[1]]", "$.a[", "$.a[]", "$.a[x]", "$.a[*", "$.a['b]", "$.a['b'",
+			"$.a[1", "$.a[1]x", "$.a[1:2:0]", "$.a[1:2:-1]", "$.a[-]", "$.a.b[1 ]", "$['a']b" };
+		bool bAllInvalid = true;
+		for (size_t iPath = 0; iPath < sizeof(pInvalidPaths) / sizeof(pInvalidPaths[0]); ++iPath)
+		{
+			JsonStthm::JsonPath oPath;
+			bAllInvalid &= oPath.Compile(pInvalidPaths[iPath]) == false && oPath.IsValid() == false;
+			bAllInvalid &= &oPath.Get(oRoot) == &oInvalid && oPath.Select(oRoot) == 0;
+		}
+		CHECK(bAllInvalid)
+
+		// Recompiled path forgets previous one
+		JsonStthm::JsonPath oRecompiled("$.a.b[0]");
+		CHECK(oRecompiled.Compile("$.a.b[") == false && &oRecompiled.Get(oRoot) == &oInvalid)
+		CHECK(oRecompiled.Compile("/a/b/2") && oRecompiled.Get(oRoot).ToInteger() == 12)
+
+		// GetAll gives same values as Get, with shared prefixes, failed lookups and paths matching several values
+		const char* const pGetAllPaths[] = { "/a/b/0", "$.a.b[-1]", "$.a.b[9]", "$.a.b[2]", "/a/missing/0", "/a/c d", "$.a['e\\'f']",
+			"$.a.b[1:]", "$.x", "/arr/0/v", "$.arr[*].w", "/arr/2/w", "/arr/2/w/0", "", "$.a.b[", "/x~1y", "$.arr[-1].w" };
+		const size_t iGetAllCount = sizeof(pGetAllPaths) / sizeof(pGetAllPaths[0]);
+		JsonStthm::JsonPath pGetAll[iGetAllCount];
+		const JsonStthm::JsonValue* pGetAllValues[iGetAllCount];
+		for (size_t iPath = 0; iPath < iGetAllCount; ++iPath)
+			pGetAll[iPath].Compile(pGetAllPaths[iPath]);
+		JsonStthm::JsonPath::GetAll(oRoot, pGetAll, iGetAllCount, pGetAllValues);
+
+		bool bSameAsGet = true;
+		for (size_t iPath = 0; iPath < iGetAllCount; ++iPath)
+		{
+			const JsonStthm::JsonValue& oValue = pGetAll[iPath].Get(oRoot);
+			bSameAsGet &= pGetAllValues[iPath] == ((&oValue != &oInvalid) ? &oValue : NULL);
+		}
+		CHECK(bSameAsGet)
+		CHECK(pGetAllValues[0]->ToInteger() == 10 && pGetAllValues[1]->ToInteger() == 14 && pGetAllValues[2] == NULL)
+		CHECK(pGetAllValues[5]->ToInteger() == 1 && pGetAllValues[7]->ToInteger() == 11 && pGetAllValues[13] == &oRoot && pGetAllValues[14] == NULL)
+
+		// Lazy document, containers are loaded by lookups
+		JsonStthm::JsonDoc oLazyDoc;
+		JsonStthmString sRoot;
+		oRoot.WriteString(sRoot, true);
+		CHECK(oLazyDoc.ReadString(sRoot.c_str(), NULL, JsonStthm::JsonDoc::E_PARSE_MODE_LAZY) == 0)
+		CHECK(JsonStthm::JsonPath("/arr/1/v").Get(oLazyDoc.GetRoot()).ToInteger() == 2)
+		CHECK(CheckPathMatches(oLazyDoc.GetRoot(), "$.a.b[-2:]", "[13,14]"))
+		CHECK(oLazyDoc.GetRoot() == oRoot)
+	END_TEST_SUITE()
+
+	JsonStthm::JsonPath pOptionPaths[15 * 15 * 15];
+	const JsonStthm::JsonValue* pOptionValues[15 * 15 * 15];
+	for (int iOption = 0; iOption < 15 * 15 * 15; ++iOption)
+	{
+		char pPath[64];
+		snprintf(pPath, 64, "/settings/%s/%s/%s", pSectionNames[iOption / 225], pGroupNames[(iOption / 15) % 15], pOptionNames[iOption % 15]);
+		pOptionPaths[iOption].Compile(pPath);
+		oSettings["settings"][pSectionNames[iOption / 225]][pGroupNames[(iOption / 15) % 15]][pOptionNames[iOption % 15]] = (int64_t)iOption;
+	}
+
+	BEGIN_BENCHMARK_VERSUS_EX("Lookup deep paths", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("operator[]")
+			int64_t iSum = 0;
+			for (int iOption = 0; iOption < 15 * 15 * 15; ++iOption)
+				iSum += oSettings["settings"][pSectionNames[iOption / 225]][pGroupNames[(iOption / 15) % 15]][pOptionNames[iOption % 15]].ToInteger();
+			CHECK(iSum == 3375 * 3374 / 2)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonPath::Get")
+			int64_t iSum = 0;
+			for (int iOption = 0; iOption < 15 * 15 * 15; ++iOption)
+				iSum += pOptionPaths[iOption].Get(oSettings).ToInteger();
+			CHECK(iSum == 3375 * 3374 / 2)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonPath::GetAll")
+			int64_t iSum = 0;
+			JsonStthm::JsonPath::GetAll(oSettings, pOptionPaths, 15 * 15 * 15, pOptionValues);
+			for (int iOption = 0; iOption < 15 * 15 * 15; ++iOption)
+				iSum += pOptionValues[iOption]->ToInteger();
+			CHECK(iSum == 3375 * 3374 / 2)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	// Previous copy is freed by next one
+	JsonStthm::JsonValue oCopySource;
+	GenerateDocument(oCopySource, 1000);
+	JsonStthm::JsonValue oDefaultCopy;
+	JsonStthm::PoolAllocator oPool;
+	JsonStthm::JsonValue oPoolCopy(oPool.GetAllocator());
+
+	BEGIN_BENCHMARK_VERSUS_EX("Copy document", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Default allocator")
+			oDefaultCopy = oCopySource;
+			CHECK(oDefaultCopy.GetMemberCount() == 1000)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("PoolAllocator")
+			oPoolCopy = oCopySource;
+			CHECK(oPoolCopy.GetMemberCount() == 1000)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	// Subtree goes to another tree and back
+	JsonStthm::JsonValue oTreeA;
+	oTreeA["hosts"] = oCopySource;
+	JsonStthm::JsonValue oTreeB;
+
+	BEGIN_TEST_SUITE("MoveFrom")
+		JsonStthm::JsonValue oTree;
+		CHECK(oTree.ReadString("{\"a\":{\"b\":[1,{\"d\":2}]},\"c\":3}") == 0)
+		const JsonStthm::JsonValue oExpected = oTree;
+
+		// Descendant can't take content of its ancestor, nothing is changed
+		oTree["a"].MoveFrom(oTree);
+		oTree["a"]["b"][1].MoveFrom(oTree);
+		CHECK(oTree == oExpected)
+
+		JsonStthm::PoolAllocator oMovePool;
+		JsonStthm::JsonValue oPoolTree(oMovePool.GetAllocator());
+		oPoolTree["tree"] = oExpected;
+		oPoolTree["tree"]["a"].MoveFrom(oPoolTree);
+		CHECK(oPoolTree["tree"] == oExpected)
+
+		// Ancestor can take content of its descendant
+		oTree.MoveFrom(oTree["a"]["b"][1]);
+		CHECK(oTree["d"].ToInteger() == 2 && oTree.GetMemberCount() == 1)
+		oTree.MoveFrom(oPoolTree["tree"]["a"]);
+		CHECK(oTree == oExpected["a"] && oPoolTree["tree"]["a"].IsNull())
+
+		// Refused moves report it
+		JsonStthm::JsonValue oRefused;
+		CHECK(oRefused.ReadString("{\"a\":{\"b\":[1,{\"d\":2}]},\"c\":3}") == 0)
+		CHECK(oRefused["a"]["b"].MoveFrom(oRefused) == false && oRefused == oExpected)
+		CHECK(oRefused.MoveFrom(oRefused) && oRefused == oExpected)
+	END_TEST_SUITE()
+
+	BEGIN_TEST_SUITE("Detach and Splice")
+		JsonStthm::JsonValue oTree;
+		CHECK(oTree.ReadString("{\"a\":{\"x\":[1,2]},\"b\":[true,\"s\",3],\"c\":null}") == 0)
+
+		// Detach by name and by index
+		JsonStthm::JsonValue oOut;
+		CHECK(oTree.Detach("a", oOut))
+		CHECK(oOut.IsObject() && oOut["x"][1].ToInteger() == 2)
+		CHECK(oTree.GetMemberCount() == 2 && static_cast<const JsonStthm::JsonValue&>(oTree)["a"].IsValid() == false)
+		CHECK(oTree.Detach("missing", oOut) == false && oOut["x"].GetMemberCount() == 2)
+		CHECK(oTree["b"].Detach(1, oOut))
+		CHECK(oOut.IsString() && strcmp(oOut.ToString(), "s") == 0)
+		CHECK(oTree["b"].GetMemberCount() == 2 && oTree["b"][1].ToInteger() == 3)
+		CHECK(oTree["b"].Detach(2, oOut) == false && oOut.IsString())
+		CHECK(oTree["b"].Detach(1, oOut) && oOut.ToInteger() == 3 && oTree["b"].GetMemberCount() == 1)
+
+		// Detach in the detached child or one of its descendants is refused, child is kept
+		JsonStthm::JsonValue oDetachTree;
+		CHECK(oDetachTree.ReadString("[{\"x\":[1]},2]") == 0)
+		const JsonStthm::JsonValue oDetachExpected = oDetachTree;
+		CHECK(oDetachTree.Detach(0, oDetachTree[0]["x"]) == false)
+		CHECK(oDetachTree.Detach(0, oDetachTree[0]) == false)
+		CHECK(oDetachTree.Detach(0, oDetachTree[0]["x"][0]) == false)
+		CHECK(oDetachTree == oDetachExpected)
+
+		// Detach in the container itself
+		CHECK(oDetachTree.Detach(0, oDetachTree) && oDetachTree.IsObject() && oDetachTree["x"][0].ToInteger() == 1)
+
+		// Splice within one allocator
+		JsonStthm::JsonValue oLeft;
+		JsonStthm::JsonValue oRight;
+		CHECK(oLeft.ReadString("[1,2]") == 0 && oRight.ReadString("[3,{\"k\":4}]") == 0)
+		CHECK(oLeft.Splice(oRight))
+		CHECK(oLeft.GetMemberCount() == 4 && oLeft[3]["k"].ToInteger() == 4)
+		CHECK(oRight.IsArray() && oRight.GetMemberCount() == 0)
+		oLeft.Append() = (int64_t)5;
+		CHECK(oLeft.GetMemberCount() == 5 && oLeft[4].ToInteger() == 5)
+
+		// Splice across different allocators, source stays usable
+		JsonStthm::PoolAllocator oSplicePool;
+		JsonStthm::JsonValue oPoolObject(oSplicePool.GetAllocator());
+		oPoolObject["p"] = (int64_t)1;
+		oPoolObject["q"]["r"] = "s";
+		JsonStthm::JsonValue oObject;
+		oObject["o"] = (int64_t)0;
+		CHECK(oObject.Splice(oPoolObject))
+		CHECK(oObject.GetMemberCount() == 3 && oObject["p"].ToInteger() == 1 && strcmp(oObject["q"]["r"].ToString(), "s") == 0)
+		CHECK(oPoolObject.IsObject() && oPoolObject.GetMemberCount() == 0)
+		oPoolObject["t"] = (int64_t)2;
+		CHECK(oPoolObject.GetMemberCount() == 1)
+
+		// Null value takes type of source, different types are refused
+		JsonStthm::JsonValue oNull;
+		CHECK(oNull.Splice(oObject) && oNull.IsObject() && oNull.GetMemberCount() == 3)
+		CHECK(oLeft.Splice(oNull) == false && oNull.GetMemberCount() == 3)
+
+		// Splice in itself or in one of its descendants is refused
+		JsonStthm::JsonValue oNested;
+		CHECK(oNested.ReadString("[0,[1,[2]]]") == 0)
+		const JsonStthm::JsonValue oNestedExpected = oNested;
+		CHECK(oNested.Splice(oNested) == false)
+		CHECK(oNested[1].Splice(oNested) == false)
+		CHECK(oNested[1][1].Splice(oNested[1]) == false)
+		CHECK(oNested == oNestedExpected)
+
+		// Ancestor can take childs of its descendant
+		CHECK(oNested.Splice(oNested[1]))
+		CHECK(oNested.GetMemberCount() == 4 && oNested[1].GetMemberCount() == 0 && oNested[3][0].ToInteger() == 2)
+
+#if defined(STTHM_USE_MOVE)
+		// Move construction and move assignment
+		JsonStthm::JsonValue oMoveSource;
+		CHECK(oMoveSource.ReadString("{\"m\":[1,\"two\"]}") == 0)
+		const JsonStthm::JsonValue oMoveExpected = oMoveSource;
+		JsonStthm::JsonValue oMoved(static_cast<JsonStthm::JsonValue&&>(oMoveSource));
+		CHECK(oMoved == oMoveExpected && oMoveSource.IsNull())
+
+		JsonStthm::JsonValue oAssigned;
+		oAssigned = (int64_t)12;
+		oAssigned = static_cast<JsonStthm::JsonValue&&>(oMoved);
+		CHECK(oAssigned == oMoveExpected && oMoved.IsNull())
+
+		JsonStthm::JsonValue oPoolAssigned(oSplicePool.GetAllocator());
+		oPoolAssigned = static_cast<JsonStthm::JsonValue&&>(oAssigned);
+		CHECK(oPoolAssigned == oMoveExpected && oAssigned.IsNull())
+
+		// Move assignment from an ancestor is ignored
+		oPoolAssigned["m"] = static_cast<JsonStthm::JsonValue&&>(oPoolAssigned);
+		CHECK(oPoolAssigned == oMoveExpected)
+#endif //STTHM_USE_MOVE
+	END_TEST_SUITE()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Move subtree", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Copy")
+			oTreeB["hosts"] = oTreeA["hosts"];
+			oTreeA["hosts"] = oTreeB["hosts"];
+			CHECK(oTreeA["hosts"].IsObject())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("MoveFrom")
+			oTreeB["hosts"].MoveFrom(oTreeA["hosts"]);
+			oTreeA["hosts"].MoveFrom(oTreeB["hosts"]);
+			CHECK(oTreeA["hosts"].IsObject())
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	// One document per request
+	JsonStthmString sRequestJson;
+	oSource["host-42"].WriteString(sRequestJson, true);
+	JsonStthm::JsonDoc oRetainingDoc;
+	oRetainingDoc.SetRetainedSize(1024 * 1024);
+
+	BEGIN_TEST_SUITE("Reader fed by chunks")
+		CHECK(CheckFedEvents(sRequestJson, 1))
+		CHECK(CheckFedEvents(sRequestJson, 7))
+		CHECK(CheckFedEvents(sJson, 4096))
+		CHECK(CheckFedEvents("[\"a\\\"\\u00e9\", -12.5e3, -Infinity, true, null, {\"k\": 123456789012}] 42", 1))
+
+		// Skipped container resumed by Next(), incomplete input at end
+		JsonStthm::Reader oReader;
+		oReader.SetFeedInput();
+		oReader.Feed("{\"a\":{\"b\":\"}", 12);
+		CHECK(oReader.Next() == JsonStthm::Reader::E_EVENT_START_OBJECT)
+		CHECK(oReader.Next() == JsonStthm::Reader::E_EVENT_KEY)
+		CHECK(oReader.SkipValue() == JsonStthm::Reader::E_EVENT_NEED_INPUT)
+		oReader.Feed("]\"},\"c\":1", 9);
+		CHECK(oReader.Next() == JsonStthm::Reader::E_EVENT_START_OBJECT && oReader.GetEvent() == JsonStthm::Reader::E_EVENT_END_OBJECT && oReader.GetDepth() == 1)
+		CHECK(oReader.Next() == JsonStthm::Reader::E_EVENT_KEY && strcmp(oReader.GetString(), "c") == 0)
+		CHECK(oReader.Next() == JsonStthm::Reader::E_EVENT_NEED_INPUT)
+		oReader.EndFeed();
+		CHECK(oReader.Next() == JsonStthm::Reader::E_EVENT_INTEGER)
+		CHECK(oReader.Next() == JsonStthm::Reader::E_EVENT_ERROR)
+
+		// Fed byte by byte, so split at every offset of skipped containers, resumed SkipValue() return start event
+		const char* pSkipInput = "[1,{\"s\":[2,\"]}\",{\"t\":[]}],\"x\":\"{\"},[[],[{}]],3]";
+		JsonStthm::Reader oByteReader;
+		oByteReader.SetFeedInput();
+		CHECK(FeedBytesUntilEvent(oByteReader, pSkipInput, false) == JsonStthm::Reader::E_EVENT_START_ARRAY)
+		CHECK(FeedBytesUntilEvent(oByteReader, pSkipInput, false) == JsonStthm::Reader::E_EVENT_INTEGER)
+		CHECK(FeedBytesUntilEvent(oByteReader, pSkipInput, true) == JsonStthm::Reader::E_EVENT_START_OBJECT)
+		CHECK(oByteReader.GetEvent() == JsonStthm::Reader::E_EVENT_END_OBJECT && oByteReader.GetDepth() == 1)
+		CHECK(FeedBytesUntilEvent(oByteReader, pSkipInput, true) == JsonStthm::Reader::E_EVENT_START_ARRAY)
+		CHECK(oByteReader.GetEvent() == JsonStthm::Reader::E_EVENT_END_ARRAY && oByteReader.GetDepth() == 1)
+		CHECK(FeedBytesUntilEvent(oByteReader, pSkipInput, true) == JsonStthm::Reader::E_EVENT_INTEGER && oByteReader.GetInteger() == 3)
+		CHECK(FeedBytesUntilEvent(oByteReader, pSkipInput, false) == JsonStthm::Reader::E_EVENT_END_ARRAY)
+		CHECK(FeedBytesUntilEvent(oByteReader, pSkipInput, false) == JsonStthm::Reader::E_EVENT_END && *pSkipInput == 0)
+
+		// Resumed SkipContainer() still return end event
+		JsonStthm::Reader oContainerReader;
+		oContainerReader.SetFeedInput();
+		oContainerReader.Feed("[{\"a\":[", 7);
+		CHECK(oContainerReader.Next() == JsonStthm::Reader::E_EVENT_START_ARRAY)
+		CHECK(oContainerReader.Next() == JsonStthm::Reader::E_EVENT_START_OBJECT)
+		CHECK(oContainerReader.SkipContainer() == false && oContainerReader.GetEvent() == JsonStthm::Reader::E_EVENT_NEED_INPUT)
+		oContainerReader.Feed("]}]", 3);
+		CHECK(oContainerReader.Next() == JsonStthm::Reader::E_EVENT_END_OBJECT && oContainerReader.GetDepth() == 1)
+		CHECK(oContainerReader.Next() == JsonStthm::Reader::E_EVENT_END_ARRAY)
+	END_TEST_SUITE()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Read events by chunks", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Whole input")
+			JsonStthm::Reader oReader;
+			oReader.SetInput(sJson.c_str(), sJson.c_str() + sJson.size());
+			while (oReader.Next() < JsonStthm::Reader::E_EVENT_END);
+			CHECK(oReader.GetEvent() == JsonStthm::Reader::E_EVENT_END)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Callback 1500 bytes")
+			MemoryInput oInput = { sJson.c_str(), sJson.size() };
+			JsonStthm::Reader oReader;
+			oReader.SetInput(ReadMemory, &oInput, 1500);
+			while (oReader.Next() < JsonStthm::Reader::E_EVENT_END);
+			CHECK(oReader.GetEvent() == JsonStthm::Reader::E_EVENT_END)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Feed 1500 bytes")
+			JsonStthm::Reader oReader;
+			oReader.SetFeedInput();
+			size_t iFed = 0;
+			JsonStthm::Reader::EEvent eEvent;
+			while ((eEvent = oReader.Next()) < JsonStthm::Reader::E_EVENT_END || eEvent == JsonStthm::Reader::E_EVENT_NEED_INPUT)
+			{
+				if (eEvent != JsonStthm::Reader::E_EVENT_NEED_INPUT)
+					continue;
+				const size_t iSize = (sJson.size() - iFed < 1500) ? sJson.size() - iFed : 1500;
+				if (iSize == 0)
+					oReader.EndFeed();
+				else
+					oReader.Feed(sJson.c_str() + iFed, iSize);
+				iFed += iSize;
+			}
+			CHECK(eEvent == JsonStthm::Reader::E_EVENT_END)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	BEGIN_TEST_SUITE("Binding")
+		Host oHost;
+		CHECK(JsonStthm::ReadBinding(sRequestJson.c_str(), sRequestJson.c_str() + sRequestJson.size(), oHost))
+		CHECK(oHost.sName == "host-42" && oHost.iUptime == (int64_t)42 * 123456789 && oHost.bEnabled == false)
+		CHECK(oHost.fLoad == oSource["host-42"]["load"].ToFloat())
+		CHECK(oHost.pSamples[15].iTimestamp == 1500000015 && oHost.pSamples[15].sTag == oSource["host-42"]["samples"][15]["tag"].ToString())
+
+		JsonStthmString sHostJson;
+		JsonStthm::Writer oWriter(true);
+		oWriter.SetOutput(AppendString, &sHostJson);
+		JsonStthm::WriteBinding(oWriter, oHost);
+		CHECK(oWriter.Close())
+		JsonStthm::JsonValue oHostValue;
+		CHECK(oHostValue.ReadString(sHostJson.c_str()) == 0)
+		CHECK(oHostValue == oSource["host-42"])
+
+		// Unknown members skipped, null and missing ones keep their value, integer accepted for float
+		HostSample oSample;
+		oSample.iTimestamp = 5;
+		oSample.fValue = 0.0;
+		CHECK(JsonStthm::ReadBinding("{\"extra\":{\"a\":[1,{}]},\"value\":2,\"timestamp\":null,\"tag\":\"t\",\"more\":[]}", NULL, oSample))
+		CHECK(oSample.iTimestamp == 5 && oSample.fValue == 2.0 && oSample.sTag == "t")
+		CHECK(JsonStthm::ReadBinding("{\"timestamp\":\"1\"}", NULL, oSample) == false)
+		CHECK(JsonStthm::ReadBinding("{\"timestamp\":1.5}", NULL, oSample) == false)
+		CHECK(JsonStthm::ReadBinding("{\"timestamp\":1}]", NULL, oSample) == false)
+		int iSmall;
+		CHECK(JsonStthm::ReadBinding("4294967296", NULL, iSmall) == false)
+
+		// Skipped values are checked as read ones
+		CHECK(JsonStthm::ReadBinding("{\"unknown\":[tru,1e]}", NULL, oSample) == false)
+		CHECK(JsonStthm::ReadBinding("{\"unknown\":{\"a\" 1}}", NULL, oSample) == false)
+		CHECK(JsonStthm::ReadBinding("{\"unknown\":[1,],\"tag\":\"u\"}", NULL, oSample) == false)
+		CHECK(JsonStthm::ReadBinding("{\"unknown\":{\"a\":[1,{\"b\":\"]\"}]}", NULL, oSample) == false)
+		CHECK(JsonStthm::ReadBinding("{\"unknown\":{\"a\":[1,{\"b\":\"]\"}]},\"tag\":\"v\"}", NULL, oSample) && oSample.sTag == "v")
+		int pPair[2];
+		CHECK(JsonStthm::ReadBinding("[1,2,[3,{\"c\":[]}]]", NULL, pPair) && pPair[0] == 1 && pPair[1] == 2)
+		CHECK(JsonStthm::ReadBinding("[1,2,[3,{\"c\":[}]]", NULL, pPair) == false)
+
+		NamedCounter oCounter;
+		oCounter.iCount = 0;
+		CHECK(JsonStthm::ReadBinding("{\"count\":3,\"name\":\"n\"}", NULL, oCounter) && oCounter.iCount == 3 && oCounter.sName == "n")
+		JsonStthmString sCounterJson;
+		JsonStthm::Writer oCounterWriter(true);
+		oCounterWriter.SetOutput(AppendString, &sCounterJson);
+		JsonStthm::WriteBinding(oCounterWriter, oCounter);
+		CHECK(oCounterWriter.Close() && sCounterJson == "{\"name\":\"n\",\"count\":3}")
+	END_TEST_SUITE()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Read 10k structs", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonValue and copy")
+			Host oHost;
+			for (int iRequest = 0; iRequest < 10000; ++iRequest)
+			{
+				JsonStthm::JsonValue oValue;
+				CHECK(oValue.ReadString(sRequestJson.c_str(), sRequestJson.c_str() + sRequestJson.size()) == 0)
+				CopyHost(oValue, oHost);
+			}
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc retained blocks and copy")
+			Host oHost;
+			for (int iRequest = 0; iRequest < 10000; ++iRequest)
+			{
+				CHECK(oRetainingDoc.ReadString(sRequestJson.c_str(), sRequestJson.c_str() + sRequestJson.size()) == 0)
+				CopyHost(oRetainingDoc.GetRoot(), oHost);
+			}
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Binding")
+			Host oHost;
+			for (int iRequest = 0; iRequest < 10000; ++iRequest)
+			{
+				CHECK(JsonStthm::ReadBinding(sRequestJson.c_str(), sRequestJson.c_str() + sRequestJson.size(), oHost))
+			}
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	BEGIN_BENCHMARK_VERSUS_EX("Parse 10k small documents", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc")
+			for (int iRequest = 0; iRequest < 10000; ++iRequest)
+			{
+				JsonStthm::JsonDoc oDoc;
+				CHECK(oDoc.ReadString(sRequestJson.c_str(), sRequestJson.c_str() + sRequestJson.size()) == 0)
+			}
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc retained blocks")
+			for (int iRequest = 0; iRequest < 10000; ++iRequest)
+			{
+				CHECK(oRetainingDoc.ReadString(sRequestJson.c_str(), sRequestJson.c_str() + sRequestJson.size()) == 0)
+			}
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc thread pool")
+			for (int iRequest = 0; iRequest < 10000; ++iRequest)
+			{
+				JsonStthm::JsonDoc oDoc;
+				oDoc.SetBlockPool(&JsonStthm::BlockPool::GetThreadPool());
+				CHECK(oDoc.ReadString(sRequestJson.c_str(), sRequestJson.c_str() + sRequestJson.size()) == 0)
+			}
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	JsonStthm::JsonValue oArray;
+	for (int iIndex = 0; iIndex < 100000; ++iIndex)
+		oArray.Append() = (double)iIndex;
+
+	JsonStthm::JsonValue oNumbers;
+	for (int iIndex = 0; iIndex < 100000; ++iIndex)
+	{
+		oNumbers.Append() = (int64_t)iIndex * 7919;
+		oNumbers.Append() = (iIndex + 0.5) / 3.0;
+		oNumbers.Append() = (iIndex + 0.5) * 1e-12;
+	}
+	JsonStthmString sNumbersJson;
+	oNumbers.WriteString(sNumbersJson, true);
+
+	BEGIN_BENCHMARK_VERSUS_EX("Parse numbers array", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonValue")
+			JsonStthm::JsonValue oValue;
+			CHECK(oValue.ReadString(sNumbersJson.c_str(), sNumbersJson.c_str() + sNumbersJson.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("JsonDoc")
+			JsonStthm::JsonDoc oDoc;
+			CHECK(oDoc.ReadString(sNumbersJson.c_str(), sNumbersJson.c_str() + sNumbersJson.size()) == 0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	// Define STTHM_ARRAY_INDEX_THRESHOLD to 0 to compare with linked list walk
+	BEGIN_BENCHMARK_VERSUS_EX("Traverse 100k elements array", 10, c_pSimdName)
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("Iterator")
+			double fSum = 0.0;
+			for (JsonStthm::JsonValue::Iterator it = oArray.begin(); it != oArray.end(); ++it)
+				fSum += (*it).ToFloat();
+			CHECK(fSum == 4999950000.0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+
+		BEGIN_BENCHMARK_VERSUS_CHALLENGER("operator[](int)")
+			double fSum = 0.0;
+			const int iCount = oArray.GetMemberCount();
+			for (int iIndex = 0; iIndex < iCount; ++iIndex)
+				fSum += oArray[iIndex].ToFloat();
+			CHECK(fSum == 4999950000.0)
+		END_BENCHMARK_VERSUS_CHALLENGER()
+	END_BENCHMARK_VERSUS()
+
+	return 0;
+}
@@ -121,3 +121,50 @@ solution "UtilsCollection"
 			flags			{ "Optimize" }
 
 		SetupPrefix()
+
+	project "JsonStthmBenchmark"
+		uuid				"3d1f6a52-7c1e-4b8e-9f0a-5d2c8e41b7a3"
+		kind				"ConsoleApp"
+		targetdir			"../.output/"
+
+		files {
+							"../JsonStthm/**.cpp",
+							"../JsonStthm/**.h",
+							"../Benchmarker/**.cpp",
+							"../Benchmarker/**.h"
+		}
+
+		configuration()
+
+		configuration		"Debug"
+			flags			{ "Symbols" }
+
+		configuration		"Release"
+			flags			{ "Optimize" }
+
+		SetupPrefix()
+
+	-- Same benchmark without SIMD code path, to compare with the scalar parser
+	project "JsonStthmBenchmarkScalar"
+		uuid				"a8e4c0b9-2f57-4d13-8c6e-1b9d7f3a5e20"
+		kind				"ConsoleApp"
+		targetdir			"../.output/"
+
+		defines				{ "STTHM_DISABLE_SIMD" }
+
+		files {
+							"../JsonStthm/**.cpp",
+							"../JsonStthm/**.h",
+							"../Benchmarker/**.cpp",
+							"../Benchmarker/**.h"
+		}
+
+		configuration()
+
+		configuration		"Debug"
+			flags			{ "Symbols" }
+
+		configuration		"Release"
+			flags			{ "Optimize" }
+
+		SetupPrefix()